@@ -35,6 +35,7 @@
 //
 //****************************************************************************
 
+#include <stddef.h>
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
 #include "HAL_I2C.h"
 
@@ -49,6 +50,22 @@ const eUSCI_I2C_MasterConfig i2cConfig =
         EUSCI_B_I2C_NO_AUTO_STOP                // No Autostop
 };
 
+/* Interrupts driving a transaction */
+#define I2C_INTERRUPTS  (UCTXIE0 | UCRXIE0 | UCSTPIE | UCNACKIE)
+
+/* Ring of queued transactions, the one at I2C_QueueHead is on the bus */
+static I2C_Transaction *I2C_Queue[I2C_QUEUE_SIZE];
+static volatile uint8_t I2C_QueueHead = 0;
+static volatile uint8_t I2C_QueueTail = 0;
+
+/* Progress of the transaction on the bus */
+static bool I2C_RegSent;
+static uint8_t I2C_Index;
+static bool I2C_Nack;
+
+/* Slave addressed by I2C_read16() and I2C_write16() */
+static uint8_t I2C_Slave;
+
 void Init_I2C_GPIO()
 {
     /* Select I2C function for I2C_SCL(P6.5) & I2C_SDA(P6.4) */
@@ -81,116 +98,248 @@ void I2C_init(void)
     /* Enable I2C Module to start operations */
     I2C_enableModule(EUSCI_B1_BASE);
 
+    /* Transactions are driven by the eUSCI interrupt */
+    Interrupt_enableInterrupt(INT_EUSCIB1);
+
     return;
 }
 
 
 /***************************************************************************//**
- * @brief  Reads data from the sensor
- * @param  writeByte Address of register to read from
- * @return Register contents
+ * @brief  Puts a transaction on the bus, starting with the register pointer
+ * @param  transaction  Transaction at the head of the queue
+ * @return none
  ******************************************************************************/
 
-int I2C_read16(unsigned char writeByte)
+static void I2C_start(I2C_Transaction *transaction)
 {
-    int val = 0;
-    int valScratch = 0;
+    I2C_RegSent = false;
+    I2C_Index = 0;
+    I2C_Nack = false;
 
-    /* Set master to transmit mode PL */
-    I2C_setMode(EUSCI_B1_BASE,
-        EUSCI_B_I2C_TRANSMIT_MODE);
+    UCB1I2CSA = transaction->slave;
+    UCB1IFG = 0;
+    UCB1IE |= I2C_INTERRUPTS;
 
-    /* Clear any existing interrupt flag PL */
-    I2C_clearInterruptFlag(EUSCI_B1_BASE,
-        EUSCI_B_I2C_TRANSMIT_INTERRUPT0);
+    /* Start in transmit mode, TXIFG0 then asks for the register pointer */
+    UCB1CTLW0 |= UCTR | UCTXSTT;
+}
 
-    /* Wait until ready to write PL */
-    while (I2C_isBusBusy(EUSCI_B1_BASE));
 
-    /* Initiate start and send first character */
-    I2C_masterSendMultiByteStart(EUSCI_B1_BASE, writeByte);
+/***************************************************************************//**
+ * @brief  Queues a transaction, starting it if the bus is free
+ * @param  transaction  Transaction to run, see HAL_I2C.h
+ * @return false if the queue is full
+ ******************************************************************************/
 
-    /* Wait for TX to finish */
-    while(!(I2C_getInterruptStatus(EUSCI_B1_BASE,
-        EUSCI_B_I2C_TRANSMIT_INTERRUPT0)));
+bool I2C_submit(I2C_Transaction *transaction)
+{
+    uint8_t tail;
+    bool idle;
 
-    /* Initiate stop only */
-    I2C_masterSendMultiByteStop(EUSCI_B1_BASE);
+    transaction->status = I2C_PENDING;
 
-    /* Wait for Stop to finish */
-    while(!I2C_getInterruptStatus(EUSCI_B1_BASE,
-        EUSCI_B_I2C_STOP_INTERRUPT));
+    Interrupt_disableInterrupt(INT_EUSCIB1);
 
-    /*
-     * Generate Start condition and set it to receive mode.
-     * This sends out the slave address and continues to read
-     * until you issue a STOP
-     */
-    I2C_masterReceiveStart(EUSCI_B1_BASE);
+    tail = (I2C_QueueTail + 1) % I2C_QUEUE_SIZE;
+    if (tail == I2C_QueueHead)
+    {
+        Interrupt_enableInterrupt(INT_EUSCIB1);
+        return false;
+    }
 
-    /* Wait for RX buffer to fill */
-    while(!(I2C_getInterruptStatus(EUSCI_B1_BASE,
-        EUSCI_B_I2C_RECEIVE_INTERRUPT0)));
+    idle = (I2C_QueueHead == I2C_QueueTail);
+    I2C_Queue[I2C_QueueTail] = transaction;
+    I2C_QueueTail = tail;
 
-    /* Read from I2C RX register */
-    val = I2C_masterReceiveMultiByteNext(EUSCI_B1_BASE);
+    if (idle)
+    {
+        I2C_start(transaction);
+    }
 
-    /* Receive second byte then send STOP condition */
-    valScratch = I2C_masterReceiveMultiByteFinish(EUSCI_B1_BASE);
+    Interrupt_enableInterrupt(INT_EUSCIB1);
+    return true;
+}
 
-    /* Shift val to top MSB */
-    val = (val << 8);
 
-    /* Read from I2C RX Register and write to LSB of val */
-    val |= valScratch;
+/***************************************************************************//**
+ * @brief  Tells if all queued transactions have completed
+ * @param  none
+ * @return true when the queue is empty
+ ******************************************************************************/
 
-    /* Return temperature value */
-    return (int16_t)val;
+bool I2C_isIdle(void)
+{
+    return I2C_QueueHead == I2C_QueueTail;
 }
 
 
 /***************************************************************************//**
- * @brief  Writes data to the sensor
- * @param  pointer  Address of register you want to modify
- * @param  writeByte Data to be written to the specified register
+ * @brief  Sleeps in LPM0 until a queued transaction has completed
+ * @param  transaction  Transaction passed to I2C_submit()
  * @return none
  ******************************************************************************/
 
-void I2C_write16 (unsigned char pointer, unsigned int writeByte)
+void I2C_wait(I2C_Transaction *transaction)
 {
-    /* Set master to transmit mode PL */
-    I2C_setMode(EUSCI_B1_BASE,
-        EUSCI_B_I2C_TRANSMIT_MODE);
+    bool enabled;
+
+    /* The completion interrupt stays pending until after the check */
+    enabled = !Interrupt_disableMaster();
+    while (transaction->status == I2C_PENDING)
+    {
+        PCM_gotoLPM0();
+        Interrupt_enableMaster();
+        Interrupt_disableMaster();
+    }
+    if (enabled)
+    {
+        Interrupt_enableMaster();
+    }
+}
 
-    /* Clear any existing interrupt flag PL */
-    I2C_clearInterruptFlag(EUSCI_B1_BASE,
-        EUSCI_B_I2C_TRANSMIT_INTERRUPT0);
 
-    /* Wait until ready to write PL */
-    while (I2C_isBusBusy(EUSCI_B1_BASE));
+/***************************************************************************//**
+ * @brief  Reads data from the sensor
+ * @param  writeByte Address of register to read from
+ * @return Register contents
+ ******************************************************************************/
 
-    /* Initiate start and send first character */
-    I2C_masterSendMultiByteStart(EUSCI_B1_BASE,
-        pointer);
+int I2C_read16(unsigned char writeByte)
+{
+    uint8_t data[2];
+    I2C_Transaction transaction = {
+        .slave = I2C_Slave,
+        .reg = writeByte,
+        .read = true,
+        .length = 2,
+        .data = data,
+        .status = I2C_PENDING,
+        .callback = NULL,
+        .context = NULL
+    };
+
+    while (!I2C_submit(&transaction));
+    I2C_wait(&transaction);
+
+    /* Return register value, MSB first */
+    return (int16_t)((data[0] << 8) | data[1]);
+}
 
-    /* Send the MSB to SENSOR */
-    I2C_masterSendMultiByteNext(EUSCI_B1_BASE,
-        (unsigned char)(writeByte>>8));
 
-    I2C_masterSendMultiByteFinish(EUSCI_B1_BASE,
-        (unsigned char)(writeByte&0xFF));
+/***************************************************************************//**
+ * @brief  Writes data to the sensor
+ * @param  pointer  Address of register you want to modify
+ * @param  writeByte Data to be written to the specified register
+ * @return none
+ ******************************************************************************/
 
+void I2C_write16 (unsigned char pointer, unsigned int writeByte)
+{
+    uint8_t data[2] = { (uint8_t)(writeByte >> 8), (uint8_t)writeByte };
+    I2C_Transaction transaction = {
+        .slave = I2C_Slave,
+        .reg = pointer,
+        .read = false,
+        .length = 2,
+        .data = data,
+        .status = I2C_PENDING,
+        .callback = NULL,
+        .context = NULL
+    };
+
+    while (!I2C_submit(&transaction));
+    I2C_wait(&transaction);
 }
 
 
 void I2C_setslave(unsigned int slaveAdr)
 {
-    /* Specify slave address for I2C */
-    I2C_setSlaveAddress(EUSCI_B1_BASE,
-        slaveAdr);
-
-    /* Enable and clear the interrupt flag */
-    I2C_clearInterruptFlag(EUSCI_B1_BASE,
-        EUSCI_B_I2C_TRANSMIT_INTERRUPT0 + EUSCI_B_I2C_RECEIVE_INTERRUPT0);
+    /* Specify slave address for I2C_read16() and I2C_write16() */
+    I2C_Slave = slaveAdr;
     return;
 }
+
+
+/***************************************************************************//**
+ * @brief  Runs the transaction at the head of the queue, one byte, repeated
+ *         start or stop condition per interrupt
+ * @param  none
+ * @return none
+ ******************************************************************************/
+
+void EUSCIB1_IRQHandler(void)
+{
+    I2C_Transaction *transaction = I2C_Queue[I2C_QueueHead];
+    uint16_t status = UCB1IFG & UCB1IE;
+
+    if (status & UCNACKIFG)
+    {
+        /* No acknowledge, give up on the transaction */
+        UCB1IFG &= ~UCNACKIFG;
+        UCB1IE &= ~(UCTXIE0 | UCRXIE0);
+        UCB1CTLW0 |= UCTXSTP;
+        I2C_Nack = true;
+    }
+    else if (status & UCTXIFG0)
+    {
+        if (!I2C_RegSent)
+        {
+            UCB1TXBUF = transaction->reg;
+            I2C_RegSent = true;
+        }
+        else if (transaction->read)
+        {
+            /* Repeated start in receive mode once the pointer is out */
+            UCB1IE &= ~UCTXIE0;
+            UCB1CTLW0 &= ~UCTR;
+            UCB1CTLW0 |= UCTXSTT;
+
+            /* A single byte is NACKed as soon as its address is sent */
+            if (transaction->length == 1)
+            {
+                while (UCB1CTLW0 & UCTXSTT);
+                UCB1CTLW0 |= UCTXSTP;
+            }
+        }
+        else if (I2C_Index < transaction->length)
+        {
+            UCB1TXBUF = transaction->data[I2C_Index++];
+        }
+        else
+        {
+            /* Stop after the last byte */
+            UCB1IE &= ~UCTXIE0;
+            UCB1CTLW0 |= UCTXSTP;
+        }
+    }
+    else if (status & UCRXIFG0)
+    {
+        transaction->data[I2C_Index++] = UCB1RXBUF;
+
+        /* Stop while the last byte is received so it gets NACKed */
+        if (I2C_Index == transaction->length - 1)
+        {
+            UCB1CTLW0 |= UCTXSTP;
+        }
+    }
+    else if (status & UCSTPIFG)
+    {
+        /* Transaction over, report it and start the next one */
+        UCB1IFG &= ~UCSTPIFG;
+        UCB1IE &= ~I2C_INTERRUPTS;
+
+        transaction->status = I2C_Nack ? I2C_NACK : I2C_DONE;
+
+        I2C_QueueHead = (I2C_QueueHead + 1) % I2C_QUEUE_SIZE;
+        if (I2C_QueueHead != I2C_QueueTail)
+        {
+            I2C_start(I2C_Queue[I2C_QueueHead]);
+        }
+
+        if (transaction->callback)
+        {
+            transaction->callback(transaction);
+        }
+    }
+}
@@ -39,11 +39,50 @@
 #ifndef __HAL_I2C_H_
 #define __HAL_I2C_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Transactions that can wait for the bus at the same time */
+#define I2C_QUEUE_SIZE  8
+
+/* State of a transaction */
+typedef enum
+{
+    I2C_PENDING,        /* Queued or on the bus */
+    I2C_DONE,           /* Completed */
+    I2C_NACK            /* Slave did not acknowledge, stopped */
+} I2C_Status;
+
+struct I2C_Transaction;
+typedef void (*I2C_Callback)(struct I2C_Transaction *transaction);
+
+/*
+ * Register access on the bus. The register pointer is sent first, then
+ * length bytes are written from data, or read into data after a repeated
+ * start when read is set. status leaves I2C_PENDING once the stop condition
+ * has been sent, and callback, when set, is then called from the interrupt.
+ * The transaction and its data must stay valid until then.
+ */
+typedef struct I2C_Transaction
+{
+    uint8_t slave;
+    uint8_t reg;
+    bool read;
+    uint8_t length;
+    uint8_t *data;
+    volatile I2C_Status status;
+    I2C_Callback callback;
+    void *context;
+} I2C_Transaction;
+
 void Init_I2C_GPIO(void);
 void I2C_init(void);
 int I2C_read16(unsigned char);
 void I2C_write16(unsigned char pointer, unsigned int writeByte);
 void I2C_setslave(unsigned int slaveAdr);
+bool I2C_submit(I2C_Transaction *transaction);
+bool I2C_isIdle(void);
+void I2C_wait(I2C_Transaction *transaction);
 
 
 #endif /* __HAL_I2C_H_ */
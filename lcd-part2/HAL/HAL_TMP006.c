@@ -40,8 +40,16 @@
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
 #include "math.h"
 
-/* Calibration constant for TMP006 */
-static long double S0 = 0;
+/* Model constants of the TMP006 object temperature, single precision so
+ * the FPU of the M4F evaluates it without library calls. */
+#define TMP006_S0       6e-14f          /* Calibration constant */
+#define TMP006_A1       1.75e-3f
+#define TMP006_A2       -1.678e-5f
+#define TMP006_B0       -2.94e-5f
+#define TMP006_B1       -5.7e-7f
+#define TMP006_B2       4.63e-9f
+#define TMP006_C2       13.4f
+#define TMP006_TREF     298.15f         /* Kelvin */
 
 
 /***************************************************************************//**
@@ -89,46 +97,47 @@ int TMP006_readAmbientTemperature(void)
 }
 
 
+/***************************************************************************//**
+ * @brief  Calculates the object temperature from the sensor registers
+ * @param  vobj  Object voltage register
+ * @param  tdie  Ambient temperature register
+ * @return Object temperature in degrees fahrenheit
+ ******************************************************************************/
+float TMP006_calcTemp(int16_t vobj, int16_t tdie)
+{
+    float Vobj = vobj * TMP006_VOBJ_LSB;
+    float Tdie = (tdie >> 2) * TMP006_TDIE_LSB + 273.15f;
+    float dT = Tdie - TMP006_TREF;
+
+    /* Sensitivity, offset voltage and Seebeck coefficients, in Horner form */
+    float S = TMP006_S0 * (1 + dT * (TMP006_A1 + dT * TMP006_A2));
+    float Vos = TMP006_B0 + dT * (TMP006_B1 + dT * TMP006_B2);
+    float Vdiff = Vobj - Vos;
+    float fObj = Vdiff * (1 + TMP006_C2 * Vdiff);
+
+    /* Fourth root as two square roots, each a single VSQRT on the FPU */
+    float Tdie2 = Tdie * Tdie;
+    float Tobj = sqrtf(sqrtf(Tdie2 * Tdie2 + fObj / S));
+
+    return (9.0f / 5.0f) * (Tobj - 273.15f) + 32;
+}
+
 /***************************************************************************//**
  * @brief  Reads data from the sensor and calculates the object temperature
  * @param  none
  * @return Object temperature in degrees fahrenheit
  ******************************************************************************/
-long double TMP006_getTemp(void)
+float TMP006_getTemp(void)
 {
-    volatile int Vobj = 0;
-    volatile int Tdie = 0;
-
-    Vobj = TMP006_readDeviceId();
+    int Vobj;
+    int Tdie;
 
     /* Read the object voltage */
     Vobj = TMP006_readObjectVoltage();
 
     /* Read the ambient temperature */
     Tdie = TMP006_readAmbientTemperature();
-    Tdie = Tdie >> 2;
-
-    /* Calculate TMP006. This needs to be reviewed and calibrated */
-    long double Vobj2 = (double)Vobj*.00000015625;
-    long double Tdie2 = (double)Tdie*.03525 + 273.15;
-
-    /* Initialize constants */
-    S0 = 6 * pow(10, -14);
-    long double a1 = 1.75*pow(10, -3);
-    long double a2 = -1.678*pow(10, -5);
-    long double b0 = -2.94*pow(10, -5);
-    long double b1 = -5.7*pow(10, -7);
-    long double b2 = 4.63*pow(10, -9);
-    long double c2 = 13.4;
-    long double Tref = 298.15;
-
-    /* Calculate values */
-    long double S = S0*(1+a1*(Tdie2 - Tref)+a2*pow((Tdie2 - Tref),2));
-    long double Vos = b0 + b1*(Tdie2 - Tref) + b2*pow((Tdie2 - Tref),2);
-    volatile long double fObj = (Vobj2 - Vos) + c2*pow((Vobj2 - Vos),2);
-    volatile long double Tobj = pow(pow(Tdie2,4) + (fObj/S),.25);
-    Tobj = (9.0/5.0)*(Tobj - 273.15) + 32;
 
     /* Return temperature of object */
-    return (Tobj);
+    return TMP006_calcTemp(Vobj, Tdie);
 }
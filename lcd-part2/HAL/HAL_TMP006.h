@@ -60,11 +60,22 @@
 #define TMP006_EN               0x0100
 #define TMP006_DRDY             0x0080
 
+/* Weight of one LSB of the object voltage (V) and of the die temperature (K),
+ * the die temperature being 14 bits left aligned in its register. The die
+ * weight is the one the calculation has always used, the datasheet gives
+ * 1/32 K: changing it moves every reading and is a calibration change of
+ * its own. */
+#define TMP006_VOBJ_LSB         1.5625e-7f
+#define TMP006_TDIE_LSB         0.03525f
+
 #define I2C_SCL    BIT7;
 #define I2C_SDA    BIT6;
 
+#include <stdint.h>
+
 void TMP006_init(void);
-long double TMP006_getTemp(void);
+float TMP006_getTemp(void);
+float TMP006_calcTemp(int16_t vobj, int16_t tdie);
 int TMP006_readDeviceId(void);
 int TMP006_readObjectVoltage(void);
 int TMP006_readAmbientTemperature(void);
@@ -41,12 +41,91 @@
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
 #include "HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h"
 #include <stdint.h>
+#include <string.h>
 
 uint8_t Lcd_Orientation;
 uint16_t Lcd_ScreenWidth, Lcd_ScreenHeigth;
 uint8_t Lcd_PenSolid, Lcd_FontSolid, Lcd_FlagRead;
 uint16_t Lcd_TouchTrim;
 
+// One display line of pixels in the panel's native (big endian RGB565) order
+static uint8_t Lcd_LineBuffer[LCD_HORIZONTAL_MAX * 2];
+
+// Current write window and the position the next pixel is written to, in
+// screen coordinates
+static int16_t Lcd_WinX0, Lcd_WinX1, Lcd_WinY0, Lcd_WinY1;
+static int16_t Lcd_CurX, Lcd_CurY;
+
+// Set while a RAMWR data stream into the window above is still open on the
+// controller, so a run starting at the cursor can be appended to it
+static uint8_t Lcd_WriteOpen;
+
+// CASET/RASET values last sent to the controller, in controller coordinates
+static uint16_t Lcd_ColStart, Lcd_ColEnd, Lcd_RowStart, Lcd_RowEnd;
+static uint8_t Lcd_AddrValid;
+
+#if LCD_FRAMEBUFFER_ENABLE
+// Shadow copy of the panel, stored in the panel's native byte order so that
+// rows can be streamed to the display without conversion.
+static uint16_t Lcd_FrameBuffer[LCD_VERTICAL_MAX][LCD_HORIZONTAL_MAX];
+
+// Per row span of pixels changed since the last flush. A row is clean when
+// its minimum is greater than its maximum.
+static uint8_t Lcd_DirtyMin[LCD_VERTICAL_MAX];
+static uint8_t Lcd_DirtyMax[LCD_VERTICAL_MAX];
+
+// Spans handed to the transfer queue since it was last idle, marked dirty
+// again if drawing resumes before they are all sent
+static uint8_t Lcd_FlushMin[LCD_VERTICAL_MAX];
+static uint8_t Lcd_FlushMax[LCD_VERTICAL_MAX];
+
+// Windows a flush is made of, top to bottom
+typedef struct
+{
+    uint8_t x0, x1;
+    uint8_t y0, y1;
+} Lcd_FlushWindow;
+
+static Lcd_FlushWindow Lcd_FlushWindows[LCD_VERTICAL_MAX];
+
+// Lcd_FlushCost[i] is the cost of merging window i with window i + 1
+static uint32_t Lcd_FlushCost[LCD_VERTICAL_MAX];
+
+// Progress of the transition started by Crystalfontz128x128_Carousel()
+typedef struct
+{
+    uint8_t frames;             // frames left, zero when none is running
+    uint8_t direction;
+    uint16_t offset;            // rows scrolled so far
+    uint16_t xOffset, yOffset;  // panel position in controller memory
+    uint16_t color;             // separator, in the panel's format
+    uint16_t tick;              // frame timer tick of the last frame
+} Lcd_CarouselState;
+
+static Lcd_CarouselState Lcd_Carousel;
+
+static void Crystalfontz128x128_CarouselFinish(void);
+
+// Converts a RGB565 color to its frame buffer representation
+#define FRAMEBUFFER_COLOR(color) ((uint16_t)(((color) >> 8) | ((color) << 8)))
+#endif
+
+//
+// Pixels are converted to the panel's byte order into a line buffer, which is
+// handed to the HAL as one block so long runs go out through the DMA.
+//
+#define LINE_BUFFER_PUT(color)                                              \
+    do                                                                      \
+    {                                                                       \
+        Lcd_LineBuffer[lBuffered++] = (uint8_t)((color) >> 8);              \
+        Lcd_LineBuffer[lBuffered++] = (uint8_t)(color);                     \
+        if (lBuffered == sizeof(Lcd_LineBuffer))                            \
+        {                                                                   \
+            Crystalfontz128x128_WritePixels(Lcd_LineBuffer, lBuffered / 2); \
+            lBuffered = 0;                                                  \
+        }                                                                   \
+    } while (0)
+
 //*****************************************************************************
 //
 //! Initializes the display driver.
@@ -59,13 +138,14 @@ uint16_t Lcd_TouchTrim;
 //*****************************************************************************
 void Crystalfontz128x128_Init(void)
 {
+    Lcd_AddrValid = 0;
+    Lcd_WriteOpen = 0;
+
     HAL_LCD_PortInit();
     HAL_LCD_SpiInit();
+    HAL_LCD_DmaInit();
 
-    GPIO_setOutputLowOnPin(LCD_RST_PORT, LCD_RST_PIN);
-    HAL_LCD_delay(50);
-    GPIO_setOutputHighOnPin(LCD_RST_PORT, LCD_RST_PIN);
-    HAL_LCD_delay(120);
+    HAL_LCD_reset();
 
     HAL_LCD_writeCommand(CM_SLPOUT);
     HAL_LCD_delay(200);
@@ -99,19 +179,47 @@ void Crystalfontz128x128_Init(void)
 
     Crystalfontz128x128_SetDrawFrame(0, 0, 127, 127);
     HAL_LCD_writeCommand(CM_RAMWR);
-    int i;
-    for (i = 0; i < 16384; i++)
-    {
-        HAL_LCD_writeData(0xFF);
-        HAL_LCD_writeData(0xFF);
-    }
+    HAL_LCD_writeColor(0xFFFF, LCD_VERTICAL_MAX * LCD_HORIZONTAL_MAX);
+
+#if LCD_FRAMEBUFFER_ENABLE
+    memset(Lcd_FrameBuffer, 0xFF, sizeof(Lcd_FrameBuffer));
+    memset(Lcd_DirtyMin, 0xFF, sizeof(Lcd_DirtyMin));
+    memset(Lcd_DirtyMax, 0x00, sizeof(Lcd_DirtyMax));
+#endif
 
     HAL_LCD_delay(10);
     HAL_LCD_writeCommand(CM_DISPON);
 }
 
 
-void Crystalfontz128x128_SetDrawFrame(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+//
+// Sends a command or parameter byte, or appends it to the header of a queued
+// block when block is not null.
+//
+static void Crystalfontz128x128_Emit(HAL_LCD_Block *block, uint8_t value,
+                                     bool command)
+{
+    if (block)
+    {
+        if (command)
+        {
+            block->commandMask |= 1 << block->headerLength;
+        }
+        block->header[block->headerLength++] = value;
+    }
+    else if (command)
+    {
+        HAL_LCD_writeCommand(value);
+    }
+    else
+    {
+        HAL_LCD_writeData(value);
+    }
+}
+
+static void Crystalfontz128x128_FrameHeader(HAL_LCD_Block *block,
+                                            uint16_t x0, uint16_t y0,
+                                            uint16_t x1, uint16_t y1)
 {
     switch (Lcd_Orientation) {
         case 0:
@@ -142,17 +250,49 @@ void Crystalfontz128x128_SetDrawFrame(uint16_t x0, uint16_t y0, uint16_t x1, uin
             break;
     }
 
-    HAL_LCD_writeCommand(CM_CASET);
-    HAL_LCD_writeData((uint8_t)(x0 >> 8));
-    HAL_LCD_writeData((uint8_t)(x0));
-    HAL_LCD_writeData((uint8_t)(x1 >> 8));
-    HAL_LCD_writeData((uint8_t)(x1));
+    if (!LCD_WINDOW_ELISION)
+    {
+        Lcd_AddrValid = 0;
+    }
 
-    HAL_LCD_writeCommand(CM_RASET);
-    HAL_LCD_writeData((uint8_t)(y0 >> 8));
-    HAL_LCD_writeData((uint8_t)(y0));
-    HAL_LCD_writeData((uint8_t)(y1 >> 8));
-    HAL_LCD_writeData((uint8_t)(y1));
+    //
+    // The controller keeps the address window until it is changed, so only
+    // the parts that differ from the last window are sent.
+    //
+    if (!Lcd_AddrValid || (x0 != Lcd_ColStart) || (x1 != Lcd_ColEnd))
+    {
+        Crystalfontz128x128_Emit(block, CM_CASET, true);
+        Crystalfontz128x128_Emit(block, (uint8_t)(x0 >> 8), false);
+        Crystalfontz128x128_Emit(block, (uint8_t)(x0), false);
+        Crystalfontz128x128_Emit(block, (uint8_t)(x1 >> 8), false);
+        Crystalfontz128x128_Emit(block, (uint8_t)(x1), false);
+        Lcd_ColStart = x0;
+        Lcd_ColEnd = x1;
+    }
+
+    if (!Lcd_AddrValid || (y0 != Lcd_RowStart) || (y1 != Lcd_RowEnd))
+    {
+        Crystalfontz128x128_Emit(block, CM_RASET, true);
+        Crystalfontz128x128_Emit(block, (uint8_t)(y0 >> 8), false);
+        Crystalfontz128x128_Emit(block, (uint8_t)(y0), false);
+        Crystalfontz128x128_Emit(block, (uint8_t)(y1 >> 8), false);
+        Crystalfontz128x128_Emit(block, (uint8_t)(y1), false);
+        Lcd_RowStart = y0;
+        Lcd_RowEnd = y1;
+    }
+
+    Lcd_AddrValid = 1;
+
+    //
+    // The caller follows up with a new RAMWR, which ends any open stream.
+    //
+    Lcd_WriteOpen = 0;
+}
+
+
+void Crystalfontz128x128_SetDrawFrame(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    Crystalfontz128x128_FrameHeader(0, x0, y0, x1, y1);
 }
 
 
@@ -173,7 +313,13 @@ void Crystalfontz128x128_SetDrawFrame(uint16_t x0, uint16_t y0, uint16_t x1, uin
 //*****************************************************************************
 void Crystalfontz128x128_SetOrientation(uint8_t orientation)
 {
+#if LCD_FRAMEBUFFER_ENABLE
+    Crystalfontz128x128_CarouselFinish();
+#endif
+
     Lcd_Orientation = orientation;
+    Lcd_AddrValid = 0;
+    Lcd_WriteOpen = 0;
     HAL_LCD_writeCommand(CM_MADCTL);
     switch (Lcd_Orientation) {
         case LCD_ORIENTATION_UP:
@@ -189,8 +335,246 @@ void Crystalfontz128x128_SetOrientation(uint8_t orientation)
             HAL_LCD_writeData(CM_MADCTL_MX | CM_MADCTL_MV | CM_MADCTL_BGR);
             break;
     }
+
+#if LCD_FRAMEBUFFER_ENABLE
+    //
+    // The panel content no longer matches the frame buffer layout.
+    //
+    memset(Lcd_DirtyMin, 0, sizeof(Lcd_DirtyMin));
+    memset(Lcd_DirtyMax, LCD_HORIZONTAL_MAX - 1, sizeof(Lcd_DirtyMax));
+#endif
+}
+
+
+//*****************************************************************************
+//
+// Pixel output path shared by all drawing primitives.
+//
+// Crystalfontz128x128_BeginWrite() opens a window, then pixels are streamed
+// into it left to right, top to bottom, with Crystalfontz128x128_WritePixels()
+// (native order data) or Crystalfontz128x128_WriteColor() (repeated color).
+// Without a frame buffer the window is opened on the controller and the data
+// goes straight to the panel. With a frame buffer the pixels are stored in RAM
+// and only the changed spans are recorded for Crystalfontz128x128_Flush().
+//
+//*****************************************************************************
+#if LCD_FRAMEBUFFER_ENABLE
+
+//
+// Stops a flush that is still being sent so the frame buffer can be changed.
+// Whatever it had not sent yet is marked dirty again.
+//
+static void Crystalfontz128x128_FlushCancel(void)
+{
+    uint16_t y;
+
+    if (!HAL_LCD_abortQueue())
+    {
+        return;
+    }
+
+    for (y = 0; y < LCD_VERTICAL_MAX; y++)
+    {
+        if (Lcd_FlushMin[y] < Lcd_DirtyMin[y])
+        {
+            Lcd_DirtyMin[y] = Lcd_FlushMin[y];
+        }
+        if (Lcd_FlushMax[y] > Lcd_DirtyMax[y])
+        {
+            Lcd_DirtyMax[y] = Lcd_FlushMax[y];
+        }
+    }
+
+    //
+    // The dropped blocks may have carried window commands.
+    //
+    Lcd_AddrValid = 0;
+}
+
+static void Crystalfontz128x128_BeginWrite(int16_t x0, int16_t y0,
+                                           int16_t x1, int16_t y1)
+{
+    Crystalfontz128x128_CarouselFinish();
+
+    if (HAL_LCD_isBusy())
+    {
+        Crystalfontz128x128_FlushCancel();
+    }
+
+    Lcd_WinX0 = x0;
+    Lcd_WinY0 = y0;
+    Lcd_WinX1 = (x1 < LCD_HORIZONTAL_MAX) ? x1 : LCD_HORIZONTAL_MAX - 1;
+    Lcd_WinY1 = (y1 < LCD_VERTICAL_MAX) ? y1 : LCD_VERTICAL_MAX - 1;
+    Lcd_CurX = x0;
+    Lcd_CurY = y0;
+}
+
+//
+// Stores up to the end of the current window row. Returns the number of
+// pixels consumed, zero once the window is full.
+//
+static uint16_t Crystalfontz128x128_StoreRow(const uint8_t *data,
+                                             uint16_t color,
+                                             uint16_t count)
+{
+    uint16_t *pRow;
+    int16_t x, xEnd, changedMin, changedMax;
+    uint16_t value = color;
+    uint16_t stored;
+
+    if (Lcd_CurY > Lcd_WinY1)
+    {
+        return 0;
+    }
+
+    xEnd = Lcd_WinX1;
+    if (count < (uint16_t)(xEnd - Lcd_CurX + 1))
+    {
+        xEnd = Lcd_CurX + count - 1;
+    }
+
+    pRow = Lcd_FrameBuffer[Lcd_CurY];
+    changedMin = LCD_HORIZONTAL_MAX;
+    changedMax = -1;
+    for (x = Lcd_CurX; x <= xEnd; x++)
+    {
+        if (data)
+        {
+            value = (uint16_t)(data[0] | (data[1] << 8));
+            data += 2;
+        }
+        if (pRow[x] != value)
+        {
+            pRow[x] = value;
+            if (x < changedMin)
+            {
+                changedMin = x;
+            }
+            changedMax = x;
+        }
+    }
+
+    if (changedMax >= 0)
+    {
+        if (changedMin < Lcd_DirtyMin[Lcd_CurY])
+        {
+            Lcd_DirtyMin[Lcd_CurY] = changedMin;
+        }
+        if (changedMax > Lcd_DirtyMax[Lcd_CurY])
+        {
+            Lcd_DirtyMax[Lcd_CurY] = changedMax;
+        }
+    }
+
+    stored = xEnd - Lcd_CurX + 1;
+    Lcd_CurX = xEnd + 1;
+    if (Lcd_CurX > Lcd_WinX1)
+    {
+        Lcd_CurX = Lcd_WinX0;
+        Lcd_CurY++;
+    }
+    return stored;
+}
+
+static void Crystalfontz128x128_WritePixels(const uint8_t *data, uint16_t count)
+{
+    uint16_t stored;
+
+    while (count && (stored = Crystalfontz128x128_StoreRow(data, 0, count)))
+    {
+        data += stored * 2;
+        count -= stored;
+    }
+}
+
+static void Crystalfontz128x128_WriteColor(uint16_t color, uint32_t count)
+{
+    uint16_t stored;
+    uint16_t chunk;
+
+    color = FRAMEBUFFER_COLOR(color);
+    while (count)
+    {
+        chunk = (count > LCD_HORIZONTAL_MAX) ? LCD_HORIZONTAL_MAX : count;
+        stored = Crystalfontz128x128_StoreRow(0, color, chunk);
+        if (!stored)
+        {
+            break;
+        }
+        count -= stored;
+    }
+}
+
+#else
+
+static void Crystalfontz128x128_BeginWrite(int16_t x0, int16_t y0,
+                                           int16_t x1, int16_t y1)
+{
+    if (y0 == y1)
+    {
+        //
+        // A run starting where the open RAMWR stream writes next is appended
+        // to it without sending any command.
+        //
+        if (LCD_WINDOW_ELISION && Lcd_WriteOpen && (x0 == Lcd_CurX) &&
+            (y0 == Lcd_CurY) && (x1 <= Lcd_WinX1))
+        {
+            return;
+        }
+
+        //
+        // Open single row windows up to the right edge so the next run on
+        // the same row can be appended, and so runs starting on the same
+        // column of other rows reuse the same CASET.
+        //
+        x1 = LCD_HORIZONTAL_MAX - 1;
+    }
+
+    Crystalfontz128x128_SetDrawFrame(x0, y0, x1, y1);
+    HAL_LCD_writeCommand(CM_RAMWR);
+
+    Lcd_WinX0 = x0;
+    Lcd_WinX1 = x1;
+    Lcd_WinY0 = y0;
+    Lcd_WinY1 = y1;
+    Lcd_CurX = x0;
+    Lcd_CurY = y0;
+    Lcd_WriteOpen = 1;
+}
+
+//
+// Moves the cursor past count pixels written into the open window.
+//
+static void Crystalfontz128x128_Advance(uint32_t count)
+{
+    uint32_t width = Lcd_WinX1 - Lcd_WinX0 + 1;
+    uint32_t offset = (Lcd_CurX - Lcd_WinX0) + count;
+
+    Lcd_CurX = Lcd_WinX0 + (offset % width);
+    Lcd_CurY += offset / width;
+    if (Lcd_CurY > Lcd_WinY1)
+    {
+        //
+        // The controller wrapped around, do not try to append to it.
+        //
+        Lcd_WriteOpen = 0;
+    }
+}
+
+static void Crystalfontz128x128_WritePixels(const uint8_t *data, uint16_t count)
+{
+    HAL_LCD_writeDataBlock(data, (uint32_t)count * 2);
+    Crystalfontz128x128_Advance(count);
 }
 
+static void Crystalfontz128x128_WriteColor(uint16_t color, uint32_t count)
+{
+    HAL_LCD_writeColor(color, count);
+    Crystalfontz128x128_Advance(count);
+}
+
+#endif
+
 
 //*****************************************************************************
 //
@@ -214,14 +598,12 @@ static void Crystalfontz128x128_PixelDraw(const Graphics_Display *pDisplay,
                                           uint16_t ulValue)
 {
 
-    Crystalfontz128x128_SetDrawFrame(lX,lY,lX,lY);
+    Crystalfontz128x128_BeginWrite(lX,lY,lX,lY);
 
     //
     // Write the pixel value.
     //
-    HAL_LCD_writeCommand(CM_RAMWR);
-    HAL_LCD_writeData(ulValue>>8);
-    HAL_LCD_writeData(ulValue);
+    Crystalfontz128x128_WriteColor(ulValue, 1);
 }
 
 
@@ -260,12 +642,12 @@ static void Crystalfontz128x128_PixelDrawMultiple(const Graphics_Display *pDispl
                                                   const uint32_t *pucPalette)
 {
     uint16_t Data;
+    uint16_t lBuffered = 0;
 
     //
     // Set the cursor increment to left to right, followed by top to bottom.
     //
-    Crystalfontz128x128_SetDrawFrame(lX,lY,lX+lCount,127);
-    HAL_LCD_writeCommand(CM_RAMWR);
+    Crystalfontz128x128_BeginWrite(lX,lY,lX+lCount,127);
 
     //
     // Determine how to interpret the pixel data based on the number of bits
@@ -286,9 +668,7 @@ static void Crystalfontz128x128_PixelDrawMultiple(const Graphics_Display *pDispl
                 for(; (lX0 < 8) && lCount; lX0++, lCount--)
                 {
                     // Draw this pixel in the appropriate color
-                    HAL_LCD_writeData((((uint32_t *)pucPalette)[(Data >>
-                                                             (7 - lX0)) & 1])>>8);
-                    HAL_LCD_writeData(((uint32_t *)pucPalette)[(Data >>
+                    LINE_BUFFER_PUT(((uint32_t *)pucPalette)[(Data >>
                                                              (7 - lX0)) & 1]);
                 }
 
@@ -321,8 +701,7 @@ static void Crystalfontz128x128_PixelDrawMultiple(const Graphics_Display *pDispl
                         Data = (*pucData >> 4);
                         Data = (*(uint16_t *)(pucPalette + Data));
                         // Write to LCD screen
-                        HAL_LCD_writeData(Data>>8);
-                        HAL_LCD_writeData(Data);
+                        LINE_BUFFER_PUT(Data);
 
                         // Decrement the count of pixels to draw
                         lCount--;
@@ -337,8 +716,7 @@ static void Crystalfontz128x128_PixelDrawMultiple(const Graphics_Display *pDispl
                             Data = (*pucData++ & 15);
                             Data = (*(uint16_t *)(pucPalette + Data));
                             // Write to LCD screen
-                            HAL_LCD_writeData(Data>>8);
-                            HAL_LCD_writeData(Data);
+                            LINE_BUFFER_PUT(Data);
 
                             // Decrement the count of pixels to draw
                             lCount--;
@@ -361,8 +739,7 @@ static void Crystalfontz128x128_PixelDrawMultiple(const Graphics_Display *pDispl
                 Data = *pucData++;
                 Data = (*(uint16_t *)(pucPalette + Data));
                 // Write to LCD screen
-                HAL_LCD_writeData(Data>>8);
-                HAL_LCD_writeData(Data);
+                LINE_BUFFER_PUT(Data);
             }
             // The image data has been drawn
             break;
@@ -388,11 +765,15 @@ static void Crystalfontz128x128_PixelDrawMultiple(const Graphics_Display *pDispl
                 pucData += 2;
 
                 // Translate this palette entry and write it to the screen
-                HAL_LCD_writeData(usData>>8);
-                HAL_LCD_writeData(usData);
+                LINE_BUFFER_PUT(usData);
             }
         }
     }
+
+    //
+    // Send whatever is left in the line buffer.
+    //
+    Crystalfontz128x128_WritePixels(Lcd_LineBuffer, lBuffered / 2);
 }
 
 
@@ -421,18 +802,12 @@ static void Crystalfontz128x128_LineDrawH(const Graphics_Display *pDisplay,
 {
 
 
-    Crystalfontz128x128_SetDrawFrame(lX1, lY, lX2, lY);
+    Crystalfontz128x128_BeginWrite(lX1, lY, lX2, lY);
 
     //
     // Write the pixel value.
     //
-    int16_t i;
-    HAL_LCD_writeCommand(CM_RAMWR);
-    for (i = lX1; i <= lX2; i++)
-    {
-        HAL_LCD_writeData(ulValue>>8);
-        HAL_LCD_writeData(ulValue);
-    }
+    Crystalfontz128x128_WriteColor(ulValue, lX2 - lX1 + 1);
 }
 
 
@@ -459,18 +834,12 @@ static void Crystalfontz128x128_LineDrawV(const Graphics_Display *pDisplay,
                                           int16_t lY2,
                                           uint16_t ulValue)
 {
-    Crystalfontz128x128_SetDrawFrame(lX, lY1, lX, lY2);
+    Crystalfontz128x128_BeginWrite(lX, lY1, lX, lY2);
 
     //
     // Write the pixel value.
     //
-    int16_t i;
-    HAL_LCD_writeCommand(CM_RAMWR);
-    for (i = lY1; i <= lY2; i++)
-    {
-        HAL_LCD_writeData(ulValue>>8);
-        HAL_LCD_writeData(ulValue);
-    }
+    Crystalfontz128x128_WriteColor(ulValue, lY2 - lY1 + 1);
 }
 
 
@@ -500,19 +869,13 @@ static void Crystalfontz128x128_RectFill(const Graphics_Display *pDisplay,
     int16_t y0 = pRect->sYMin;
     int16_t y1 = pRect->sYMax;
 
-    Crystalfontz128x128_SetDrawFrame(x0, y0, x1, y1);
+    Crystalfontz128x128_BeginWrite(x0, y0, x1, y1);
 
     //
     // Write the pixel value.
     //
-    int16_t i;
-    int16_t pixels = (x1 - x0 + 1) * (y1 - y0 + 1);
-    HAL_LCD_writeCommand(CM_RAMWR);
-    for (i = 0; i <= pixels; i++)
-    {
-        HAL_LCD_writeData(ulValue>>8);
-        HAL_LCD_writeData(ulValue);
-    }
+    uint32_t pixels = (uint32_t)(x1 - x0 + 1) * (y1 - y0 + 1);
+    Crystalfontz128x128_WriteColor(ulValue, pixels);
 }
 
 //*****************************************************************************
@@ -544,75 +907,940 @@ static uint32_t Crystalfontz128x128_ColorTranslate(const Graphics_Display *pDisp
 }
 
 
-//*****************************************************************************
+#if LCD_FRAMEBUFFER_ENABLE
 //
-//! Flushes any cached drawing operations.
-//!
-//! \param pDisplay is a pointer to the driver-specific data for this
-//! display driver.
-//!
-//! This functions flushes any cached drawing operations to the display.  This
-//! is useful when a local frame buffer is used for drawing operations, and the
-//! flush would copy the local frame buffer to the display.  For the SSD2119
-//! driver, the flush is a no operation.
-//!
-//! \return None.
+// Pixels sent in addition to the two windows when they are merged into the
+// rectangle around them. Unchanged pixels are sent again from the frame
+// buffer, which is harmless.
 //
-//*****************************************************************************
-static void
-Crystalfontz128x128_Flush(const Graphics_Display *pDisplay)
+static uint32_t Crystalfontz128x128_MergeCost(const Lcd_FlushWindow *upper,
+                                              const Lcd_FlushWindow *lower)
 {
-    //
-    // There is nothing to be done.
-    //
+    uint8_t x0 = (lower->x0 < upper->x0) ? lower->x0 : upper->x0;
+    uint8_t x1 = (lower->x1 > upper->x1) ? lower->x1 : upper->x1;
+
+    return (uint32_t)(x1 - x0 + 1) * (lower->y1 - upper->y0 + 1) -
+           (uint32_t)(upper->x1 - upper->x0 + 1) * (upper->y1 - upper->y0 + 1) -
+           (uint32_t)(lower->x1 - lower->x0 + 1) * (lower->y1 - lower->y0 + 1);
 }
+#endif
 
 
 //*****************************************************************************
 //
-//! Send command to clear screen.
+//! Flushes any cached drawing operations.
 //!
 //! \param pDisplay is a pointer to the driver-specific data for this
 //! display driver.
 //!
-//! This function does a clear screen and the Display Buffer contents
-//! are initialized to the current background color.
+//! This functions flushes any cached drawing operations to the display.  This
+//! is useful when a local frame buffer is used for drawing operations, and the
+//! flush would copy the local frame buffer to the display.  With
+//! LCD_FRAMEBUFFER_ENABLE only the dirty span of each row is sent, consecutive
+//! rows sharing the same span are sent through a single window.  Neighbouring
+//! windows are merged into the rectangle around them when that is cheaper
+//! than one more window, and until they all fit in the free room of the HAL
+//! transfer queue, so queuing them never waits for the DMA.  The windows are
+//! sent by the DMA interrupt and the function returns right away.  Drawing
+//! again before they are all sent cancels the rest and marks it dirty again.  Without a frame buffer the
+//! flush is a no operation.
 //!
 //! \return None.
 //
 //*****************************************************************************
 static void
-Crystalfontz128x128_ClearScreen (const Graphics_Display *pDisplay,
-                                 uint16_t ulValue)
+Crystalfontz128x128_Flush(const Graphics_Display *pDisplay)
 {
-    Graphics_Rectangle rect = { 0, 0, LCD_VERTICAL_MAX-1, LCD_VERTICAL_MAX-1};
-    Crystalfontz128x128_RectFill(pDisplay, &rect, ulValue);
-}
+#if LCD_FRAMEBUFFER_ENABLE
+    HAL_LCD_Block block;
+    Lcd_FlushWindow *window;
+    uint16_t count, budget, best, i;
+    int16_t y;
 
+    Crystalfontz128x128_CarouselFinish();
 
-//*****************************************************************************
-//
-//! The display structure that describes the driver for the Kitronix
-//! K350QVG-V1-F TFT panel with an SSD2119 controller.
-//
-//*****************************************************************************
-Graphics_Display g_sCrystalfontz128x128 =
-{
-    sizeof(Graphics_Display),
-    0,
-    LCD_VERTICAL_MAX,
-    LCD_HORIZONTAL_MAX,
-};
+    if (!HAL_LCD_isBusy())
+    {
+        memset(Lcd_FlushMin, 0xFF, sizeof(Lcd_FlushMin));
+        memset(Lcd_FlushMax, 0x00, sizeof(Lcd_FlushMax));
+    }
 
-const Graphics_Display_Functions g_sCrystalfontz128x128_funcs =
-{
-    Crystalfontz128x128_PixelDraw,
-    Crystalfontz128x128_PixelDrawMultiple,
-    Crystalfontz128x128_LineDrawH,
-    Crystalfontz128x128_LineDrawV,
-    Crystalfontz128x128_RectFill,
-    Crystalfontz128x128_ColorTranslate,
-    Crystalfontz128x128_Flush,
-    Crystalfontz128x128_ClearScreen
+    //
+    // One window per run of rows with the same dirty span.
+    //
+    count = 0;
+    for (y = 0; y < LCD_VERTICAL_MAX; y++)
+    {
+        if (Lcd_DirtyMin[y] > Lcd_DirtyMax[y])
+        {
+            continue;
+        }
 
-};
+        if (count)
+        {
+            window = &Lcd_FlushWindows[count - 1];
+            if ((window->y1 == y - 1) && (window->x0 == Lcd_DirtyMin[y]) &&
+                (window->x1 == Lcd_DirtyMax[y]))
+            {
+                window->y1 = y;
+                continue;
+            }
+        }
+
+        window = &Lcd_FlushWindows[count++];
+        window->x0 = Lcd_DirtyMin[y];
+        window->x1 = Lcd_DirtyMax[y];
+        window->y0 = y;
+        window->y1 = y;
+    }
+
+    //
+    // Merge neighbouring windows while it sends fewer pixels than a window
+    // header costs, and until they fit in the transfer queue so that queuing
+    // them never waits for the DMA.
+    //
+    budget = HAL_LCD_queueFree();
+    if (budget == 0)
+    {
+        budget = 1;
+    }
+    for (i = 0; i + 1 < count; i++)
+    {
+        Lcd_FlushCost[i] = Crystalfontz128x128_MergeCost(&Lcd_FlushWindows[i],
+                                                         &Lcd_FlushWindows[i + 1]);
+    }
+    while (count > 1)
+    {
+        best = 0;
+        for (i = 1; i + 1 < count; i++)
+        {
+            if (Lcd_FlushCost[i] < Lcd_FlushCost[best])
+            {
+                best = i;
+            }
+        }
+
+        if ((count <= budget) && (Lcd_FlushCost[best] > LCD_FLUSH_WINDOW_COST))
+        {
+            break;
+        }
+
+        window = &Lcd_FlushWindows[best];
+        if (window[1].x0 < window->x0)
+        {
+            window->x0 = window[1].x0;
+        }
+        if (window[1].x1 > window->x1)
+        {
+            window->x1 = window[1].x1;
+        }
+        window->y1 = window[1].y1;
+        count--;
+        memmove(&window[1], &window[2],
+                (count - best - 1) * sizeof(Lcd_FlushWindow));
+        memmove(&Lcd_FlushCost[best], &Lcd_FlushCost[best + 1],
+                (count - best - 1) * sizeof(uint32_t));
+
+        //
+        // Only the costs involving the merged window change.
+        //
+        if (best > 0)
+        {
+            Lcd_FlushCost[best - 1] =
+                Crystalfontz128x128_MergeCost(&window[-1], window);
+        }
+        if (best + 1 < count)
+        {
+            Lcd_FlushCost[best] =
+                Crystalfontz128x128_MergeCost(window, &window[1]);
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        window = &Lcd_FlushWindows[i];
+
+        block.headerLength = 0;
+        block.commandMask = 0;
+        Crystalfontz128x128_FrameHeader(&block, window->x0, window->y0,
+                                        window->x1, window->y1);
+        Crystalfontz128x128_Emit(&block, CM_RAMWR, true);
+
+        block.data = (const uint8_t *)&Lcd_FrameBuffer[window->y0][window->x0];
+        block.stride = LCD_HORIZONTAL_MAX * 2;
+        if ((window->x0 == 0) && (window->x1 == LCD_HORIZONTAL_MAX - 1))
+        {
+            //
+            // Full width rows are contiguous in the frame buffer.
+            //
+            block.length = (uint32_t)(window->y1 - window->y0 + 1) *
+                           LCD_HORIZONTAL_MAX * 2;
+            block.rows = 1;
+        }
+        else
+        {
+            block.length = (uint32_t)(window->x1 - window->x0 + 1) * 2;
+            block.rows = window->y1 - window->y0 + 1;
+        }
+        HAL_LCD_queueBlock(&block);
+
+        for (y = window->y0; y <= window->y1; y++)
+        {
+            if (window->x0 < Lcd_FlushMin[y])
+            {
+                Lcd_FlushMin[y] = window->x0;
+            }
+            if (window->x1 > Lcd_FlushMax[y])
+            {
+                Lcd_FlushMax[y] = window->x1;
+            }
+        }
+    }
+
+    memset(Lcd_DirtyMin, 0xFF, sizeof(Lcd_DirtyMin));
+    memset(Lcd_DirtyMax, 0x00, sizeof(Lcd_DirtyMax));
+#endif
+}
+
+
+#if LCD_FRAMEBUFFER_ENABLE
+//
+// Writes count controller memory lines starting at line, straight from the
+// frame buffer, or in color for lines outside of it.
+//
+static void Crystalfontz128x128_CarouselRows(uint16_t line, uint16_t count,
+                                             uint16_t xOffset,
+                                             uint16_t yOffset,
+                                             uint16_t color)
+{
+    uint16_t x1 = xOffset + LCD_HORIZONTAL_MAX - 1;
+    uint16_t y1 = line + count - 1;
+    int16_t row;
+
+    HAL_LCD_writeCommand(CM_CASET);
+    HAL_LCD_writeData((uint8_t)(xOffset >> 8));
+    HAL_LCD_writeData((uint8_t)(xOffset));
+    HAL_LCD_writeData((uint8_t)(x1 >> 8));
+    HAL_LCD_writeData((uint8_t)(x1));
+
+    HAL_LCD_writeCommand(CM_RASET);
+    HAL_LCD_writeData((uint8_t)(line >> 8));
+    HAL_LCD_writeData((uint8_t)(line));
+    HAL_LCD_writeData((uint8_t)(y1 >> 8));
+    HAL_LCD_writeData((uint8_t)(y1));
+
+    HAL_LCD_writeCommand(CM_RAMWR);
+    for (; line <= y1; line++)
+    {
+        row = (line + LCD_MEMORY_LINES - yOffset) % LCD_MEMORY_LINES;
+        if (row < LCD_VERTICAL_MAX)
+        {
+            HAL_LCD_writeDataBlock((const uint8_t *)Lcd_FrameBuffer[row],
+                                   LCD_HORIZONTAL_MAX * 2);
+        }
+        else
+        {
+            HAL_LCD_writeColor(color, LCD_HORIZONTAL_MAX);
+        }
+    }
+}
+
+//
+// Writes the lines about to scroll into view and moves the scroll start
+// address by one step.  The last frame leaves the scroll mode.
+//
+static void Crystalfontz128x128_CarouselFrame(void)
+{
+    Lcd_CarouselState *carousel = &Lcd_Carousel;
+    uint16_t line, count, start;
+
+    //
+    // Fill the hidden lines, which start right below the visible ones.
+    //
+    line = (carousel->yOffset + carousel->offset + LCD_VERTICAL_MAX) %
+           LCD_MEMORY_LINES;
+    count = LCD_CAROUSEL_STEP;
+    if (line + count > LCD_MEMORY_LINES)
+    {
+        Crystalfontz128x128_CarouselRows(line, LCD_MEMORY_LINES - line,
+                                         carousel->xOffset, carousel->yOffset,
+                                         carousel->color);
+        count -= LCD_MEMORY_LINES - line;
+        line = 0;
+    }
+    Crystalfontz128x128_CarouselRows(line, count, carousel->xOffset,
+                                     carousel->yOffset, carousel->color);
+
+    if (carousel->direction == LCD_CAROUSEL_NEXT)
+    {
+        carousel->offset = (carousel->offset + LCD_CAROUSEL_STEP) %
+                           LCD_MEMORY_LINES;
+    }
+    else
+    {
+        carousel->offset = (carousel->offset + LCD_MEMORY_LINES -
+                            LCD_CAROUSEL_STEP) % LCD_MEMORY_LINES;
+    }
+
+    //
+    // The scroll start address counts physical lines, which run opposite
+    // to the rows when the row order is mirrored.
+    //
+    start = carousel->offset;
+    if (Lcd_Orientation == LCD_ORIENTATION_UP)
+    {
+        start = (LCD_MEMORY_LINES - carousel->offset) % LCD_MEMORY_LINES;
+    }
+    HAL_LCD_writeCommand(CM_VSCSAD);
+    HAL_LCD_writeData((uint8_t)(start >> 8));
+    HAL_LCD_writeData((uint8_t)(start));
+
+    if (--carousel->frames == 0)
+    {
+        //
+        // Back at a zero offset, leave the scroll mode.
+        //
+        HAL_LCD_frameStop();
+        HAL_LCD_writeCommand(CM_NORON);
+
+        Lcd_AddrValid = 0;
+        memset(Lcd_DirtyMin, 0xFF, sizeof(Lcd_DirtyMin));
+        memset(Lcd_DirtyMax, 0x00, sizeof(Lcd_DirtyMax));
+    }
+}
+
+//
+// Draws the frames left of a running transition without waiting, so the
+// frame buffer and the panel can be used again.
+//
+static void Crystalfontz128x128_CarouselFinish(void)
+{
+    while (Lcd_Carousel.frames)
+    {
+        Crystalfontz128x128_CarouselFrame();
+    }
+}
+#endif
+
+
+//*****************************************************************************
+//
+//! Starts bringing the frame buffer on screen with a vertical scroll.
+//!
+//! \param direction is \b LCD_CAROUSEL_NEXT to push the current screen up and
+//! bring the new one in from the bottom, or \b LCD_CAROUSEL_PREVIOUS to push it
+//! down and bring the new one in from the top.
+//! \param separatorColor is the 24-bit RGB color of the band shown between the
+//! two screens.
+//!
+//! Used instead of Graphics_flushBuffer() once the new screen has been drawn.
+//! The controller's scroll area is set to all of its memory and the scroll
+//! start address is moved LCD_CAROUSEL_STEP lines per frame.  Before each
+//! step, the lines that are about to scroll into view (the ones the panel
+//! does not show) are written with their final content, so after a full
+//! turn every memory line has been written once and the scroll start address
+//! is back at zero.  Each frame costs the new lines plus a few register
+//! writes.
+//!
+//! The first frame is drawn right away and the function returns.  The HAL
+//! frame timer ticks every LCD_CAROUSEL_FRAME_DELAY microseconds and wakes
+//! the CPU, which then draws the next frame with
+//! Crystalfontz128x128_CarouselStep().  Drawing, flushing or changing the
+//! orientation before the transition is over draws the frames left at once.
+//!
+//! Vertical scrolling follows the panel's scan direction, so only the
+//! LCD_ORIENTATION_UP and LCD_ORIENTATION_DOWN orientations animate.  In the
+//! other orientations, or without LCD_FRAMEBUFFER_ENABLE, this is the same as
+//! a flush.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_Carousel(uint8_t direction, uint32_t separatorColor)
+{
+#if LCD_FRAMEBUFFER_ENABLE
+    Lcd_CarouselState *carousel = &Lcd_Carousel;
+
+    Crystalfontz128x128_CarouselFinish();
+
+    switch (Lcd_Orientation)
+    {
+        case LCD_ORIENTATION_UP:
+            carousel->xOffset = 2;
+            carousel->yOffset = 3;
+            break;
+        case LCD_ORIENTATION_DOWN:
+            carousel->xOffset = 2;
+            carousel->yOffset = 1;
+            break;
+        default:
+            Crystalfontz128x128_Flush(&g_sCrystalfontz128x128);
+            return;
+    }
+
+    carousel->color = Crystalfontz128x128_ColorTranslate(&g_sCrystalfontz128x128,
+                                                         separatorColor);
+    carousel->direction = direction;
+    carousel->offset = 0;
+    carousel->frames = LCD_MEMORY_LINES / LCD_CAROUSEL_STEP;
+
+    //
+    // The whole memory is one scroll area.
+    //
+    HAL_LCD_writeCommand(CM_VSCRDEF);
+    HAL_LCD_writeData(0);
+    HAL_LCD_writeData(0);
+    HAL_LCD_writeData((uint8_t)(LCD_MEMORY_LINES >> 8));
+    HAL_LCD_writeData((uint8_t)(LCD_MEMORY_LINES));
+    HAL_LCD_writeData(0);
+    HAL_LCD_writeData(0);
+
+    //
+    // The frame timer counts from zero.
+    //
+    HAL_LCD_frameStart(LCD_CAROUSEL_FRAME_DELAY);
+    carousel->tick = 0;
+    Crystalfontz128x128_CarouselFrame();
+#else
+    Crystalfontz128x128_Flush(&g_sCrystalfontz128x128);
+#endif
+}
+
+
+//*****************************************************************************
+//
+//! Tells whether a frame of the transition is due.
+//!
+//! The main loop checks it before going to sleep, with interrupts masked, so
+//! a frame timer tick that came in meanwhile is not slept through.
+//!
+//! \return true when Crystalfontz128x128_CarouselStep() has a frame to draw.
+//
+//*****************************************************************************
+bool Crystalfontz128x128_CarouselDue(void)
+{
+#if LCD_FRAMEBUFFER_ENABLE
+    return Lcd_Carousel.frames && (HAL_LCD_frameTicks() != Lcd_Carousel.tick);
+#else
+    return false;
+#endif
+}
+
+
+//*****************************************************************************
+//
+//! Draws the next frame of the transition if the frame timer ticked since the
+//! previous one.
+//!
+//! Called each time the CPU wakes up.  Ticks missed while the CPU was busy are
+//! dropped rather than drawn back to back, so the transition only slows down.
+//!
+//! \return true while the transition is running.
+//
+//*****************************************************************************
+bool Crystalfontz128x128_CarouselStep(void)
+{
+#if LCD_FRAMEBUFFER_ENABLE
+    uint16_t tick;
+
+    if (Lcd_Carousel.frames)
+    {
+        tick = HAL_LCD_frameTicks();
+        if (tick != Lcd_Carousel.tick)
+        {
+            Lcd_Carousel.tick = tick;
+            Crystalfontz128x128_CarouselFrame();
+        }
+    }
+
+    return (Lcd_Carousel.frames != 0);
+#else
+    return false;
+#endif
+}
+
+
+//*****************************************************************************
+//
+//! Send command to clear screen.
+//!
+//! \param pDisplay is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! This function does a clear screen and the Display Buffer contents
+//! are initialized to the current background color.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+Crystalfontz128x128_ClearScreen (const Graphics_Display *pDisplay,
+                                 uint16_t ulValue)
+{
+    Graphics_Rectangle rect = { 0, 0, LCD_VERTICAL_MAX-1, LCD_VERTICAL_MAX-1};
+    Crystalfontz128x128_RectFill(pDisplay, &rect, ulValue);
+}
+
+
+//*****************************************************************************
+//
+//! The display structure that describes the driver for the Kitronix
+//! K350QVG-V1-F TFT panel with an SSD2119 controller.
+//
+//*****************************************************************************
+Graphics_Display g_sCrystalfontz128x128 =
+{
+    sizeof(Graphics_Display),
+    0,
+    LCD_VERTICAL_MAX,
+    LCD_HORIZONTAL_MAX,
+};
+
+const Graphics_Display_Functions g_sCrystalfontz128x128_funcs =
+{
+    Crystalfontz128x128_PixelDraw,
+    Crystalfontz128x128_PixelDrawMultiple,
+    Crystalfontz128x128_LineDrawH,
+    Crystalfontz128x128_LineDrawV,
+    Crystalfontz128x128_RectFill,
+    Crystalfontz128x128_ColorTranslate,
+    Crystalfontz128x128_Flush,
+    Crystalfontz128x128_ClearScreen
+
+};
+
+
+//*****************************************************************************
+//
+// Glyph cache for g_sFontFixed6x8.
+//
+// Every printable character is rendered once through the graphics library
+// into Lcd_GlyphCache, in the panel's native byte order, for the colors of
+// the context that draws it.  A string is then written as a single window
+// with one RAMWR, a row of the string at a time, instead of a callback per
+// glyph run.  The cache is rendered again only when the colors change.
+//
+//*****************************************************************************
+static uint8_t Lcd_GlyphCache[LCD_GLYPH_LAST - LCD_GLYPH_FIRST + 1]
+                             [LCD_GLYPH_HEIGHT][LCD_GLYPH_WIDTH * 2];
+
+// Colors the cache was rendered with, only valid when Lcd_GlyphValid is set
+static uint16_t Lcd_GlyphForeground, Lcd_GlyphBackground;
+static uint8_t Lcd_GlyphValid;
+
+// Glyph cell the capture display below is currently rendering into
+static uint8_t (*Lcd_GlyphTarget)[LCD_GLYPH_WIDTH * 2];
+
+//
+// Stores a pixel into the glyph cell being rendered.
+//
+static void Crystalfontz128x128_GlyphPut(int16_t lX, int16_t lY,
+                                         uint16_t ulValue)
+{
+    if ((lX >= 0) && (lX < LCD_GLYPH_WIDTH) &&
+        (lY >= 0) && (lY < LCD_GLYPH_HEIGHT))
+    {
+        Lcd_GlyphTarget[lY][lX * 2] = (uint8_t)(ulValue >> 8);
+        Lcd_GlyphTarget[lY][lX * 2 + 1] = (uint8_t)ulValue;
+    }
+}
+
+static void Crystalfontz128x128_GlyphPixelDraw(const Graphics_Display *pDisplay,
+                                               int16_t lX,
+                                               int16_t lY,
+                                               uint16_t ulValue)
+{
+    Crystalfontz128x128_GlyphPut(lX, lY, ulValue);
+}
+
+static void Crystalfontz128x128_GlyphPixelDrawMultiple(const Graphics_Display *pDisplay,
+                                                       int16_t lX,
+                                                       int16_t lY,
+                                                       int16_t lX0,
+                                                       int16_t lCount,
+                                                       int16_t lBPP,
+                                                       const uint8_t *pucData,
+                                                       const uint32_t *pucPalette)
+{
+    //
+    // Fonts are only ever drawn with 1 bit per pixel and a pre-translated
+    // palette.
+    //
+    if (lBPP != 1)
+    {
+        return;
+    }
+
+    while (lCount > 0)
+    {
+        for (; (lX0 < 8) && lCount; lX0++, lCount--)
+        {
+            Crystalfontz128x128_GlyphPut(lX++, lY,
+                                         pucPalette[(*pucData >> (7 - lX0)) & 1]);
+        }
+        pucData++;
+        lX0 = 0;
+    }
+}
+
+static void Crystalfontz128x128_GlyphLineDrawH(const Graphics_Display *pDisplay,
+                                               int16_t lX1,
+                                               int16_t lX2,
+                                               int16_t lY,
+                                               uint16_t ulValue)
+{
+    for (; lX1 <= lX2; lX1++)
+    {
+        Crystalfontz128x128_GlyphPut(lX1, lY, ulValue);
+    }
+}
+
+static void Crystalfontz128x128_GlyphLineDrawV(const Graphics_Display *pDisplay,
+                                               int16_t lX,
+                                               int16_t lY1,
+                                               int16_t lY2,
+                                               uint16_t ulValue)
+{
+    for (; lY1 <= lY2; lY1++)
+    {
+        Crystalfontz128x128_GlyphPut(lX, lY1, ulValue);
+    }
+}
+
+static void Crystalfontz128x128_GlyphRectFill(const Graphics_Display *pDisplay,
+                                              const Graphics_Rectangle *pRect,
+                                              uint16_t ulValue)
+{
+    int16_t y;
+
+    for (y = pRect->sYMin; y <= pRect->sYMax; y++)
+    {
+        Crystalfontz128x128_GlyphLineDrawH(pDisplay, pRect->sXMin,
+                                           pRect->sXMax, y, ulValue);
+    }
+}
+
+static void Crystalfontz128x128_GlyphFlush(const Graphics_Display *pDisplay)
+{
+}
+
+static void Crystalfontz128x128_GlyphClear(const Graphics_Display *pDisplay,
+                                           uint16_t ulValue)
+{
+    Graphics_Rectangle rect = { 0, 0, LCD_GLYPH_WIDTH - 1, LCD_GLYPH_HEIGHT - 1 };
+    Crystalfontz128x128_GlyphRectFill(pDisplay, &rect, ulValue);
+}
+
+//
+// A display the size of one glyph cell, used to capture what the graphics
+// library draws for each character.
+//
+static Graphics_Display Lcd_GlyphDisplay =
+{
+    sizeof(Graphics_Display),
+    0,
+    LCD_GLYPH_WIDTH,
+    LCD_GLYPH_HEIGHT,
+};
+
+static const Graphics_Display_Functions Lcd_GlyphDisplayFuncs =
+{
+    Crystalfontz128x128_GlyphPixelDraw,
+    Crystalfontz128x128_GlyphPixelDrawMultiple,
+    Crystalfontz128x128_GlyphLineDrawH,
+    Crystalfontz128x128_GlyphLineDrawV,
+    Crystalfontz128x128_GlyphRectFill,
+    Crystalfontz128x128_ColorTranslate,
+    Crystalfontz128x128_GlyphFlush,
+    Crystalfontz128x128_GlyphClear
+};
+
+//
+// Renders every cached character with the given (already translated)
+// colors.
+//
+static void Crystalfontz128x128_GlyphRender(uint16_t foreground,
+                                            uint16_t background)
+{
+    Graphics_Context context;
+    Graphics_Rectangle cell = { 0, 0, LCD_GLYPH_WIDTH - 1, LCD_GLYPH_HEIGHT - 1 };
+    int8_t c;
+
+    Graphics_initContext(&context, &Lcd_GlyphDisplay, &Lcd_GlyphDisplayFuncs);
+    Graphics_setForegroundColorTranslated(&context, foreground);
+    Graphics_setBackgroundColorTranslated(&context, background);
+    Graphics_setFont(&context, &g_sFontFixed6x8);
+
+    for (c = LCD_GLYPH_FIRST; c <= LCD_GLYPH_LAST; c++)
+    {
+        Lcd_GlyphTarget = Lcd_GlyphCache[c - LCD_GLYPH_FIRST];
+
+        //
+        // Cells are filled with the background first, the font may leave
+        // the spacing column untouched.
+        //
+        Crystalfontz128x128_GlyphRectFill(&Lcd_GlyphDisplay, &cell, background);
+        Graphics_drawString(&context, &c, 1, 0, 0, OPAQUE_TEXT);
+    }
+
+    Lcd_GlyphForeground = foreground;
+    Lcd_GlyphBackground = background;
+    Lcd_GlyphValid = 1;
+}
+
+
+//*****************************************************************************
+//
+//! Draws a string using the glyph cache.
+//!
+//! \param context is a pointer to the drawing context to use.
+//! \param string is a pointer to the string to be drawn.
+//! \param length is the number of characters from the string that should be
+//! drawn on the screen, or AUTO_STRING_LENGTH for the whole string.
+//! \param x is the X coordinate of the upper left corner of the string.
+//! \param y is the Y coordinate of the upper left corner of the string.
+//! \param opaque is true if the background of each character should be drawn
+//! and false if it should not (leaving the background as is).
+//!
+//! Takes the same arguments as Graphics_drawString().  Opaque strings in
+//! g_sFontFixed6x8 made of printable characters that fit inside the clipping
+//! region are written from the glyph cache, anything else is passed on to
+//! Graphics_drawString().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_DrawString(const Graphics_Context *context,
+                                    const int8_t *string,
+                                    int32_t length, int32_t x,
+                                    int32_t y, bool opaque)
+{
+    int32_t i, row, width;
+    uint8_t *pucLine;
+
+    if (length < 0)
+    {
+        length = strlen((const char *)string);
+    }
+
+    width = length * LCD_GLYPH_WIDTH;
+
+    if (!opaque || (context->font != &g_sFontFixed6x8) || (length == 0) ||
+        (width > LCD_HORIZONTAL_MAX) ||
+        (x < context->clipRegion.sXMin) ||
+        (x + width - 1 > context->clipRegion.sXMax) ||
+        (y < context->clipRegion.sYMin) ||
+        (y + LCD_GLYPH_HEIGHT - 1 > context->clipRegion.sYMax))
+    {
+        Graphics_drawString(context, (int8_t *)string, length, x, y, opaque);
+        return;
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        if ((string[i] < LCD_GLYPH_FIRST) || (string[i] > LCD_GLYPH_LAST))
+        {
+            Graphics_drawString(context, (int8_t *)string, length, x, y, opaque);
+            return;
+        }
+    }
+
+    if (!Lcd_GlyphValid ||
+        (Lcd_GlyphForeground != (uint16_t)context->foreground) ||
+        (Lcd_GlyphBackground != (uint16_t)context->background))
+    {
+        Crystalfontz128x128_GlyphRender(context->foreground, context->background);
+    }
+
+    //
+    // Write the whole string through one window, one row at a time.
+    //
+    Crystalfontz128x128_BeginWrite(x, y, x + width - 1, y + LCD_GLYPH_HEIGHT - 1);
+    for (row = 0; row < LCD_GLYPH_HEIGHT; row++)
+    {
+        pucLine = Lcd_LineBuffer;
+        for (i = 0; i < length; i++)
+        {
+            memcpy(pucLine, Lcd_GlyphCache[string[i] - LCD_GLYPH_FIRST][row],
+                   LCD_GLYPH_WIDTH * 2);
+            pucLine += LCD_GLYPH_WIDTH * 2;
+        }
+        Crystalfontz128x128_WritePixels(Lcd_LineBuffer, width);
+    }
+}
+
+
+//*****************************************************************************
+//
+//! Draws a string centered around a point, using the glyph cache.
+//!
+//! Takes the same arguments as Graphics_drawStringCentered() and places the
+//! string the same way before handing it to
+//! Crystalfontz128x128_DrawString().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_DrawStringCentered(const Graphics_Context *context,
+                                            const int8_t *string,
+                                            int32_t length, int32_t x,
+                                            int32_t y, bool opaque)
+{
+    Crystalfontz128x128_DrawString(context, string, length,
+                                   x - (Graphics_getStringWidth(context,
+                                                                (int8_t *)string,
+                                                                length) / 2),
+                                   y - (context->font->baseline / 2), opaque);
+}
+
+
+//*****************************************************************************
+//
+//! Draws an image, decoding RLE4 compressed data on the fly.
+//!
+//! \param context is a pointer to the drawing context to use.
+//! \param image is a pointer to the image to draw.
+//! \param x is the X coordinate of the upper left corner of the image.
+//! \param y is the Y coordinate of the upper left corner of the image.
+//!
+//! Takes the same arguments as Graphics_drawImage().  IMAGE_FMT_4BPP_COMP_RLE4
+//! images that fit inside the clipping region are written through a single
+//! window: each byte of the data is a run of ((byte >> 4) + 1) pixels of
+//! palette entry (byte & 0x0F), runs continue across rows, and every run goes
+//! out as one repeated color without decoding the image into a buffer.
+//! Anything else is passed on to Graphics_drawImage().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_DrawImage(const Graphics_Context *context,
+                                   const Graphics_Image *image,
+                                   int16_t x, int16_t y)
+{
+    uint16_t palette[16];
+    const uint8_t *pucData;
+    uint32_t remaining;
+    uint16_t run;
+    uint16_t i;
+
+    if ((image->bPP != IMAGE_FMT_4BPP_COMP_RLE4) || (image->numColors > 16) ||
+        (x < context->clipRegion.sXMin) ||
+        (x + image->xSize - 1 > context->clipRegion.sXMax) ||
+        (y < context->clipRegion.sYMin) ||
+        (y + image->ySize - 1 > context->clipRegion.sYMax))
+    {
+        Graphics_drawImage(context, image, x, y);
+        return;
+    }
+
+    for (i = 0; i < image->numColors; i++)
+    {
+        palette[i] = Crystalfontz128x128_ColorTranslate(&g_sCrystalfontz128x128,
+                                                        image->pPalette[i]);
+    }
+
+    Crystalfontz128x128_BeginWrite(x, y, x + image->xSize - 1,
+                                   y + image->ySize - 1);
+
+    pucData = image->pPixel;
+    remaining = (uint32_t)image->xSize * image->ySize;
+    while (remaining)
+    {
+        run = (*pucData >> 4) + 1;
+        if (run > remaining)
+        {
+            run = remaining;
+        }
+        Crystalfontz128x128_WriteColor(palette[*pucData & 0x0F], run);
+        remaining -= run;
+        pucData++;
+    }
+}
+
+
+//*****************************************************************************
+//
+//! Draws a sparkline, one column per value.
+//!
+//! \param context is a pointer to the drawing context to use.
+//! \param values is a pointer to the values to plot, oldest first.
+//! \param count is the number of values, and the width of the graph.
+//! \param x is the X coordinate of the left column of the graph.
+//! \param y is the Y coordinate of the top row of the graph.
+//! \param height is the height of the graph in pixels.
+//! \param min is the value plotted on the bottom row.
+//! \param max is the value plotted on the top row.
+//!
+//! Each column is drawn in the foreground color as a single vertical run
+//! from the height of the previous value to the height of its own, so the
+//! graph costs one window per column whatever its shape.  Graphs that do
+//! not fit inside the clipping region go through Graphics_drawLineV().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_DrawSparkline(const Graphics_Context *context,
+                                       const int16_t *values, uint16_t count,
+                                       int16_t x, int16_t y, uint16_t height,
+                                       int16_t min, int16_t max)
+{
+    bool clipped;
+    int32_t range = (int32_t)max - min;
+    int16_t bottom = y + height - 1;
+    int16_t previous = 0;
+    int16_t current;
+    int16_t y1, y2;
+    uint16_t i;
+
+    if ((count == 0) || (height == 0))
+    {
+        return;
+    }
+
+    clipped = (x < context->clipRegion.sXMin) ||
+              (x + count - 1 > context->clipRegion.sXMax) ||
+              (y < context->clipRegion.sYMin) ||
+              (bottom > context->clipRegion.sYMax);
+
+    for (i = 0; i < count; i++)
+    {
+        //
+        // Row of the value, a flat graph is drawn in the middle.
+        //
+        if (range <= 0)
+        {
+            current = y + (height - 1) / 2;
+        }
+        else if (values[i] <= min)
+        {
+            current = bottom;
+        }
+        else if (values[i] >= max)
+        {
+            current = y;
+        }
+        else
+        {
+            current = bottom - (int16_t)(((int32_t)(values[i] - min) *
+                                          (height - 1) + range / 2) / range);
+        }
+
+        if (i == 0)
+        {
+            previous = current;
+        }
+        y1 = (current < previous) ? current : previous;
+        y2 = (current < previous) ? previous : current;
+
+        if (clipped)
+        {
+            Graphics_drawLineV(context, x + i, y1, y2);
+        }
+        else
+        {
+            Crystalfontz128x128_LineDrawV(&g_sCrystalfontz128x128, x + i,
+                                          y1, y2, context->foreground);
+        }
+        previous = current;
+    }
+}
@@ -48,6 +48,62 @@
 #define LCD_VERTICAL_MAX                   128
 #define LCD_HORIZONTAL_MAX                 128
 
+// Set to 1 to draw into a RAM copy of the panel (32 KB of SRAM) and only send
+// the changed regions when Graphics_flushBuffer() is called. Set to 0 to draw
+// straight to the panel.
+//
+// The MSP432P401R has 64 KB of SRAM. With the frame buffer, the application
+// takes about:
+//
+//   frame buffer and its dirty spans, flush windows and costs   33.5 KB
+//   glyph cache (Lcd_GlyphCache)                                  8.9 KB
+//   cities[] in main.c, MAX_CITIES entries                        5.0 KB
+//   DMA control table (1 KB aligned), pattern and queue           2.0 KB
+//   everything else in .data and .bss                             1.0 KB
+//   stack and heap, as set in the project                         1.5 KB
+//
+// msp432p401r.cmd keeps SRAM_STACK_HEADROOM free below the stack, so the link
+// fails rather than the stack running into .bss once these outgrow the SRAM.
+#ifndef LCD_FRAMEBUFFER_ENABLE
+#define LCD_FRAMEBUFFER_ENABLE             1
+#endif
+
+// Set to 0 to send CASET and RASET before every window, and a RAMWR before
+// every run, even when the controller already has them.  Only there to
+// measure what skipping them saves: host builds read it from a variable of
+// sim/lcd_sim.c so sim/lcd_bench.c can compare both in one run.
+#ifndef LCD_WINDOW_ELISION
+#ifdef LCD_SIM
+extern uint8_t Sim_LCD_windowElision;
+#define LCD_WINDOW_ELISION                 Sim_LCD_windowElision
+#else
+#define LCD_WINDOW_ELISION                 1
+#endif
+#endif
+
+// Pixels worth sending again from the frame buffer rather than flushing them
+// through one more window: its header and the interrupt that starts it take
+// about as long
+#define LCD_FLUSH_WINDOW_COST              16
+
+// Printable characters of g_sFontFixed6x8 kept pre-rendered in the panel's
+// native format by Crystalfontz128x128_DrawString()
+#define LCD_GLYPH_FIRST                    0x20
+#define LCD_GLYPH_LAST                     0x7E
+#define LCD_GLYPH_WIDTH                    6
+#define LCD_GLYPH_HEIGHT                   8
+
+// Controller memory is 132 lines, the 4 lines the panel does not show hold
+// the rows of the next screen during a Crystalfontz128x128_Carousel()
+// transition.  The screen scrolls LCD_CAROUSEL_STEP lines every
+// LCD_CAROUSEL_FRAME_DELAY microseconds, as ticked by the HAL frame timer.
+#define LCD_MEMORY_LINES                   132
+#define LCD_CAROUSEL_STEP                  (LCD_MEMORY_LINES - LCD_VERTICAL_MAX)
+#define LCD_CAROUSEL_FRAME_DELAY           6000
+
+#define LCD_CAROUSEL_NEXT     0
+#define LCD_CAROUSEL_PREVIOUS 1
+
 #define LCD_ORIENTATION_UP    0
 #define LCD_ORIENTATION_LEFT  1
 #define LCD_ORIENTATION_DOWN  2
@@ -73,7 +129,9 @@
 #define CM_RGBSET          0x2d
 #define CM_RAMRD           0x2E
 #define CM_PTLAR           0x30
+#define CM_VSCRDEF         0x33
 #define CM_MADCTL          0x36
+#define CM_VSCSAD          0x37
 #define CM_COLMOD          0x3A
 #define CM_SETPWCTR        0xB1
 #define CM_SETDISPL        0xB2
@@ -107,6 +165,33 @@ extern void Crystalfontz128x128_SetDrawFrame(uint16_t x0, uint16_t y0, uint16_t
 
 extern void Crystalfontz128x128_SetOrientation(uint8_t orientation);
 
+extern void Crystalfontz128x128_Carousel(uint8_t direction,
+                                        uint32_t separatorColor);
+
+extern bool Crystalfontz128x128_CarouselDue(void);
+
+extern bool Crystalfontz128x128_CarouselStep(void);
+
+extern void Crystalfontz128x128_DrawImage(const Graphics_Context *context,
+                                          const Graphics_Image *image,
+                                          int16_t x, int16_t y);
+
+extern void Crystalfontz128x128_DrawString(const Graphics_Context *context,
+                                           const int8_t *string,
+                                           int32_t length, int32_t x,
+                                           int32_t y, bool opaque);
+
+extern void Crystalfontz128x128_DrawStringCentered(const Graphics_Context *context,
+                                                   const int8_t *string,
+                                                   int32_t length, int32_t x,
+                                                   int32_t y, bool opaque);
+
+extern void Crystalfontz128x128_DrawSparkline(const Graphics_Context *context,
+                                              const int16_t *values,
+                                              uint16_t count, int16_t x,
+                                              int16_t y, uint16_t height,
+                                              int16_t min, int16_t max);
+
 
 
 #endif /* __CRYSTALFONTZLCD_H__ */
@@ -56,6 +56,14 @@ void HAL_LCD_PortInit(void)
     GPIO_setAsOutputPin(LCD_CS_PORT, LCD_CS_PIN);
 }
 
+void HAL_LCD_reset(void)
+{
+    GPIO_setOutputLowOnPin(LCD_RST_PORT, LCD_RST_PIN);
+    HAL_LCD_delay(50);
+    GPIO_setOutputHighOnPin(LCD_RST_PORT, LCD_RST_PIN);
+    HAL_LCD_delay(120);
+}
+
 void HAL_LCD_SpiInit(void)
 {
     eUSCI_SPI_MasterConfig config =
@@ -79,18 +87,102 @@ void HAL_LCD_SpiInit(void)
 
 //*****************************************************************************
 //
-// Writes a command to the CFAF128128B-0145T.  This function implements the basic SPI
-// interface to the LCD display.
+// DMA control table. The uDMA controller requires it to be aligned on a 1024
+// byte boundary.
 //
 //*****************************************************************************
-void HAL_LCD_writeCommand(uint8_t command)
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_ALIGN(LCD_DMAControlTable, 1024)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma data_alignment=1024
+#elif defined(__GNUC__)
+__attribute__ ((aligned (1024)))
+#elif defined(__CC_ARM)
+__align(1024)
+#endif
+static DMA_ControlTable LCD_DMAControlTable[32];
+
+// Repeated color pattern used as DMA source by HAL_LCD_writeColor()
+static uint8_t LCD_DMAPattern[LCD_DMA_PATTERN_SIZE];
+static uint16_t LCD_DMAPatternColor;
+static uint8_t LCD_DMAPatternValid = 0;
+
+// Blocks waiting to be sent, LCD_QueueHead is the one being sent. The main
+// loop only moves the tail and the DMA interrupt only moves the head.
+static HAL_LCD_Block LCD_Queue[LCD_QUEUE_SIZE];
+static volatile uint16_t LCD_QueueHead = 0;
+static volatile uint16_t LCD_QueueTail = 0;
+
+// Progress through the block at the head of the queue
+static uint8_t LCD_QueueStarted = 0;
+static uint16_t LCD_QueueRow;
+static uint32_t LCD_QueueOffset;
+
+// Periods of the frame timer elapsed since it was started
+static volatile uint16_t LCD_FrameTicks = 0;
+
+void HAL_LCD_DmaInit(void)
 {
-    // Set to command mode
-    GPIO_setOutputLowOnPin(LCD_DC_PORT, LCD_DC_PIN);
+    DMA_enableModule();
+    DMA_setControlBase(LCD_DMAControlTable);
 
-    // USCI_B0 Busy? //
+    // Route the USCI transmit flag to the LCD channel
+    DMA_assignChannel(LCD_DMA_CHANNEL);
+    DMA_disableChannelAttribute(LCD_DMA_CHANNEL,
+                                UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST |
+                                UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+
+    // Completion of the channel drives the transfer queue
+    DMA_assignInterrupt(LCD_DMA_INT, LCD_DMA_CHANNEL_NUM);
+    DMA_clearInterruptFlag(LCD_DMA_CHANNEL_NUM);
+    DMA_enableInterrupt(LCD_DMA_INT);
+}
+
+
+//*****************************************************************************
+//
+// Moves count bytes from src to the USCI transmit buffer with the DMA
+// controller. count must not exceed LCD_DMA_MAX_TRANSFER. srcIncrement is
+// UDMA_SRC_INC_8 to walk a buffer or UDMA_SRC_INC_NONE to repeat one byte.
+//
+//*****************************************************************************
+static void HAL_LCD_dmaStart(const uint8_t *src, uint32_t count,
+                             uint32_t srcIncrement)
+{
+    DMA_setChannelControl(UDMA_PRI_SELECT | LCD_DMA_CHANNEL,
+                          UDMA_SIZE_8 | srcIncrement | UDMA_DST_INC_NONE |
+                          UDMA_ARB_1);
+    DMA_setChannelTransfer(UDMA_PRI_SELECT | LCD_DMA_CHANNEL,
+                           UDMA_MODE_BASIC, (void *) src,
+                           (void *) SPI_getTransmitBufferAddressForDMA(LCD_EUSCI_BASE),
+                           count);
+
+    // The USCI transmit flag is already set, so the transfer starts as soon
+    // as the channel is enabled. The channel disables itself when done.
+    DMA_enableChannel(LCD_DMA_CHANNEL_NUM);
+}
+
+static void HAL_LCD_dmaTransfer(const uint8_t *src, uint32_t count,
+                                uint32_t srcIncrement)
+{
+    HAL_LCD_dmaStart(src, count, srcIncrement);
+    while (DMA_isChannelEnabled(LCD_DMA_CHANNEL_NUM));
+}
+
+
+//*****************************************************************************
+//
+// Sends a command byte without looking at the transfer queue.
+//
+//*****************************************************************************
+static void HAL_LCD_sendCommand(uint8_t command)
+{
+    // Let the previous data byte leave the shift register before D/C changes
     while (UCB0STATW & UCBUSY);
 
+    // Set to command mode
+    GPIO_setOutputLowOnPin(LCD_DC_PORT, LCD_DC_PIN);
+
     // Transmit data
     UCB0TXBUF = command;
 
@@ -102,6 +194,21 @@ void HAL_LCD_writeCommand(uint8_t command)
 }
 
 
+//*****************************************************************************
+//
+// Writes a command to the CFAF128128B-0145T.  This function implements the basic SPI
+// interface to the LCD display.
+//
+//*****************************************************************************
+void HAL_LCD_writeCommand(uint8_t command)
+{
+    // Blocks still queued must reach the display first
+    HAL_LCD_waitIdle();
+
+    HAL_LCD_sendCommand(command);
+}
+
+
 //*****************************************************************************
 //
 // Writes a data to the CFAF128128B-0145T.  This function implements the basic SPI
@@ -110,16 +217,335 @@ void HAL_LCD_writeCommand(uint8_t command)
 //*****************************************************************************
 void HAL_LCD_writeData(uint8_t data)
 {
-    // USCI_B0 Busy? //
-    while (UCB0STATW & UCBUSY);
+    // Wait for room in the transmit buffer. The shift register may still be
+    // busy, HAL_LCD_writeCommand() waits for it before toggling D/C.
+    while (!(UCB0IFG & UCTXIFG));
 
     // Transmit data
     UCB0TXBUF = data;
+}
 
-    // USCI_B0 Busy? //
-    while (UCB0STATW & UCBUSY);
+
+//*****************************************************************************
+//
+// Writes a block of data bytes to the CFAF128128B-0145T. Blocks long enough to
+// amortize the setup are moved by the DMA controller in chunks of at most
+// LCD_DMA_MAX_TRANSFER bytes.
+//
+//*****************************************************************************
+void HAL_LCD_writeDataBlock(const uint8_t *data, uint32_t length)
+{
+    uint32_t chunk;
+
+    HAL_LCD_waitIdle();
+
+    if (length < LCD_DMA_MIN_TRANSFER)
+    {
+        while (length--)
+        {
+            HAL_LCD_writeData(*data++);
+        }
+        return;
+    }
+
+    while (length)
+    {
+        chunk = (length > LCD_DMA_MAX_TRANSFER) ? LCD_DMA_MAX_TRANSFER : length;
+        HAL_LCD_dmaTransfer(data, chunk, UDMA_SRC_INC_8);
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+
+//*****************************************************************************
+//
+// Writes count copies of a 16-bit color to the CFAF128128B-0145T. When both
+// bytes of the color are equal a single byte is repeated by the DMA
+// controller, otherwise a pattern buffer holding the color is streamed.
+//
+//*****************************************************************************
+void HAL_LCD_writeColor(uint16_t color, uint32_t count)
+{
+    uint8_t hi = color >> 8;
+    uint8_t lo = color;
+    uint32_t length = count * 2;
+    uint32_t chunk;
+    uint16_t i;
+
+    HAL_LCD_waitIdle();
+
+    if (length < LCD_DMA_MIN_TRANSFER)
+    {
+        while (count--)
+        {
+            HAL_LCD_writeData(hi);
+            HAL_LCD_writeData(lo);
+        }
+        return;
+    }
+
+    if (hi == lo)
+    {
+        LCD_DMAPattern[0] = hi;
+        LCD_DMAPatternValid = 0;
+        while (length)
+        {
+            chunk = (length > LCD_DMA_MAX_TRANSFER) ? LCD_DMA_MAX_TRANSFER : length;
+            HAL_LCD_dmaTransfer(LCD_DMAPattern, chunk, UDMA_SRC_INC_NONE);
+            length -= chunk;
+        }
+        return;
+    }
+
+    if (!LCD_DMAPatternValid || LCD_DMAPatternColor != color)
+    {
+        for (i = 0; i < LCD_DMA_PATTERN_SIZE; i += 2)
+        {
+            LCD_DMAPattern[i] = hi;
+            LCD_DMAPattern[i + 1] = lo;
+        }
+        LCD_DMAPatternColor = color;
+        LCD_DMAPatternValid = 1;
+    }
+
+    while (length)
+    {
+        chunk = (length > LCD_DMA_PATTERN_SIZE) ? LCD_DMA_PATTERN_SIZE : length;
+        HAL_LCD_dmaTransfer(LCD_DMAPattern, chunk, UDMA_SRC_INC_8);
+        length -= chunk;
+    }
 }
 
+//*****************************************************************************
+//
+// Sends the queue until the next DMA transfer is started or the queue is
+// empty. Runs from the DMA interrupt, or with it masked when the queue is
+// kicked off by HAL_LCD_queueBlock().
+//
+//*****************************************************************************
+static void HAL_LCD_queueNext(void)
+{
+    HAL_LCD_Block *block;
+    uint32_t chunk;
+    uint8_t i;
+
+    while (LCD_QueueHead != LCD_QueueTail)
+    {
+        block = &LCD_Queue[LCD_QueueHead];
+
+        if (!LCD_QueueStarted)
+        {
+            // Commands and their parameters are only a few bytes, they are
+            // written by the CPU
+            for (i = 0; i < block->headerLength; i++)
+            {
+                if (block->commandMask & (1 << i))
+                {
+                    HAL_LCD_sendCommand(block->header[i]);
+                }
+                else
+                {
+                    HAL_LCD_writeData(block->header[i]);
+                }
+            }
+            LCD_QueueRow = 0;
+            LCD_QueueOffset = 0;
+            LCD_QueueStarted = 1;
+        }
+
+        if ((LCD_QueueRow < block->rows) && block->length)
+        {
+            chunk = block->length - LCD_QueueOffset;
+            if (chunk > LCD_DMA_MAX_TRANSFER)
+            {
+                chunk = LCD_DMA_MAX_TRANSFER;
+            }
+
+            HAL_LCD_dmaStart(block->data + (uint32_t)LCD_QueueRow * block->stride +
+                             LCD_QueueOffset, chunk, UDMA_SRC_INC_8);
+
+            LCD_QueueOffset += chunk;
+            if (LCD_QueueOffset == block->length)
+            {
+                LCD_QueueOffset = 0;
+                LCD_QueueRow++;
+            }
+            return;
+        }
+
+        LCD_QueueStarted = 0;
+        LCD_QueueHead = (LCD_QueueHead + 1) % LCD_QUEUE_SIZE;
+    }
+}
+
+
+//*****************************************************************************
+//
+// Adds a block to the transfer queue and returns without waiting for it to
+// be sent. The data must stay untouched until the queue is idle. Only waits
+// when the queue is full, see HAL_LCD_queueFree().
+//
+//*****************************************************************************
+void HAL_LCD_queueBlock(const HAL_LCD_Block *block)
+{
+    uint16_t next = (LCD_QueueTail + 1) % LCD_QUEUE_SIZE;
+    bool idle;
+
+    while (next == LCD_QueueHead);
+
+    LCD_Queue[LCD_QueueTail] = *block;
+
+    Interrupt_disableInterrupt(LCD_DMA_INT);
+    idle = (LCD_QueueHead == LCD_QueueTail);
+    LCD_QueueTail = next;
+    if (idle)
+    {
+        HAL_LCD_queueNext();
+    }
+    Interrupt_enableInterrupt(LCD_DMA_INT);
+}
+
+
+//*****************************************************************************
+//
+// Returns the number of blocks that can be queued without waiting. One slot
+// always stays empty to tell a full queue from an empty one.
+//
+//*****************************************************************************
+uint16_t HAL_LCD_queueFree(void)
+{
+    return (LCD_QueueHead + LCD_QUEUE_SIZE - LCD_QueueTail - 1) % LCD_QUEUE_SIZE;
+}
+
+
+//*****************************************************************************
+//
+// Returns true while queued blocks are still being sent.
+//
+//*****************************************************************************
+bool HAL_LCD_isBusy(void)
+{
+    return (LCD_QueueHead != LCD_QueueTail);
+}
+
+
+//*****************************************************************************
+//
+// Waits for the transfer queue to drain.
+//
+//*****************************************************************************
+void HAL_LCD_waitIdle(void)
+{
+    while (LCD_QueueHead != LCD_QueueTail);
+}
+
+
+//*****************************************************************************
+//
+// Drops everything left in the transfer queue. Waits for the DMA transfer in
+// progress, so the data of the dropped blocks can be reused on return.
+// Returns true if any block was not completely sent.
+//
+//*****************************************************************************
+bool HAL_LCD_abortQueue(void)
+{
+    bool busy;
+
+    Interrupt_disableInterrupt(LCD_DMA_INT);
+    busy = (LCD_QueueHead != LCD_QueueTail);
+    if (busy)
+    {
+        while (DMA_isChannelEnabled(LCD_DMA_CHANNEL_NUM));
+        DMA_clearInterruptFlag(LCD_DMA_CHANNEL_NUM);
+        LCD_QueueStarted = 0;
+        LCD_QueueHead = LCD_QueueTail;
+    }
+    Interrupt_enableInterrupt(LCD_DMA_INT);
+
+    return busy;
+}
+
+
+//*****************************************************************************
+//
+// DMA completion interrupt. Transfers started outside the queue also end up
+// here, there is nothing to do for them.
+//
+//*****************************************************************************
+void DMA_INT1_IRQHandler(void)
+{
+    DMA_clearInterruptFlag(LCD_DMA_CHANNEL_NUM);
+
+    if (LCD_QueueHead != LCD_QueueTail)
+    {
+        HAL_LCD_queueNext();
+    }
+}
+
+
+//*****************************************************************************
+//
+// Starts the frame timer, which counts one tick every period microseconds
+// and wakes the CPU for each. HAL_LCD_frameTicks() returns the count.
+//
+//*****************************************************************************
+void HAL_LCD_frameStart(uint32_t period)
+{
+    Timer_A_UpModeConfig config =
+    {
+        TIMER_A_CLOCKSOURCE_ACLK,
+        TIMER_A_CLOCKSOURCE_DIVIDER_1,
+        (uint16_t)((period * LCD_FRAME_CLOCK_SPEED + 500000) / 1000000),
+        TIMER_A_TAIE_INTERRUPT_DISABLE,
+        TIMER_A_CCIE_CCR0_INTERRUPT_ENABLE,
+        TIMER_A_DO_CLEAR
+    };
+
+    LCD_FrameTicks = 0;
+    Timer_A_configureUpMode(LCD_FRAME_TIMER, &config);
+    Interrupt_enableInterrupt(LCD_FRAME_INT);
+    Timer_A_startCounter(LCD_FRAME_TIMER, TIMER_A_UP_MODE);
+}
+
+
+//*****************************************************************************
+//
+// Stops the frame timer.
+//
+//*****************************************************************************
+void HAL_LCD_frameStop(void)
+{
+    Timer_A_stopTimer(LCD_FRAME_TIMER);
+    Interrupt_disableInterrupt(LCD_FRAME_INT);
+}
+
+
+//*****************************************************************************
+//
+// Returns the number of frame timer periods elapsed since
+// HAL_LCD_frameStart(), wrapping at 65536.
+//
+//*****************************************************************************
+uint16_t HAL_LCD_frameTicks(void)
+{
+    return LCD_FrameTicks;
+}
+
+
+//*****************************************************************************
+//
+// Frame timer interrupt.
+//
+//*****************************************************************************
+void TA1_0_IRQHandler(void)
+{
+    Timer_A_clearCaptureCompareInterrupt(LCD_FRAME_TIMER,
+                                         TIMER_A_CAPTURECOMPARE_REGISTER_0);
+    LCD_FrameTicks++;
+}
+
+
 //*****************************************************************************
 //
 //! Provides a small delay.
@@ -154,7 +580,9 @@ SysCtlDelay(uint32_t ui32Count)
           "    bx      lr");
 }
 #endif
-#if defined(codered) || defined( __GNUC__ ) || defined(sourcerygxx)
+// Host builds (LCD_SIM) are not ARM, the test linking this file provides it.
+#if (defined(codered) || defined( __GNUC__ ) || defined(sourcerygxx)) && \
+    !defined(LCD_SIM)
 void __attribute__((naked))
 SysCtlDelay(uint32_t ui32Count)
 {
@@ -73,6 +73,49 @@
 // Definition of USCI base address to be used for SPI communication
 #define LCD_EUSCI_BASE        EUSCI_B0_BASE
 
+// DMA channel triggered by the USCI transmit flag and its interrupt line
+#define LCD_DMA_CHANNEL       DMA_CH0_EUSCIB0TX0
+#define LCD_DMA_CHANNEL_NUM   DMA_CHANNEL_0
+#define LCD_DMA_INT           DMA_INT1
+
+// Timer_A module pacing the frames of a carousel transition, counting ACLK
+// (REFO) so it keeps running while the CPU sleeps in LPM0
+#define LCD_FRAME_TIMER       TIMER_A1_BASE
+#define LCD_FRAME_INT         INT_TA1_0
+#define LCD_FRAME_CLOCK_SPEED 32768
+
+// Largest number of items a single uDMA basic cycle can move
+#define LCD_DMA_MAX_TRANSFER  1024
+
+// Blocks shorter than this (in bytes) are cheaper to write with the CPU
+#define LCD_DMA_MIN_TRANSFER  16
+
+// Size (in bytes) of the repeated color pattern used for DMA fills
+#define LCD_DMA_PATTERN_SIZE  256
+
+// Number of blocks the transfer queue holds and the longest command/parameter
+// header (CASET, RASET and RAMWR with their parameters) a block can carry
+#define LCD_QUEUE_SIZE        32
+#define LCD_QUEUE_HEADER_MAX  11
+
+//*****************************************************************************
+//
+// A block sent by the transfer queue: the header bytes (bit n of commandMask
+// set when header[n] is a command) followed by rows of length data bytes,
+// stride bytes apart.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint8_t header[LCD_QUEUE_HEADER_MAX];
+    uint8_t headerLength;
+    uint16_t commandMask;
+    const uint8_t *data;
+    uint32_t length;
+    uint16_t stride;
+    uint16_t rows;
+} HAL_LCD_Block;
+
 //*****************************************************************************
 //
 // Prototypes for the globals exported by this driver.
@@ -80,8 +123,20 @@
 //*****************************************************************************
 extern void HAL_LCD_writeCommand(uint8_t command);
 extern void HAL_LCD_writeData(uint8_t data);
+extern void HAL_LCD_writeDataBlock(const uint8_t *data, uint32_t length);
+extern void HAL_LCD_writeColor(uint16_t color, uint32_t count);
 extern void HAL_LCD_PortInit(void);
 extern void HAL_LCD_SpiInit(void);
+extern void HAL_LCD_DmaInit(void);
+extern void HAL_LCD_reset(void);
+extern void HAL_LCD_queueBlock(const HAL_LCD_Block *block);
+extern uint16_t HAL_LCD_queueFree(void);
+extern bool HAL_LCD_isBusy(void);
+extern void HAL_LCD_waitIdle(void);
+extern bool HAL_LCD_abortQueue(void);
+extern void HAL_LCD_frameStart(uint32_t period);
+extern void HAL_LCD_frameStop(void);
+extern uint16_t HAL_LCD_frameTicks(void);
 
 // Custom __delay_cycles() for non CCS Compiler
 #if !defined( __TI_ARM__ )
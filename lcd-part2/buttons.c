@@ -0,0 +1,196 @@
+/* Debouncing and gestures of the boosterpack buttons, see buttons.h. */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "buttons.h"
+#include "event_queue.h"
+
+/**
+ * State of one button.
+ *
+ * pressed -> debounced state.
+ * bounce -> consecutive samples that differ from pressed.
+ * countdown -> milliseconds until the held button repeats its event.
+ * interval -> milliseconds between that repeat and the next one.
+ */
+typedef struct
+{
+    bool pressed;
+    uint8_t bounce;
+    uint16_t countdown;
+    uint16_t interval;
+} Button_t;
+
+static Button_t buttons[2];
+
+/* Events queued by each button, in the order of the BUTTONS_ bits. */
+static const Event_t press_events[2] = { BUTTON1_PRESSED, BUTTON2_PRESSED };
+static const Event_t repeat_events[2] = { BUTTON1_REPEATED, BUTTON2_REPEATED };
+
+/* Timer_A counting ACLK in up mode, its CCR0 interrupt is the tick. */
+static const Timer_A_UpModeConfig tick_config =
+{
+        TIMER_A_CLOCKSOURCE_ACLK,               // ACLK = REFO 32768 Hz
+        TIMER_A_CLOCKSOURCE_DIVIDER_1,
+        BUTTONS_TIMER_PERIOD,                   // 1 ms
+        TIMER_A_TAIE_INTERRUPT_DISABLE,
+        TIMER_A_CCIE_CCR0_INTERRUPT_ENABLE,
+        TIMER_A_DO_CLEAR
+};
+
+/* Advances one button, returns true while it is pressed or bouncing. */
+static bool Buttons_step(uint8_t index, bool pressed)
+{
+    Button_t *button = &buttons[index];
+
+    if (pressed != button->pressed)
+    {
+        if (++button->bounce < BUTTONS_DEBOUNCE_MS / BUTTONS_TICK_MS)
+        {
+            return true;
+        }
+
+        /* Stable long enough, a press counts right away. */
+        button->pressed = pressed;
+        button->bounce = 0;
+        if (pressed)
+        {
+            button->countdown = BUTTONS_LONG_PRESS_MS;
+            button->interval = BUTTONS_REPEAT_START_MS;
+            EventQueue_push(press_events[index]);
+        }
+        return pressed;
+    }
+
+    button->bounce = 0;
+    if (!pressed)
+    {
+        return false;
+    }
+
+    /* Held: repeat, each time a quarter faster down to the minimum. */
+    button->countdown -= BUTTONS_TICK_MS;
+    if (button->countdown == 0)
+    {
+        EventQueue_push(repeat_events[index]);
+        button->countdown = button->interval;
+        button->interval -= button->interval / 4;
+        if (button->interval < BUTTONS_REPEAT_MIN_MS)
+        {
+            button->interval = BUTTONS_REPEAT_MIN_MS;
+        }
+    }
+    return true;
+}
+
+bool Buttons_tick(uint8_t pressed)
+{
+    bool active;
+
+    active = Buttons_step(0, (pressed & BUTTONS_TOP) != 0);
+    active |= Buttons_step(1, (pressed & BUTTONS_BOTTOM) != 0);
+
+    return active;
+}
+
+/* Pins pressed right now, the buttons pull them low. */
+static uint8_t Buttons_read(void)
+{
+    uint8_t pressed = 0;
+
+    if (GPIO_getInputPinValue(GPIO_PORT_P5, GPIO_PIN1) == GPIO_INPUT_PIN_LOW)
+    {
+        pressed |= BUTTONS_TOP;
+    }
+    if (GPIO_getInputPinValue(GPIO_PORT_P3, GPIO_PIN5) == GPIO_INPUT_PIN_LOW)
+    {
+        pressed |= BUTTONS_BOTTOM;
+    }
+    return pressed;
+}
+
+/* Starts sampling, the pin interrupts stay off until the buttons are idle. */
+static void Buttons_wake(void)
+{
+    GPIO_disableInterrupt(GPIO_PORT_P5, GPIO_PIN1);
+    GPIO_disableInterrupt(GPIO_PORT_P3, GPIO_PIN5);
+
+    Timer_A_configureUpMode(BUTTONS_TIMER, &tick_config);
+    Timer_A_startCounter(BUTTONS_TIMER, TIMER_A_UP_MODE);
+}
+
+/* Stops sampling and waits for the next press edge. */
+static void Buttons_sleep(void)
+{
+    Timer_A_stopTimer(BUTTONS_TIMER);
+
+    GPIO_clearInterruptFlag(GPIO_PORT_P5, GPIO_PIN1);
+    GPIO_clearInterruptFlag(GPIO_PORT_P3, GPIO_PIN5);
+    GPIO_enableInterrupt(GPIO_PORT_P5, GPIO_PIN1);
+    GPIO_enableInterrupt(GPIO_PORT_P3, GPIO_PIN5);
+
+    /* A press starting before the interrupts were enabled has no edge left. */
+    if (Buttons_read())
+    {
+        Buttons_wake();
+    }
+}
+
+void Buttons_init(void)
+{
+    /* Define buttons as input. */
+    GPIO_setAsInputPinWithPullUpResistor(GPIO_PORT_P3, GPIO_PIN5);
+    GPIO_setAsInputPinWithPullUpResistor(GPIO_PORT_P5, GPIO_PIN1);
+
+    /* Interrupt when a button starts pulling its pin low. */
+    GPIO_interruptEdgeSelect(GPIO_PORT_P3, GPIO_PIN5,
+                             GPIO_HIGH_TO_LOW_TRANSITION);
+    GPIO_interruptEdgeSelect(GPIO_PORT_P5, GPIO_PIN1,
+                             GPIO_HIGH_TO_LOW_TRANSITION);
+
+    /* Clear the interrupt flags to avoid instant interrupt handling. */
+    GPIO_clearInterruptFlag(GPIO_PORT_P3, GPIO_PIN5);
+    GPIO_clearInterruptFlag(GPIO_PORT_P5, GPIO_PIN1);
+
+    /* Enable interrupt on port and pin. */
+    GPIO_enableInterrupt(GPIO_PORT_P3, GPIO_PIN5);
+    GPIO_enableInterrupt(GPIO_PORT_P5, GPIO_PIN1);
+
+    /* Enable interrupt on ports and on the sampling tick. */
+    Interrupt_enableInterrupt(INT_PORT3);
+    Interrupt_enableInterrupt(INT_PORT5);
+    Interrupt_enableInterrupt(INT_TA0_0);
+}
+
+/* Port 5 handler for the top button switch on the boosterpack. Pin:33 -> Port:5 Pin:1 */
+void PORT5_IRQHandler(void)
+{
+    if ((GPIO_getEnabledInterruptStatus(GPIO_PORT_P5) & GPIO_PIN1))
+    {
+        /* Clear interrupt flag (to clear pending interrupt indicator. */
+        GPIO_clearInterruptFlag(GPIO_PORT_P5, GPIO_PIN1);
+
+        /* The press is queued once the tick has debounced it. */
+        Buttons_wake();
+    }
+}
+
+/* Port 3 handler for the bottom button switch on the boosterpack. Pin:32 -> Port:3 Pin:5 */
+void PORT3_IRQHandler(void)
+{
+    if ((GPIO_getEnabledInterruptStatus(GPIO_PORT_P3) & GPIO_PIN5))
+    {
+        GPIO_clearInterruptFlag(GPIO_PORT_P3, GPIO_PIN5);
+        Buttons_wake();
+    }
+}
+
+/* Sampling tick, runs until both buttons are released and stable. */
+void TA0_0_IRQHandler(void)
+{
+    Timer_A_clearCaptureCompareInterrupt(BUTTONS_TIMER,
+                                         TIMER_A_CAPTURECOMPARE_REGISTER_0);
+
+    if (!Buttons_tick(Buttons_read()))
+    {
+        Buttons_sleep();
+    }
+}
@@ -0,0 +1,47 @@
+/**
+ * Debouncing and gestures of the two boosterpack buttons.
+ *
+ * An edge on either button starts a 1 ms Timer_A tick that samples both pins
+ * until they are released and stable again, so the CPU is not woken while
+ * the buttons are idle. A short press queues one BUTTONx_PRESSED event as
+ * soon as the pin has been stable for BUTTONS_DEBOUNCE_MS. Holding the
+ * button past BUTTONS_LONG_PRESS_MS queues BUTTONx_REPEATED events, first
+ * every BUTTONS_REPEAT_START_MS and then faster down to
+ * BUTTONS_REPEAT_MIN_MS, to page quickly through long city lists.
+ */
+#ifndef __BUTTONS_H__
+#define __BUTTONS_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Tick of the sampling timer, 33 ACLK (REFO 32768 Hz) cycles. */
+#define BUTTONS_TIMER TIMER_A0_BASE
+#define BUTTONS_TIMER_PERIOD 32
+#define BUTTONS_TICK_MS 1
+
+/* Gesture timings in milliseconds. The fastest repeat leaves the time to
+ * draw a page without transition and send it to the panel. */
+#define BUTTONS_DEBOUNCE_MS 5
+#define BUTTONS_LONG_PRESS_MS 500
+#define BUTTONS_REPEAT_START_MS 200
+#define BUTTONS_REPEAT_MIN_MS 40
+
+/* Bits of the pin state passed to Buttons_tick(), set while pressed. */
+#define BUTTONS_TOP 0x01
+#define BUTTONS_BOTTOM 0x02
+
+/**
+ * Configures the button pins and their interrupts, and the sampling timer.
+ */
+void Buttons_init(void);
+
+/**
+ * Advances the gesture state machine by one tick given the pins pressed,
+ * queuing the events recognized. Returns false once both buttons are
+ * released and stable, when the tick can stop. Does not touch the hardware,
+ * so it can be fed a pin timeline on the host.
+ */
+bool Buttons_tick(uint8_t pressed);
+
+#endif
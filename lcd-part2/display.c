@@ -0,0 +1,204 @@
+/* Drawing of the pages shown on the LCD screen. Kept apart from main.c so the
+ * pages can also be rendered by the host simulator in sim/. */
+#include <ti/grlib/grlib.h>
+#include "LcdDriver/Crystalfontz128x128_ST7735.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "temp_service.h"
+#include "history.h"
+#include "weather.h"
+
+/* Stores graphic library context. */
+Graphics_Context g_sContext;
+
+/* Set while handling a button press so the new page scrolls in, in the
+ * direction given by transition_direction. */
+bool transition = false;
+uint8_t transition_direction = LCD_CAROUSEL_NEXT;
+
+/* External image declaration to display. The images are located in icons/. */
+extern const Graphics_Image cloudy;
+extern const Graphics_Image sunny;
+extern const Graphics_Image snowy;
+extern const Graphics_Image rainy;
+extern const Graphics_Image home;
+
+/* Icon and text of each weather condition, in Weather_t order. */
+const Graphics_Image *const weather_icons[WEATHER_NUM] = { &cloudy, &snowy,
+                                                           &sunny, &rainy };
+const char *const weather_names[WEATHER_NUM] = { "Partly cloudy", "Snowy",
+                                                 "Sunny", "Rainy" };
+
+/* Initialize graphics settings for the LCD screen. */
+void _graphicsInit()
+{
+    /* Initializes display. */
+    Crystalfontz128x128_Init();
+
+    /* Set default screen orientation. */
+    Crystalfontz128x128_SetOrientation(LCD_ORIENTATION_UP);
+
+    /* Initializes graphics context and background/text color. */
+    Graphics_initContext(&g_sContext, &g_sCrystalfontz128x128,
+                         &g_sCrystalfontz128x128_funcs);
+    Graphics_setForegroundColor(&g_sContext, GRAPHICS_COLOR_WHITE);
+    Graphics_setBackgroundColor(&g_sContext, GRAPHICS_COLOR_BLACK);
+    GrContextFontSet(&g_sContext, &g_sFontFixed6x8);
+    Graphics_clearDisplay(&g_sContext);
+    Graphics_flushBuffer(&g_sContext);
+}
+
+/**
+ *  Brings the page drawn in the frame buffer on screen. Button presses start
+ *  scrolling it in, one frame per tick of the LCD frame timer stepped from
+ *  the main loop. Otherwise the changed regions of the frame buffer are
+ *  queued and the DMA interrupt sends them to the panel while the CPU sleeps.
+ */
+void show_page()
+{
+    if (transition)
+    {
+        Crystalfontz128x128_Carousel(transition_direction, GRAPHICS_COLOR_GRAY);
+    }
+    else
+    {
+        Graphics_flushBuffer(&g_sContext);
+    }
+}
+
+/* Writes tenths of degree Celsius as text, one decimal and the unit. */
+void format_temperature(char *str, int16_t temperature)
+{
+    int32_t value = temperature;
+
+    snprintf(str, TEMP_LENGTH, "%s%ld.%ldC", (value < 0) ? "-" : "",
+             (long) (labs(value) / 10), (long) (labs(value) % 10));
+}
+
+/**
+ *  Display room temperature, as last filtered by the sampling service of
+ *  temp_service.c.
+ */
+void display_temp()
+{
+    Graphics_clearDisplay(&g_sContext);
+
+    char str[TEMP_LENGTH];
+
+    format_temperature(str, TempService_getTemperature());
+
+    /* Information display. */
+    Crystalfontz128x128_DrawStringCentered(&g_sContext, (int8_t*) "CURRENT ROOM",
+                                           AUTO_STRING_LENGTH,
+                                           64, 30, OPAQUE_TEXT);
+    Crystalfontz128x128_DrawImage(&g_sContext, &home, 52, 40);
+
+    Crystalfontz128x128_DrawStringCentered(&g_sContext, (int8_t*) "Temperature:",
+                                           AUTO_STRING_LENGTH,
+                                           64, 72, OPAQUE_TEXT);
+
+    Crystalfontz128x128_DrawStringCentered(&g_sContext, (int8_t*) str,
+                                           AUTO_STRING_LENGTH,
+                                           64, 82, OPAQUE_TEXT);
+
+    display_history(HISTORY_HOUR);
+
+    show_page();
+}
+
+/* Sparkline of a history tier under the room temperature, with its range. */
+void display_history(int tier)
+{
+    int16_t values[HISTORY_POINTS];
+    HistoryStats_t stats;
+    char min[TEMP_LENGTH];
+    char max[TEMP_LENGTH];
+    char str[2 * TEMP_LENGTH + 1];
+    uint8_t count;
+
+    /* A line needs two points, the first one comes after a minute. */
+    count = History_getSeries((HistoryTier_t) tier, values, &stats);
+    if (count < 2)
+    {
+        return;
+    }
+
+    /* Right aligned so the newest point stays under the same column. */
+    Crystalfontz128x128_DrawSparkline(&g_sContext, values, count,
+                                      64 + HISTORY_POINTS / 2 - count, 98,
+                                      17, stats.min, stats.max);
+
+    format_temperature(min, stats.min);
+    format_temperature(max, stats.max);
+    snprintf(str, sizeof(str), "%s %s", min, max);
+    Crystalfontz128x128_DrawStringCentered(&g_sContext, (int8_t*) str,
+                                           AUTO_STRING_LENGTH,
+                                           64, 122, OPAQUE_TEXT);
+}
+
+/* Display weather information on the LCD screen corresponding to the city number. */
+void display_weather(int city)
+{
+    Graphics_clearDisplay(&g_sContext);
+
+    city--;
+
+    const City_t *info = &cities[city];
+    char temperature[TEMP_LENGTH];
+    char humidity[HUMIDITY_LENGTH];
+
+    /* The text is only formatted here, when the page is drawn. */
+    format_temperature(temperature, info->temperature);
+    snprintf(humidity, sizeof(humidity), "Hum: %u%%", info->humidity);
+
+    /* Icon of the weather condition. */
+    if (info->weather < WEATHER_NUM)
+    {
+        Crystalfontz128x128_DrawImage(&g_sContext,
+                                      weather_icons[info->weather], 52, 40);
+    }
+
+    /* Information display. */
+    Crystalfontz128x128_DrawStringCentered(&g_sContext, (int8_t*) info->name,
+                                           AUTO_STRING_LENGTH,
+                                           64, 30, OPAQUE_TEXT);
+
+    Crystalfontz128x128_DrawStringCentered(&g_sContext, (int8_t*) temperature,
+                                           AUTO_STRING_LENGTH,
+                                           64, 72, OPAQUE_TEXT);
+
+    if (info->weather < WEATHER_NUM)
+    {
+        Crystalfontz128x128_DrawStringCentered(&g_sContext,
+                                               (int8_t*) weather_names[info->weather],
+                                               AUTO_STRING_LENGTH,
+                                               64, 82, OPAQUE_TEXT);
+    }
+
+    Crystalfontz128x128_DrawStringCentered(&g_sContext, (int8_t*) humidity,
+                                           AUTO_STRING_LENGTH,
+                                           64, 92, OPAQUE_TEXT);
+
+    show_page();
+}
+
+/* PAGE NAVIGATION. */
+
+/* Page shown after page, the room page follows the last city. */
+uint16_t next_page(uint16_t page)
+{
+    return (page >= city_count) ? 0 : page + 1;
+}
+
+/* Page shown before page, the last city precedes the room page. */
+uint16_t previous_page(uint16_t page)
+{
+    return (page == 0 || page > city_count) ? city_count : page - 1;
+}
+
+/* State of the FSM handling page. */
+State_t page_state(uint16_t page)
+{
+    return (page == 0) ? STATE_TEMP : STATE_CITY;
+}
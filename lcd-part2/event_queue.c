@@ -0,0 +1,79 @@
+/* Single producer, single consumer ring of input events, see event_queue.h. */
+#include <ti/devices/msp432p4xx/inc/msp.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "event_queue.h"
+
+/* Entries and free running indexes, their difference is the fill level. */
+static InputEvent_t queue[EVENT_QUEUE_SIZE];
+static volatile uint8_t queue_head = 0;
+static volatile uint8_t queue_tail = 0;
+
+/* Events dropped because the consumer fell behind. */
+static volatile uint32_t queue_overflows = 0;
+
+void EventQueue_init(void)
+{
+    /* Free running 32-bit down counter at MCLK, used for the timestamps. */
+    Timer32_initModule(EVENT_QUEUE_TIMER, TIMER32_PRESCALER_1, TIMER32_32BIT,
+                       TIMER32_FREE_RUN_MODE);
+    Timer32_startTimer(EVENT_QUEUE_TIMER, false);
+
+    queue_tail = queue_head;
+    queue_overflows = 0;
+}
+
+uint32_t EventQueue_now(void)
+{
+    /* The timer counts down from 0xFFFFFFFF. */
+    return ~Timer32_getValue(EVENT_QUEUE_TIMER);
+}
+
+bool EventQueue_push(Event_t type)
+{
+    uint8_t head = queue_head;
+
+    if ((uint8_t) (head - queue_tail) >= EVENT_QUEUE_SIZE)
+    {
+        queue_overflows++;
+        return false;
+    }
+
+    queue[head & (EVENT_QUEUE_SIZE - 1)].type = type;
+    queue[head & (EVENT_QUEUE_SIZE - 1)].time = EventQueue_now();
+
+    /* The entry must be complete before the consumer can see it. */
+    __DMB();
+    queue_head = head + 1;
+
+    return true;
+}
+
+bool EventQueue_pop(InputEvent_t *event)
+{
+    uint8_t tail = queue_tail;
+
+    if (tail == queue_head)
+    {
+        return false;
+    }
+
+    /* Read the entry only after seeing the head that published it. */
+    __DMB();
+    *event = queue[tail & (EVENT_QUEUE_SIZE - 1)];
+
+    /* And release the slot only once it has been copied. */
+    __DMB();
+    queue_tail = tail + 1;
+
+    return true;
+}
+
+bool EventQueue_isEmpty(void)
+{
+    return queue_tail == queue_head;
+}
+
+uint32_t EventQueue_getOverflows(void)
+{
+    return queue_overflows;
+}
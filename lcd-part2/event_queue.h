@@ -0,0 +1,59 @@
+/**
+ * Queue of the input events raised by the button interrupts and handled by
+ * the FSM loop in main.c.
+ *
+ * The button tick interrupt of buttons.c is the only producer and main() the
+ * only consumer, so the queue needs no lock: each side only writes its own
+ * index, and memory barriers order the entry against the index update.
+ */
+#ifndef __EVENT_QUEUE_H__
+#define __EVENT_QUEUE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "weather.h"
+
+/* Number of entries, a power of two up to 128. */
+#define EVENT_QUEUE_SIZE 16
+
+/* Timer32 module counting the event timestamps at MCLK. */
+#define EVENT_QUEUE_TIMER TIMER32_0_BASE
+
+/**
+ * Defines a queued input event.
+ *
+ * type -> button press that occurred.
+ * time -> MCLK cycles since EventQueue_init(), wrapping every 89 seconds.
+ */
+typedef struct
+{
+    Event_t type;
+    uint32_t time;
+} InputEvent_t;
+
+/**
+ * Starts the timestamp timer and empties the queue.
+ */
+void EventQueue_init(void);
+
+/**
+ * Adds an event at the current time. Only called from the button tick.
+ * Returns false and counts an overflow when the queue is full.
+ */
+bool EventQueue_push(Event_t type);
+
+/**
+ * Takes the oldest event. Only called from main(). Returns false when the
+ * queue is empty.
+ */
+bool EventQueue_pop(InputEvent_t *event);
+
+bool EventQueue_isEmpty(void);
+
+/**
+ * Current timestamp and number of events dropped because the queue was full.
+ */
+uint32_t EventQueue_now(void);
+uint32_t EventQueue_getOverflows(void);
+
+#endif
@@ -0,0 +1,157 @@
+/* History of the room temperature, see history.h. */
+#include "history.h"
+
+/**
+ * One tier of points.
+ *
+ * deltas -> each point minus the point before it, unused for the oldest.
+ * first -> slot of the oldest point.
+ * count -> points stored, up to HISTORY_POINTS.
+ * base -> value of the oldest point.
+ * last -> value of the newest point, as decoded from the deltas.
+ * sum -> inputs of the point in progress, added up.
+ * inputs -> number of inputs in sum.
+ */
+typedef struct
+{
+    int8_t deltas[HISTORY_POINTS];
+    uint8_t first;
+    uint8_t count;
+    int16_t base;
+    int16_t last;
+    int32_t sum;
+    uint8_t inputs;
+} Tier_t;
+
+/* Volatile so the compiler keeps the writes between the sequence updates. */
+static volatile Tier_t tiers[HISTORY_TIERS];
+
+/* Inputs averaged into one point of each tier. */
+static const uint8_t tier_inputs[HISTORY_TIERS] = { HISTORY_HOUR_INPUTS,
+                                                    HISTORY_DAY_INPUTS,
+                                                    HISTORY_WEEK_INPUTS };
+
+/* Odd while History_add() changes the tiers, read around a decode. */
+static volatile uint16_t sequence = 0;
+
+void History_init(void)
+{
+    uint8_t i;
+
+    sequence++;
+    for (i = 0; i < HISTORY_TIERS; i++)
+    {
+        tiers[i].first = 0;
+        tiers[i].count = 0;
+        tiers[i].sum = 0;
+        tiers[i].inputs = 0;
+    }
+    sequence++;
+}
+
+/* Appends a point, dropping the oldest one when the tier is full. */
+static void History_push(volatile Tier_t *tier, int16_t value)
+{
+    int16_t delta;
+
+    if (tier->count == 0)
+    {
+        tier->base = value;
+        tier->last = value;
+        tier->count = 1;
+        return;
+    }
+
+    if (tier->count == HISTORY_POINTS)
+    {
+        tier->first = (tier->first + 1) % HISTORY_POINTS;
+        tier->base += tier->deltas[tier->first];
+        tier->count--;
+    }
+
+    /* Out of range steps are stored in part, the next points catch up
+     * since deltas are taken from the decoded value. */
+    delta = value - tier->last;
+    if (delta > INT8_MAX)
+    {
+        delta = INT8_MAX;
+    }
+    else if (delta < INT8_MIN)
+    {
+        delta = INT8_MIN;
+    }
+
+    tier->deltas[(tier->first + tier->count) % HISTORY_POINTS] = (int8_t)delta;
+    tier->last += delta;
+    tier->count++;
+}
+
+void History_add(int16_t sample)
+{
+    volatile Tier_t *tier;
+    int16_t value = sample;
+    uint8_t i;
+
+    sequence++;
+    for (i = 0; i < HISTORY_TIERS; i++)
+    {
+        tier = &tiers[i];
+        tier->sum += value;
+        if (++tier->inputs < tier_inputs[i])
+        {
+            break;
+        }
+
+        /* The point completed here is also an input of the next tier. */
+        value = (int16_t)(tier->sum / tier->inputs);
+        tier->sum = 0;
+        tier->inputs = 0;
+        History_push(tier, value);
+    }
+    sequence++;
+}
+
+uint8_t History_getSeries(HistoryTier_t tier, int16_t *values,
+                          HistoryStats_t *stats)
+{
+    const volatile Tier_t *points = &tiers[tier];
+    uint16_t start;
+    uint8_t count, i;
+    int32_t sum;
+    int16_t value;
+
+    /* Decode again if a sample was added meanwhile. */
+    do
+    {
+        start = sequence;
+
+        count = points->count;
+        value = points->base;
+        sum = 0;
+        for (i = 0; i < count; i++)
+        {
+            if (i > 0)
+            {
+                value += points->deltas[(points->first + i) % HISTORY_POINTS];
+            }
+            values[i] = value;
+            sum += value;
+
+            if (i == 0 || value < stats->min)
+            {
+                stats->min = value;
+            }
+            if (i == 0 || value > stats->max)
+            {
+                stats->max = value;
+            }
+        }
+    }
+    while ((start & 1) || start != sequence);
+
+    if (count)
+    {
+        stats->average = (int16_t)(sum / count);
+    }
+    return count;
+}
@@ -0,0 +1,62 @@
+/**
+ * History of the room temperature, kept in a fixed amount of RAM.
+ *
+ * The filtered samples of temp_service.c are averaged into three tiers of
+ * HISTORY_POINTS points each: one point per minute over the last hour, one
+ * per 24 minutes over the last day and one per 168 minutes over the last
+ * week. Each point is stored as the difference from the one before it in a
+ * signed byte, which covers 12.7 degrees between points. Adding a sample
+ * and reading a tier both take a bounded time.
+ */
+#ifndef __HISTORY_H__
+#define __HISTORY_H__
+
+#include <stdint.h>
+
+/* Points kept per tier, also the width of the sparkline in pixels. */
+#define HISTORY_POINTS 60
+
+/* Inputs averaged into one point: samples at 2 Hz into a minute for the hour
+ * tier, then points of the tier below for the day and week tiers. */
+#define HISTORY_HOUR_INPUTS 120
+#define HISTORY_DAY_INPUTS 24
+#define HISTORY_WEEK_INPUTS 7
+
+/**
+ * Defines the tiers.
+ */
+typedef enum
+{
+    HISTORY_HOUR, HISTORY_DAY, HISTORY_WEEK, HISTORY_TIERS
+} HistoryTier_t;
+
+/**
+ * Statistics of the points of a tier, in tenths of degree Celsius.
+ */
+typedef struct
+{
+    int16_t min;
+    int16_t max;
+    int16_t average;
+} HistoryStats_t;
+
+/**
+ * Empties every tier.
+ */
+void History_init(void);
+
+/**
+ * Adds a sample in tenths of degree Celsius. Called from the sampling
+ * interrupt, at most HISTORY_TIERS points are written.
+ */
+void History_add(int16_t sample);
+
+/**
+ * Decodes the points of a tier into values, oldest first, and fills stats
+ * when there are any. values must hold HISTORY_POINTS entries. Returns the
+ * number of points. Safe to call while History_add() can interrupt it.
+ */
+uint8_t History_getSeries(HistoryTier_t tier, int16_t *values,
+                          HistoryStats_t *stats);
+
+#endif
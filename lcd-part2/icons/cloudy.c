@@ -1,63 +1,32 @@
-/** Generated with JSFormer
-  * https://github.com/nununoisy/JSFormer
+/** Generated with rle4conv.py
   *
-  * Image name: image
-  * 24x24@4bpp (16 colors)
+  * Image name: cloudy
+  * 24x24@4bpp (4 colors), RLE4 compressed (70 bytes)
   */
 
 #include <ti/grlib/grlib.h>
 
-static const uint8_t pixel_image4BPP_UNCOMP[] = {
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x10,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x10,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,
-    0x10,0x00,0x00,0x00,0x00,0x00,0x01,0x00,
-    0x00,0x00,0x00,0x00,0x10,0x00,0x01,0x11,
-    0x10,0x00,0x10,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x01,0x11,0x11,0x11,0x10,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x11,0x11,0x11,
-    0x11,0x11,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x01,0x11,0x11,0x11,0x11,0x11,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x01,0x11,0x11,0x11,
-    0x11,0x11,0x10,0x00,0x00,0x00,0x00,0x00,
-    0x01,0x11,0x11,0x11,0x11,0x11,0x10,0x00,
-    0x00,0x00,0x00,0x22,0x22,0x23,0x11,0x11,
-    0x11,0x11,0x10,0x11,0x00,0x00,0x02,0x22,
-    0x22,0x22,0x21,0x11,0x11,0x11,0x10,0x00,
-    0x00,0x00,0x02,0x22,0x22,0x22,0x21,0x11,
-    0x11,0x11,0x00,0x00,0x00,0x00,0x22,0x22,
-    0x22,0x22,0x22,0x22,0x21,0x11,0x00,0x00,
-    0x00,0x00,0x22,0x22,0x22,0x22,0x22,0x22,
-    0x22,0x10,0x00,0x00,0x00,0x00,0x22,0x22,
-    0x22,0x22,0x22,0x22,0x22,0x20,0x00,0x00,
-    0x00,0x02,0x22,0x22,0x22,0x22,0x22,0x22,
-    0x22,0x22,0x22,0x00,0x00,0x22,0x22,0x22,
-    0x22,0x22,0x22,0x22,0x22,0x22,0x22,0x20,
-    0x02,0x22,0x22,0x22,0x22,0x22,0x22,0x22,
-    0x22,0x22,0x22,0x22,0x02,0x22,0x22,0x22,
-    0x22,0x22,0x22,0x22,0x22,0x22,0x22,0x22,
-    0x22,0x22,0x22,0x22,0x22,0x22,0x22,0x22,
-    0x22,0x22,0x22,0x22,0x02,0x22,0x22,0x22,
-    0x22,0x22,0x22,0x22,0x22,0x22,0x22,0x22,
-    0x02,0x22,0x22,0x22,0x22,0x22,0x22,0x22,
-    0x22,0x22,0x22,0x20,0x00,0x22,0x22,0x22,
-    0x22,0x22,0x22,0x22,0x22,0x22,0x22,0x00
+static const uint8_t pixel_image4BPP_COMP_RLE4[] = {
+    0xf0,0xf0,0x50,0x01,0xf0,0x60,0x01,0xf0,
+    0x11,0xb0,0x01,0x90,0x01,0x30,0x31,0x20,
+    0x01,0xd0,0x71,0xe0,0x91,0xc0,0xa1,0xc0,
+    0xb1,0xb0,0xb1,0x80,0x42,0x03,0x81,0x00,
+    0x11,0x40,0x72,0x71,0x70,0x72,0x61,0x70,
+    0xc2,0x21,0x70,0xd2,0x01,0x80,0xe2,0x70,
+    0xf2,0x22,0x30,0xf2,0x42,0x10,0xf2,0x62,
+    0x00,0xf2,0xf2,0xe2,0x00,0xf2,0x62,0x00,
+    0xf2,0x52,0x20,0xf2,0x32,0x10
 };
 
-static const uint32_t palette_image4BPP_UNCOMP[] = {
-    0x000000,0xfdd020,0xa3d4f7,0xc6d2a4,
-    0x000000,0x000000,0x000000,0x000000,
-    0x000000,0x000000,0x000000,0x000000,
-    0x000000,0x000000,0x000000,0x000000
+static const uint32_t palette_image4BPP_COMP_RLE4[] = {
+    0x000000,0xfdd020,0xa3d4f7,0xc6d2a4
 };
 
 const Graphics_Image cloudy = {
-    IMAGE_FMT_4BPP_UNCOMP,
+    IMAGE_FMT_4BPP_COMP_RLE4,
     24,
     24,
-    16,
-    palette_image4BPP_UNCOMP,
-    pixel_image4BPP_UNCOMP
+    4,
+    palette_image4BPP_COMP_RLE4,
+    pixel_image4BPP_COMP_RLE4
 };
@@ -1,63 +1,44 @@
-/** Generated with JSFormer
-  * https://github.com/nununoisy/JSFormer
+/** Generated with rle4conv.py
   *
-  * Image name: image
-  * 24x24@4bpp (16 colors)
+  * Image name: home
+  * 24x24@4bpp (9 colors), RLE4 compressed (149 bytes)
   */
 
 #include <ti/grlib/grlib.h>
 
-static const uint8_t pixel_image4BPP_UNCOMP[] = {
-    0x00,0x00,0x00,0x00,0x00,0x00,0x10,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x01,0x11,0x00,0x01,0x11,0x11,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x11,0x11,0x10,
-    0x01,0x11,0x11,0x00,0x00,0x00,0x00,0x00,
-    0x01,0x11,0x11,0x11,0x01,0x11,0x11,0x00,
-    0x00,0x00,0x00,0x00,0x11,0x11,0x21,0x11,
-    0x10,0x33,0x30,0x00,0x00,0x00,0x00,0x01,
-    0x11,0x12,0x22,0x11,0x11,0x33,0x30,0x00,
-    0x00,0x00,0x00,0x11,0x11,0x22,0x42,0x21,
-    0x11,0x13,0x30,0x00,0x00,0x00,0x01,0x11,
-    0x12,0x24,0x44,0x22,0x11,0x11,0x30,0x00,
-    0x00,0x00,0x11,0x11,0x22,0x44,0x44,0x42,
-    0x21,0x11,0x10,0x00,0x00,0x01,0x11,0x12,
-    0x24,0x44,0x44,0x44,0x22,0x11,0x11,0x00,
-    0x00,0x11,0x11,0x22,0x44,0x44,0x44,0x44,
-    0x42,0x21,0x11,0x10,0x01,0x11,0x12,0x24,
-    0x44,0x44,0x44,0x44,0x44,0x22,0x11,0x11,
-    0x11,0x11,0x22,0x44,0x44,0x44,0x44,0x44,
-    0x44,0x42,0x21,0x11,0x01,0x12,0x24,0x44,
-    0x44,0x44,0x44,0x44,0x44,0x44,0x22,0x11,
-    0x00,0x02,0x44,0x44,0x44,0x44,0x44,0x44,
-    0x44,0x44,0x42,0x00,0x00,0x04,0x44,0x44,
-    0x44,0x44,0x44,0x44,0x44,0x44,0x44,0x00,
-    0x00,0x04,0x44,0x55,0x55,0x44,0x66,0x66,
-    0x66,0x66,0x44,0x00,0x00,0x04,0x45,0x55,
-    0x55,0x44,0x67,0x77,0x67,0x76,0x44,0x00,
-    0x00,0x04,0x45,0x55,0x55,0x54,0x67,0x77,
-    0x67,0x76,0x44,0x00,0x00,0x04,0x45,0x55,
-    0x55,0x54,0x67,0x77,0x67,0x76,0x44,0x00,
-    0x00,0x04,0x45,0x55,0x55,0x54,0x67,0x77,
-    0x67,0x76,0x44,0x00,0x00,0x04,0x45,0x55,
-    0x55,0x54,0x67,0x77,0x67,0x76,0x44,0x00,
-    0x00,0x04,0x45,0x55,0x55,0x54,0x88,0x88,
-    0x88,0x88,0x44,0x00,0x00,0x04,0x45,0x55,
-    0x55,0x54,0x44,0x44,0x44,0x44,0x44,0x00
+static const uint8_t pixel_image4BPP_COMP_RLE4[] = {
+    0xb0,0x01,0xf0,0x50,0x21,0x20,0x41,0xb0,
+    0x41,0x10,0x41,0xa0,0x61,0x00,0x41,0x90,
+    0x31,0x02,0x31,0x00,0x23,0x90,0x31,0x22,
+    0x31,0x23,0x80,0x31,0x12,0x04,0x12,0x31,
+    0x13,0x70,0x31,0x12,0x24,0x12,0x31,0x03,
+    0x60,0x31,0x12,0x44,0x12,0x31,0x50,0x31,
+    0x12,0x64,0x12,0x31,0x30,0x31,0x12,0x84,
+    0x12,0x31,0x10,0x31,0x12,0xa4,0x12,0x71,
+    0x12,0xc4,0x12,0x21,0x00,0x11,0x12,0xe4,
+    0x12,0x11,0x20,0x02,0xf4,0x04,0x02,0x40,
+    0xf4,0x24,0x40,0x24,0x35,0x14,0x76,0x14,
+    0x40,0x14,0x45,0x14,0x06,0x27,0x06,0x17,
+    0x06,0x14,0x40,0x14,0x55,0x04,0x06,0x27,
+    0x06,0x17,0x06,0x14,0x40,0x14,0x55,0x04,
+    0x06,0x27,0x06,0x17,0x06,0x14,0x40,0x14,
+    0x55,0x04,0x06,0x27,0x06,0x17,0x06,0x14,
+    0x40,0x14,0x55,0x04,0x06,0x27,0x06,0x17,
+    0x06,0x14,0x40,0x14,0x55,0x04,0x78,0x14,
+    0x40,0x14,0x55,0xa4,0x10
 };
 
-static const uint32_t palette_image4BPP_UNCOMP[] = {
+static const uint32_t palette_image4BPP_COMP_RLE4[] = {
     0x000000,0xf3705a,0xf7b64c,0xf05540,
     0xffd15c,0x415a6b,0x344a5e,0x8ad7f8,
-    0xb9a25d,0x000000,0x000000,0x000000,
-    0x000000,0x000000,0x000000,0x000000
+    0xb9a25d
 };
 
 const Graphics_Image home = {
-    IMAGE_FMT_4BPP_UNCOMP,
+    IMAGE_FMT_4BPP_COMP_RLE4,
     24,
     24,
-    16,
-    palette_image4BPP_UNCOMP,
-    pixel_image4BPP_UNCOMP
+    9,
+    palette_image4BPP_COMP_RLE4,
+    pixel_image4BPP_COMP_RLE4
 };
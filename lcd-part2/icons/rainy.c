@@ -1,63 +1,32 @@
-/** Generated with JSFormer
-  * https://github.com/nununoisy/JSFormer
+/** Generated with rle4conv.py
   *
-  * Image name: image
-  * 24x24@4bpp (16 colors)
+  * Image name: rainy
+  * 24x24@4bpp (3 colors), RLE4 compressed (71 bytes)
   */
 
 #include <ti/grlib/grlib.h>
 
-static const uint8_t pixel_image4BPP_UNCOMP[] = {
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,
-    0x11,0x10,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x11,0x11,0x11,0x10,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x11,
-    0x11,0x11,0x11,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x11,0x11,0x11,0x11,0x11,0x11,
-    0x11,0x00,0x00,0x00,0x00,0x00,0x11,0x11,
-    0x11,0x11,0x11,0x11,0x11,0x00,0x00,0x00,
-    0x00,0x00,0x11,0x11,0x11,0x11,0x11,0x11,
-    0x11,0x10,0x00,0x00,0x00,0x00,0x11,0x11,
-    0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x00,
-    0x00,0x11,0x11,0x11,0x11,0x11,0x11,0x11,
-    0x11,0x11,0x11,0x11,0x01,0x11,0x11,0x11,
-    0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x11,
-    0x01,0x11,0x11,0x11,0x11,0x12,0x21,0x11,
-    0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x11,
-    0x11,0x12,0x21,0x11,0x11,0x11,0x11,0x11,
-    0x01,0x11,0x11,0x11,0x11,0x12,0x22,0x11,
-    0x11,0x11,0x11,0x11,0x01,0x11,0x11,0x11,
-    0x11,0x22,0x22,0x11,0x11,0x11,0x11,0x11,
-    0x01,0x11,0x11,0x11,0x11,0x12,0x21,0x11,
-    0x21,0x11,0x11,0x10,0x00,0x01,0x11,0x12,
-    0x21,0x11,0x11,0x12,0x21,0x11,0x11,0x00,
-    0x00,0x00,0x00,0x02,0x20,0x00,0x00,0x02,
-    0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x22,
-    0x20,0x00,0x00,0x02,0x22,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x22,0x22,0x00,0x00,0x02,
-    0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x02,
-    0x20,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00
+static const uint8_t pixel_image4BPP_COMP_RLE4[] = {
+    0xf0,0xf0,0xf0,0xf0,0xe0,0x31,0xf0,0x20,
+    0x61,0xf0,0x81,0xd0,0xd1,0x90,0xd1,0x90,
+    0xe1,0x80,0xf1,0x11,0x30,0xf1,0x51,0x00,
+    0xf1,0x61,0x00,0x91,0x12,0xf1,0x51,0x12,
+    0xa1,0x00,0x91,0x22,0x91,0x00,0x81,0x32,
+    0x91,0x00,0x91,0x12,0x21,0x02,0x51,0x30,
+    0x31,0x12,0x51,0x12,0x41,0x80,0x12,0x50,
+    0x22,0xb0,0x22,0x50,0x22,0xb0,0x32,0x40,
+    0x22,0xc0,0x12,0xf0,0xf0,0xf0,0xe0
 };
 
-static const uint32_t palette_image4BPP_UNCOMP[] = {
-    0x000000,0xd0dad9,0x60a2d7,0x000000,
-    0x000000,0x000000,0x000000,0x000000,
-    0x000000,0x000000,0x000000,0x000000,
-    0x000000,0x000000,0x000000,0x000000
+static const uint32_t palette_image4BPP_COMP_RLE4[] = {
+    0x000000,0xd0dad9,0x60a2d7
 };
 
 const Graphics_Image rainy = {
-    IMAGE_FMT_4BPP_UNCOMP,
+    IMAGE_FMT_4BPP_COMP_RLE4,
     24,
     24,
-    16,
-    palette_image4BPP_UNCOMP,
-    pixel_image4BPP_UNCOMP
+    3,
+    palette_image4BPP_COMP_RLE4,
+    pixel_image4BPP_COMP_RLE4
 };
@@ -1,63 +1,34 @@
-/** Generated with JSFormer
-  * https://github.com/nununoisy/JSFormer
+/** Generated with rle4conv.py
   *
-  * Image name: image
-  * 24x24@4bpp (16 colors)
+  * Image name: snowy
+  * 24x24@4bpp (6 colors), RLE4 compressed (75 bytes)
   */
 
 #include <ti/grlib/grlib.h>
 
-static const uint8_t pixel_image4BPP_UNCOMP[] = {
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,
-    0x11,0x10,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x11,0x11,0x11,0x10,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x11,
-    0x11,0x11,0x11,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x11,0x11,0x11,0x11,0x11,0x11,
-    0x12,0x00,0x00,0x00,0x00,0x00,0x11,0x11,
-    0x11,0x11,0x11,0x11,0x11,0x00,0x00,0x00,
-    0x00,0x00,0x11,0x11,0x11,0x11,0x11,0x11,
-    0x11,0x10,0x00,0x00,0x00,0x00,0x11,0x11,
-    0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x00,
-    0x00,0x11,0x11,0x11,0x11,0x11,0x11,0x11,
-    0x11,0x11,0x11,0x11,0x01,0x11,0x11,0x11,
-    0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x11,
-    0x01,0x11,0x11,0x11,0x11,0x11,0x11,0x11,
-    0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x11,
-    0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x11,
-    0x01,0x11,0x11,0x11,0x11,0x33,0x31,0x11,
-    0x11,0x11,0x11,0x11,0x01,0x11,0x11,0x11,
-    0x11,0x33,0x31,0x11,0x33,0x11,0x11,0x11,
-    0x01,0x11,0x11,0x11,0x11,0x33,0x31,0x13,
-    0x31,0x11,0x11,0x10,0x00,0x01,0x11,0x31,
-    0x13,0x11,0x11,0x43,0x35,0x11,0x11,0x00,
-    0x00,0x00,0x00,0x33,0x33,0x00,0x00,0x00,
-    0x33,0x00,0x00,0x00,0x00,0x00,0x00,0x03,
-    0x30,0x03,0x33,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x03,0x33,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x03,0x33,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00
+static const uint8_t pixel_image4BPP_COMP_RLE4[] = {
+    0xf0,0xf0,0xf0,0xf0,0xe0,0x31,0xf0,0x20,
+    0x61,0xf0,0x81,0xd0,0xc1,0x02,0x90,0xd1,
+    0x90,0xe1,0x80,0xf1,0x11,0x30,0xf1,0x51,
+    0x00,0xf1,0x61,0x00,0xf1,0xf1,0xe1,0x00,
+    0x81,0x23,0xa1,0x00,0x81,0x23,0x21,0x13,
+    0x51,0x00,0x81,0x23,0x11,0x13,0x51,0x30,
+    0x21,0x03,0x11,0x03,0x31,0x04,0x13,0x05,
+    0x31,0x70,0x33,0x50,0x13,0xc0,0x13,0x10,
+    0x23,0xf0,0x40,0x23,0xf0,0x40,0x23,0xf0,
+    0xf0,0xf0,0x90
 };
 
-static const uint32_t palette_image4BPP_UNCOMP[] = {
+static const uint32_t palette_image4BPP_COMP_RLE4[] = {
     0x000000,0xa3d4f7,0xaac6ff,0xb7f9fe,
-    0xa7dbf8,0xace5fa,0x000000,0x000000,
-    0x000000,0x000000,0x000000,0x000000,
-    0x000000,0x000000,0x000000,0x000000
+    0xa7dbf8,0xace5fa
 };
 
 const Graphics_Image snowy = {
-    IMAGE_FMT_4BPP_UNCOMP,
+    IMAGE_FMT_4BPP_COMP_RLE4,
     24,
     24,
-    16,
-    palette_image4BPP_UNCOMP,
-    pixel_image4BPP_UNCOMP
+    6,
+    palette_image4BPP_COMP_RLE4,
+    pixel_image4BPP_COMP_RLE4
 };
@@ -1,63 +1,33 @@
-/** Generated with JSFormer
-  * https://github.com/nununoisy/JSFormer
+/** Generated with rle4conv.py
   *
-  * Image name: image
-  * 24x24@4bpp (16 colors)
+  * Image name: sunny
+  * 24x24@4bpp (3 colors), RLE4 compressed (80 bytes)
   */
 
 #include <ti/grlib/grlib.h>
 
-static const uint8_t pixel_image4BPP_UNCOMP[] = {
-    0x00,0x00,0x00,0x00,0x00,0x00,0x10,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x10,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x10,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x10,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x10,0x00,0x00,0x00,0x20,0x00,
-    0x00,0x00,0x10,0x00,0x00,0x00,0x01,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x00,
-    0x00,0x00,0x00,0x10,0x01,0x11,0x11,0x11,
-    0x00,0x10,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x11,0x11,0x11,0x11,0x10,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x01,0x11,0x11,0x11,0x11,
-    0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x11,
-    0x11,0x11,0x11,0x11,0x11,0x10,0x00,0x00,
-    0x00,0x00,0x00,0x11,0x11,0x11,0x11,0x11,
-    0x11,0x10,0x00,0x00,0x00,0x00,0x00,0x11,
-    0x11,0x11,0x11,0x11,0x11,0x10,0x00,0x00,
-    0x11,0x11,0x20,0x11,0x11,0x11,0x11,0x11,
-    0x11,0x10,0x21,0x11,0x00,0x00,0x00,0x11,
-    0x11,0x11,0x11,0x11,0x11,0x10,0x00,0x00,
-    0x00,0x00,0x00,0x11,0x11,0x11,0x11,0x11,
-    0x11,0x10,0x00,0x00,0x00,0x00,0x00,0x11,
-    0x11,0x11,0x11,0x11,0x11,0x10,0x00,0x00,
-    0x00,0x00,0x00,0x01,0x11,0x11,0x11,0x11,
-    0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x11,0x11,0x11,0x11,0x10,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x10,0x01,0x11,0x11,0x11,
-    0x00,0x10,0x00,0x00,0x00,0x00,0x01,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x00,
-    0x00,0x00,0x10,0x00,0x00,0x00,0x20,0x00,
-    0x00,0x00,0x10,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x10,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x10,0x00,
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-    0x00,0x00,0x10,0x00,0x00,0x00,0x00,0x00
+static const uint8_t pixel_image4BPP_COMP_RLE4[] = {
+    0xb0,0x01,0xf0,0x60,0x01,0xf0,0x60,0x01,
+    0xf0,0x60,0x01,0xe0,0x01,0x60,0x02,0x60,
+    0x01,0x70,0x01,0xc0,0x01,0x90,0x01,0x10,
+    0x61,0x10,0x01,0xc0,0x81,0xd0,0xa1,0xb0,
+    0xc1,0xa0,0xc1,0xa0,0xc1,0x40,0x31,0x02,
+    0x00,0xc1,0x00,0x02,0x21,0x50,0xc1,0xa0,
+    0xc1,0xa0,0xc1,0xb0,0xa1,0xd0,0x81,0xc0,
+    0x01,0x10,0x61,0x10,0x01,0x90,0x01,0xc0,
+    0x01,0x70,0x01,0x60,0x02,0x60,0x01,0xe0,
+    0x01,0xf0,0x60,0x01,0xf0,0x60,0x01,0xa0
 };
 
-static const uint32_t palette_image4BPP_UNCOMP[] = {
-    0x000000,0xfdd020,0xffd21e,0x000000,
-    0x000000,0x000000,0x000000,0x000000,
-    0x000000,0x000000,0x000000,0x000000,
-    0x000000,0x000000,0x000000,0x000000
+static const uint32_t palette_image4BPP_COMP_RLE4[] = {
+    0x000000,0xfdd020,0xffd21e
 };
 
 const Graphics_Image sunny = {
-    IMAGE_FMT_4BPP_UNCOMP,
+    IMAGE_FMT_4BPP_COMP_RLE4,
     24,
     24,
-    16,
-    palette_image4BPP_UNCOMP,
-    pixel_image4BPP_UNCOMP
+    3,
+    palette_image4BPP_COMP_RLE4,
+    pixel_image4BPP_COMP_RLE4
 };
@@ -76,6 +76,9 @@ MEMORY
 /* --stack_size=512                                                          */
 /* --library=rtsv7M4_T_le_eabi.lib                                           */
 
+/* Free SRAM kept below the stack, checked when linking                      */
+#define SRAM_STACK_HEADROOM 0x1000
+
 /* Section allocation in memory */
 
 SECTIONS
@@ -124,7 +127,16 @@ SECTIONS
     .data   :   > SRAM_DATA
     .bss    :   > SRAM_DATA
     .sysmem :   > SRAM_DATA
-    .stack  :   > SRAM_DATA (HIGH)
+
+    /* The stack at the top of SRAM with SRAM_STACK_HEADROOM bytes kept free */
+    /* below it for it to grow into. The frame buffer of the LCD driver      */
+    /* takes half of the SRAM (see LCD_FRAMEBUFFER_ENABLE), so this makes    */
+    /* the link fail when .data and .bss leave less than that.               */
+    GROUP
+    {
+        .headroom : { . += SRAM_STACK_HEADROOM; }
+        .stack
+    } > SRAM_DATA (HIGH)
 
 #ifdef  __TI_COMPILER_VERSION__
 #if     __TI_COMPILER_VERSION__ >= 15009000
@@ -0,0 +1,240 @@
+//*****************************************************************************
+//
+// buttons_test.c - Checks the debounce and gestures of buttons.c.
+//
+// Feeds Buttons_tick() pin timelines one millisecond tick at a time, the way
+// the Timer_A interrupt does, and checks which events it queues and at which
+// tick, and when it lets the tick stop:
+//
+//   - contact bounce on press and release gives a single press,
+//   - a glitch shorter than BUTTONS_DEBOUNCE_MS gives nothing,
+//   - holding repeats after BUTTONS_LONG_PRESS_MS, faster and faster down to
+//     BUTTONS_REPEAT_MIN_MS, and stops on release,
+//   - the two buttons are debounced independently.
+//
+// Build and run from lcd-part2:
+//
+//   gcc -DLCD_SIM -Isim/include -Isim/grlib/include -I. -o buttons_test
+//       sim/buttons_test.c sim/msp432_sim.c buttons.c && ./buttons_test
+//
+//*****************************************************************************
+
+#ifdef LCD_SIM
+
+#include <string.h>
+#include "sim_test.h"
+#include "buttons.h"
+#include "event_queue.h"
+
+// Events recorded, with the tick they were queued at
+#define TEST_EVENTS_MAX 256
+
+typedef struct
+{
+    Event_t type;
+    uint32_t tick;
+} Test_Event;
+
+static Test_Event Test_events[TEST_EVENTS_MAX];
+static uint16_t Test_count;
+static uint32_t Test_tick;
+
+//
+// Stands in for event_queue.c, stamping events with the test tick.
+//
+bool EventQueue_push(Event_t type)
+{
+    if (Test_count < TEST_EVENTS_MAX)
+    {
+        Test_events[Test_count].type = type;
+        Test_events[Test_count].tick = Test_tick;
+        Test_count++;
+    }
+
+    return true;
+}
+
+static void Test_reset(void)
+{
+    Test_count = 0;
+}
+
+//
+// Runs ticks [from, to) with the given pins pressed. Returns the value of the
+// last Buttons_tick().
+//
+static bool Test_hold(uint32_t from, uint32_t to, uint8_t pressed)
+{
+    bool active = false;
+
+    for (Test_tick = from; Test_tick < to; Test_tick++)
+    {
+        active = Buttons_tick(pressed);
+    }
+
+    return active;
+}
+
+//
+// Runs ticks [from, to) alternating pressed and released, starting pressed.
+//
+static void Test_bounce(uint32_t from, uint32_t to, uint8_t pins)
+{
+    for (Test_tick = from; Test_tick < to; Test_tick++)
+    {
+        Buttons_tick(((Test_tick - from) & 1) ? 0 : pins);
+    }
+}
+
+//
+// Ticks until Buttons_tick() reports the buttons idle, at most limit ticks.
+// Returns the tick it did at.
+//
+static uint32_t Test_untilIdle(uint32_t from, uint32_t limit, uint8_t pressed)
+{
+    for (Test_tick = from; Test_tick < from + limit; Test_tick++)
+    {
+        if (!Buttons_tick(pressed))
+        {
+            return Test_tick;
+        }
+    }
+
+    return 0;
+}
+
+static void Test_bouncedPress(void)
+{
+    uint32_t idle;
+
+    Test_reset();
+
+    //
+    // Bounces for 4 ms, then stays down: the press counts on the tick the pin
+    // has been stable for BUTTONS_DEBOUNCE_MS.
+    //
+    Test_bounce(0, 4, BUTTONS_TOP);
+    SIM_TEST_CHECK(Test_hold(4, 300, BUTTONS_TOP));
+    SIM_TEST_EQUAL(Test_count, 1);
+    SIM_TEST_EQUAL(Test_events[0].type, BUTTON1_PRESSED);
+    SIM_TEST_EQUAL(Test_events[0].tick, 4 + BUTTONS_DEBOUNCE_MS - 1);
+
+    //
+    // Bounces on release, queues nothing more and goes idle once released
+    // for BUTTONS_DEBOUNCE_MS, counted from the last bounce at tick 303.
+    //
+    Test_bounce(300, 304, BUTTONS_TOP);
+    idle = Test_untilIdle(304, 100, 0);
+    SIM_TEST_EQUAL(Test_count, 1);
+    SIM_TEST_EQUAL(idle, 303 + BUTTONS_DEBOUNCE_MS - 1);
+}
+
+static void Test_glitch(void)
+{
+    Test_reset();
+
+    //
+    // One tick short of the debounce time: nothing, and idle right after.
+    //
+    Test_hold(0, BUTTONS_DEBOUNCE_MS - 1, BUTTONS_BOTTOM);
+    SIM_TEST_CHECK(!Test_hold(BUTTONS_DEBOUNCE_MS - 1, BUTTONS_DEBOUNCE_MS, 0));
+    SIM_TEST_EQUAL(Test_count, 0);
+}
+
+static void Test_repeat(void)
+{
+    uint32_t expected[TEST_EVENTS_MAX];
+    uint32_t press, release, tick;
+    uint16_t interval, count, i;
+
+    Test_reset();
+
+    //
+    // Held for 3 seconds.
+    //
+    press = BUTTONS_DEBOUNCE_MS - 1;
+    release = 3000;
+    SIM_TEST_CHECK(Test_hold(0, release, BUTTONS_TOP));
+    SIM_TEST_CHECK(Test_untilIdle(release, 100, 0) != 0);
+
+    //
+    // The press, then a repeat BUTTONS_LONG_PRESS_MS later, each following
+    // one a quarter sooner than the previous down to BUTTONS_REPEAT_MIN_MS.
+    //
+    count = 0;
+    expected[count++] = press;
+    tick = press + BUTTONS_LONG_PRESS_MS;
+    interval = BUTTONS_REPEAT_START_MS;
+    while (tick < release)
+    {
+        expected[count++] = tick;
+        tick += interval;
+        interval -= interval / 4;
+        if (interval < BUTTONS_REPEAT_MIN_MS)
+        {
+            interval = BUTTONS_REPEAT_MIN_MS;
+        }
+    }
+
+    SIM_TEST_EQUAL(Test_count, count);
+    SIM_TEST_EQUAL(Test_events[0].type, BUTTON1_PRESSED);
+    for (i = 0; (i < count) && (i < Test_count); i++)
+    {
+        SIM_TEST_EQUAL(Test_events[i].tick, expected[i]);
+        if (i > 0)
+        {
+            SIM_TEST_EQUAL(Test_events[i].type, BUTTON1_REPEATED);
+        }
+    }
+
+    //
+    // First gaps as documented in buttons.h, and the rate settles at the
+    // minimum.
+    //
+    SIM_TEST_EQUAL(Test_events[1].tick - Test_events[0].tick,
+                   BUTTONS_LONG_PRESS_MS);
+    SIM_TEST_EQUAL(Test_events[2].tick - Test_events[1].tick,
+                   BUTTONS_REPEAT_START_MS);
+    SIM_TEST_EQUAL(Test_events[Test_count - 1].tick -
+                   Test_events[Test_count - 2].tick, BUTTONS_REPEAT_MIN_MS);
+}
+
+static void Test_independent(void)
+{
+    uint16_t i;
+    uint8_t top = 0, bottom = 0;
+
+    Test_reset();
+
+    //
+    // Bottom pressed while top bounces, then both held briefly.
+    //
+    Test_hold(0, 10, BUTTONS_BOTTOM);
+    Test_bounce(10, 14, BUTTONS_TOP);
+    Test_hold(14, 100, BUTTONS_TOP | BUTTONS_BOTTOM);
+    SIM_TEST_CHECK(Test_untilIdle(100, 100, 0) != 0);
+
+    for (i = 0; i < Test_count; i++)
+    {
+        top += (Test_events[i].type == BUTTON1_PRESSED);
+        bottom += (Test_events[i].type == BUTTON2_PRESSED);
+    }
+    SIM_TEST_EQUAL(Test_count, 2);
+    SIM_TEST_EQUAL(top, 1);
+    SIM_TEST_EQUAL(bottom, 1);
+    SIM_TEST_EQUAL(Test_events[0].type, BUTTON2_PRESSED);
+    SIM_TEST_EQUAL(Test_events[0].tick, BUTTONS_DEBOUNCE_MS - 1);
+    SIM_TEST_EQUAL(Test_events[1].tick, 14 + BUTTONS_DEBOUNCE_MS - 1);
+}
+
+int main(void)
+{
+    Test_bouncedPress();
+    Test_glitch();
+    Test_repeat();
+    Test_independent();
+
+    return Sim_Test_report("buttons_test");
+}
+
+#endif /* LCD_SIM */
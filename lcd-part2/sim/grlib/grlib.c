@@ -0,0 +1,380 @@
+//*****************************************************************************
+//
+// grlib.c - Host stand-in for the part of the TI Graphics Library in use.
+//
+// Lets the LCD simulator build without the SimpleLink MSP432P4 SDK, see
+// lcd_sim.h.  Every drawing call ends in the same display driver callbacks
+// grlib would make, clipped to the context, so the driver, its frame buffer
+// and the transfer queue see the usual traffic.
+//
+// This is not grlib.  Glyphs of g_sFontFixed6x8 are made up from a hash of
+// the character (5x7 inside the 6x8 cell, like the real font), so text has
+// the right size and position but not the right pixels, and how many runs a
+// line of text breaks into differs from the SDK.  PPM images and byte counts
+// taken with it are close to, not equal to, those of a build against the
+// SDK sources.
+//
+//*****************************************************************************
+
+#ifdef LCD_SIM
+
+#include <string.h>
+#include <ti/grlib/grlib.h>
+
+// Font cell and the part of it glyphs are drawn into
+#define FONT_CELL_WIDTH     6
+#define FONT_CELL_HEIGHT    8
+#define FONT_GLYPH_WIDTH    5
+#define FONT_GLYPH_HEIGHT   7
+
+const Graphics_Font g_sFontFixed6x8 =
+{
+    0, FONT_CELL_WIDTH, FONT_CELL_HEIGHT, FONT_GLYPH_HEIGHT, { 0 }, 0
+};
+
+//*****************************************************************************
+//
+// Returns 1 if the pixel at col, row of the glyph for character c is set.
+//
+//*****************************************************************************
+static int Font_glyphBit(uint8_t c, int16_t col, int16_t row)
+{
+    uint32_t hash;
+
+    if ((c <= ' ') || (c > '~') || (col >= FONT_GLYPH_WIDTH) ||
+        (row >= FONT_GLYPH_HEIGHT))
+    {
+        return 0;
+    }
+
+    hash = (c * 2654435761u) ^ (col * 40503u) ^ (row * 9176u);
+    hash ^= hash >> 13;
+    hash *= 0x5BD1E995u;
+    hash ^= hash >> 15;
+
+    return hash & 1;
+}
+
+static int32_t String_length(int8_t *string, int32_t length)
+{
+    return (length < 0) ? (int32_t)strlen((const char *)string) : length;
+}
+
+//*****************************************************************************
+//
+// Draws a horizontal line of color value, clipped to the context.
+//
+//*****************************************************************************
+static void Context_lineH(const Graphics_Context *context, int32_t x1,
+                          int32_t x2, int32_t y, uint32_t value)
+{
+    const Graphics_Rectangle *clip = &context->clipRegion;
+
+    if (x1 > x2)
+    {
+        int32_t swap = x1;
+        x1 = x2;
+        x2 = swap;
+    }
+
+    if ((y < clip->sYMin) || (y > clip->sYMax))
+    {
+        return;
+    }
+
+    if (x1 < clip->sXMin)
+    {
+        x1 = clip->sXMin;
+    }
+
+    if (x2 > clip->sXMax)
+    {
+        x2 = clip->sXMax;
+    }
+
+    if (x1 > x2)
+    {
+        return;
+    }
+
+    if (x1 == x2)
+    {
+        context->displayFuncs->pfnPixelDraw(context->display, x1, y, value);
+    }
+    else
+    {
+        context->displayFuncs->pfnLineDrawH(context->display, x1, x2, y,
+                                            value);
+    }
+}
+
+void Graphics_initContext(Graphics_Context *context,
+                          Graphics_Display *display,
+                          const Graphics_Display_Functions *displayFuncs)
+{
+    memset(context, 0, sizeof(*context));
+    context->size = sizeof(*context);
+    context->display = display;
+    context->displayFuncs = displayFuncs;
+    context->clipRegion.sXMax = display->width - 1;
+    context->clipRegion.sYMax = display->heigth - 1;
+}
+
+void Graphics_setForegroundColor(Graphics_Context *context, uint32_t value)
+{
+    context->foreground =
+        context->displayFuncs->pfnColorTranslate(context->display, value);
+}
+
+void Graphics_setBackgroundColor(Graphics_Context *context, uint32_t value)
+{
+    context->background =
+        context->displayFuncs->pfnColorTranslate(context->display, value);
+}
+
+void Graphics_setForegroundColorTranslated(Graphics_Context *context,
+                                           uint32_t value)
+{
+    context->foreground = value;
+}
+
+void Graphics_setBackgroundColorTranslated(Graphics_Context *context,
+                                           uint32_t value)
+{
+    context->background = value;
+}
+
+void Graphics_setFont(Graphics_Context *context, const Graphics_Font *font)
+{
+    context->font = font;
+}
+
+void GrContextFontSet(Graphics_Context *context, const Graphics_Font *font)
+{
+    context->font = font;
+}
+
+void Graphics_clearDisplay(const Graphics_Context *context)
+{
+    context->displayFuncs->pfnClearDisplay(context->display,
+                                           context->background);
+}
+
+void Graphics_flushBuffer(const Graphics_Context *context)
+{
+    context->displayFuncs->pfnFlush(context->display);
+}
+
+int32_t Graphics_getStringWidth(const Graphics_Context *context,
+                                int8_t *string, int32_t length)
+{
+    return String_length(string, length) * context->font->maxWidth;
+}
+
+//*****************************************************************************
+//
+// Draws the string one glyph row at a time, one line callback per run of
+// equal pixels, leaving background pixels alone unless opaque is set.
+//
+//*****************************************************************************
+void Graphics_drawString(const Graphics_Context *context, int8_t *string,
+                         int32_t length, int32_t x, int32_t y, bool opaque)
+{
+    int32_t i;
+    int16_t row;
+    int16_t col;
+    int16_t end;
+    int bit;
+
+    length = String_length(string, length);
+
+    for (i = 0; i < length; i++)
+    {
+        uint8_t c = (uint8_t)string[i];
+
+        for (row = 0; row < FONT_CELL_HEIGHT; row++)
+        {
+            for (col = 0; col < FONT_CELL_WIDTH; col = end + 1)
+            {
+                bit = Font_glyphBit(c, col, row);
+                end = col;
+
+                while ((end + 1 < FONT_CELL_WIDTH) &&
+                       (Font_glyphBit(c, end + 1, row) == bit))
+                {
+                    end++;
+                }
+
+                if (bit || opaque)
+                {
+                    Context_lineH(context,
+                                  x + i * FONT_CELL_WIDTH + col,
+                                  x + i * FONT_CELL_WIDTH + end,
+                                  y + row,
+                                  bit ? context->foreground :
+                                        context->background);
+                }
+            }
+        }
+    }
+}
+
+void Graphics_drawStringCentered(const Graphics_Context *context,
+                                 int8_t *string, int32_t length, int32_t x,
+                                 int32_t y, bool opaque)
+{
+    Graphics_drawString(context, string, length,
+                        x - Graphics_getStringWidth(context, string,
+                                                    length) / 2,
+                        y - context->font->baseline / 2, opaque);
+}
+
+//*****************************************************************************
+//
+// Draws 4bpp images, uncompressed or RLE4, one row at a time through
+// pfnPixelDrawMultiple.  Rows are not clipped; the icons always fit.
+//
+//*****************************************************************************
+void Graphics_drawImage(const Graphics_Context *context,
+                        const Graphics_Image *image, int16_t x, int16_t y)
+{
+    uint32_t palette[16];
+    uint8_t line[256];
+    uint8_t packed[128];
+    const uint8_t *data = image->pPixel;
+    int32_t total = image->xSize * image->ySize;
+    int32_t done = 0;
+    int16_t column = 0;
+    int16_t row = 0;
+    uint16_t i;
+
+    if ((image->numColors > 16) || (image->xSize > sizeof(line)))
+    {
+        return;
+    }
+
+    for (i = 0; i < image->numColors; i++)
+    {
+        palette[i] = context->displayFuncs->pfnColorTranslate(
+                         context->display, image->pPalette[i]);
+    }
+
+    if (image->bPP == IMAGE_FMT_4BPP_UNCOMP)
+    {
+        for (row = 0; row < image->ySize; row++)
+        {
+            context->displayFuncs->pfnPixelDrawMultiple(
+                context->display, x, y + row, 0, image->xSize, 4,
+                data + row * ((image->xSize + 1) / 2), palette);
+        }
+    }
+    else if (image->bPP == IMAGE_FMT_4BPP_COMP_RLE4)
+    {
+        //
+        // Runs carry on from the end of one row to the next
+        //
+        while (done < total)
+        {
+            int16_t run = (*data >> 4) + 1;
+            uint8_t index = *data & 0x0F;
+
+            data++;
+
+            while (run-- && (done < total))
+            {
+                line[column++] = index;
+                done++;
+
+                if (column == image->xSize)
+                {
+                    for (i = 0; i < column; i += 2)
+                    {
+                        packed[i / 2] = (line[i] << 4) |
+                                        ((i + 1 < column) ? line[i + 1] : 0);
+                    }
+
+                    context->displayFuncs->pfnPixelDrawMultiple(
+                        context->display, x, y + row, 0, column, 4, packed,
+                        palette);
+                    column = 0;
+                    row++;
+                }
+            }
+        }
+    }
+}
+
+void Graphics_drawLineH(const Graphics_Context *context, int32_t x1,
+                        int32_t x2, int32_t y)
+{
+    Context_lineH(context, x1, x2, y, context->foreground);
+}
+
+void Graphics_drawLineV(const Graphics_Context *context, int32_t x,
+                        int32_t y1, int32_t y2)
+{
+    const Graphics_Rectangle *clip = &context->clipRegion;
+
+    if (y1 > y2)
+    {
+        int32_t swap = y1;
+        y1 = y2;
+        y2 = swap;
+    }
+
+    if ((x < clip->sXMin) || (x > clip->sXMax))
+    {
+        return;
+    }
+
+    if (y1 < clip->sYMin)
+    {
+        y1 = clip->sYMin;
+    }
+
+    if (y2 > clip->sYMax)
+    {
+        y2 = clip->sYMax;
+    }
+
+    if (y1 <= y2)
+    {
+        context->displayFuncs->pfnLineDrawV(context->display, x, y1, y2,
+                                            context->foreground);
+    }
+}
+
+void Graphics_fillRectangle(const Graphics_Context *context,
+                            const Graphics_Rectangle *rect)
+{
+    const Graphics_Rectangle *clip = &context->clipRegion;
+    Graphics_Rectangle fill = *rect;
+
+    if (fill.sXMin < clip->sXMin)
+    {
+        fill.sXMin = clip->sXMin;
+    }
+
+    if (fill.sYMin < clip->sYMin)
+    {
+        fill.sYMin = clip->sYMin;
+    }
+
+    if (fill.sXMax > clip->sXMax)
+    {
+        fill.sXMax = clip->sXMax;
+    }
+
+    if (fill.sYMax > clip->sYMax)
+    {
+        fill.sYMax = clip->sYMax;
+    }
+
+    if ((fill.sXMin <= fill.sXMax) && (fill.sYMin <= fill.sYMax))
+    {
+        context->displayFuncs->pfnRectFill(context->display, &fill,
+                                           context->foreground);
+    }
+}
+
+#endif /* LCD_SIM */
@@ -0,0 +1,150 @@
+//*****************************************************************************
+//
+// grlib.h - Host stand-in for the part of the TI Graphics Library in use.
+//
+// Only used by the LCD simulator in sim/ when the SimpleLink MSP432P4 SDK is
+// not at hand, see lcd_sim.h.  The types, constants and prototypes match the
+// SDK header for what the LCD driver, display.c and the benches use, so the
+// same sources build against either.  sim/grlib/grlib.c implements the
+// functions.
+//
+// Output drawn through the stand-in is NOT pixel exact: g_sFontFixed6x8 has
+// the geometry of the real font but made up glyphs, and lines, rectangles and
+// images are drawn the simple way.  Byte counts and timings measured with it
+// are estimates.
+//
+//*****************************************************************************
+
+#ifndef __SIM_GRLIB_H__
+#define __SIM_GRLIB_H__
+
+// Only defined by the stand-in, for the checks that need the SDK output
+#define SIM_GRLIB_STANDIN
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+    int16_t sXMin;
+    int16_t sYMin;
+    int16_t sXMax;
+    int16_t sYMax;
+} Graphics_Rectangle;
+
+typedef struct
+{
+    int32_t size;
+    void *displayData;
+    uint16_t width;
+    uint16_t heigth;
+} Graphics_Display;
+
+typedef struct
+{
+    void (*pfnPixelDraw)(const Graphics_Display *pDisplay, int16_t lX,
+                         int16_t lY, uint16_t ulValue);
+    void (*pfnPixelDrawMultiple)(const Graphics_Display *pDisplay, int16_t lX,
+                                 int16_t lY, int16_t lX0, int16_t lCount,
+                                 int16_t lBPP, const uint8_t *pucData,
+                                 const uint32_t *pucPalette);
+    void (*pfnLineDrawH)(const Graphics_Display *pDisplay, int16_t lX1,
+                         int16_t lX2, int16_t lY, uint16_t ulValue);
+    void (*pfnLineDrawV)(const Graphics_Display *pDisplay, int16_t lX,
+                         int16_t lY1, int16_t lY2, uint16_t ulValue);
+    void (*pfnRectFill)(const Graphics_Display *pDisplay,
+                        const Graphics_Rectangle *pRect, uint16_t ulValue);
+    uint32_t (*pfnColorTranslate)(const Graphics_Display *pDisplay,
+                                  uint32_t ulValue);
+    void (*pfnFlush)(const Graphics_Display *pDisplay);
+    void (*pfnClearDisplay)(const Graphics_Display *pDisplay,
+                            uint16_t ulValue);
+} Graphics_Display_Functions;
+
+typedef struct
+{
+    uint8_t format;
+    uint8_t maxWidth;
+    uint8_t height;
+    uint8_t baseline;
+    uint16_t offset[96];
+    const uint8_t *data;
+} Graphics_Font;
+
+typedef struct
+{
+    int32_t size;
+    const Graphics_Display *display;
+    const Graphics_Display_Functions *displayFuncs;
+    Graphics_Rectangle clipRegion;
+    uint32_t foreground;
+    uint32_t background;
+    const Graphics_Font *font;
+} Graphics_Context;
+
+typedef struct
+{
+    uint8_t bPP;
+    uint16_t xSize;
+    uint16_t ySize;
+    uint16_t numColors;
+    const uint32_t *pPalette;
+    const uint8_t *pPixel;
+} Graphics_Image;
+
+#define IMAGE_FMT_1BPP_UNCOMP       0x01
+#define IMAGE_FMT_4BPP_UNCOMP       0x04
+#define IMAGE_FMT_8BPP_UNCOMP       0x08
+#define IMAGE_FMT_4BPP_COMP_RLE4    0x44
+
+#define AUTO_STRING_LENGTH          -1
+#define OPAQUE_TEXT                 1
+#define TRANSPARENT_TEXT            0
+
+#define GRAPHICS_COLOR_WHITE        0x00FFFFFF
+#define GRAPHICS_COLOR_BLACK        0x00000000
+#define GRAPHICS_COLOR_YELLOW       0x00FFFF00
+#define GRAPHICS_COLOR_CYAN         0x0000FFFF
+#define GRAPHICS_COLOR_GRAY         0x00808080
+#define GRAPHICS_COLOR_DARK_GRAY    0x00404040
+#define GRAPHICS_COLOR_RED          0x00FF0000
+#define GRAPHICS_COLOR_BLUE         0x000000FF
+
+extern const Graphics_Font g_sFontFixed6x8;
+
+extern void Graphics_initContext(Graphics_Context *context,
+                                 Graphics_Display *display,
+                                 const Graphics_Display_Functions *displayFuncs);
+extern void Graphics_setForegroundColor(Graphics_Context *context,
+                                        uint32_t value);
+extern void Graphics_setBackgroundColor(Graphics_Context *context,
+                                        uint32_t value);
+extern void Graphics_setForegroundColorTranslated(Graphics_Context *context,
+                                                  uint32_t value);
+extern void Graphics_setBackgroundColorTranslated(Graphics_Context *context,
+                                                  uint32_t value);
+extern void Graphics_setFont(Graphics_Context *context,
+                             const Graphics_Font *font);
+extern void GrContextFontSet(Graphics_Context *context,
+                             const Graphics_Font *font);
+extern void Graphics_clearDisplay(const Graphics_Context *context);
+extern void Graphics_flushBuffer(const Graphics_Context *context);
+extern int32_t Graphics_getStringWidth(const Graphics_Context *context,
+                                       int8_t *string, int32_t length);
+extern void Graphics_drawString(const Graphics_Context *context,
+                                int8_t *string, int32_t length, int32_t x,
+                                int32_t y, bool opaque);
+extern void Graphics_drawStringCentered(const Graphics_Context *context,
+                                        int8_t *string, int32_t length,
+                                        int32_t x, int32_t y, bool opaque);
+extern void Graphics_drawImage(const Graphics_Context *context,
+                               const Graphics_Image *image, int16_t x,
+                               int16_t y);
+extern void Graphics_drawLineH(const Graphics_Context *context, int32_t x1,
+                               int32_t x2, int32_t y);
+extern void Graphics_drawLineV(const Graphics_Context *context, int32_t x,
+                               int32_t y1, int32_t y2);
+extern void Graphics_fillRectangle(const Graphics_Context *context,
+                                   const Graphics_Rectangle *rect);
+
+#endif /* __SIM_GRLIB_H__ */
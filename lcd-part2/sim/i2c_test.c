@@ -0,0 +1,559 @@
+//*****************************************************************************
+//
+// i2c_test.c - Runs the interrupt driven I2C master of HAL_I2C.c against a
+// simulated slave.
+//
+// The test plays the EUSCI_B1 peripheral and a slave at address 0x40 with a
+// byte addressed memory: the first byte written sets the pointer, further
+// bytes are written or read from there on.  Each step of the bus sets the
+// flags the peripheral would, and EUSCIB1_IRQHandler() is called whenever an
+// enabled flag is up and interrupts are not masked.  Every transfer leaves a
+// trace of the bus conditions, compared with the expected one:
+//
+//   S / Sr     start / repeated start
+//   40W 40R    address and direction, N appended when not acknowledged
+//   FE         data byte, N appended when the master did not acknowledge it
+//   P          stop
+//
+// It checks reads of 1 and 3 bytes, which must NACK exactly the last byte,
+// register writes and reads through I2C_write16() and I2C_read16(), a slave
+// that does not answer, and the queue.  A transfer that never stops fails
+// the test instead of hanging it.
+//
+// Build and run from lcd-part2:
+//
+//   gcc -DLCD_SIM -Wall -Wextra -Isim/include -I. -o i2c_test sim/i2c_test.c
+//       sim/msp432_sim.c HAL/HAL_I2C.c && ./i2c_test
+//
+//*****************************************************************************
+
+#ifdef LCD_SIM
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "sim_test.h"
+#include "HAL/HAL_I2C.h"
+
+extern void EUSCIB1_IRQHandler(void);
+
+// Address the simulated slave answers to
+#define BUS_ADDRESS         0x40
+
+// Steps after which a transfer that has not completed is stuck
+#define BUS_STEPS_MAX       1000
+
+// Bytes after which a read that is not stopped has run away, the buffers of
+// the transactions hold that many so that a runaway does not overflow them
+#define BUS_READ_MAX        4
+
+// Marks TXBUF as not written by the interrupt handler
+#define BUS_TXBUF_EMPTY     0xFFFF
+
+typedef enum
+{
+    BUS_IDLE,
+    BUS_WRITE,
+    BUS_READ,
+    BUS_NACKED
+} Bus_Phase;
+
+// Slave memory and pointer
+static uint8_t Bus_memory[256];
+static uint8_t Bus_pointer;
+
+// State of the bus
+static Bus_Phase Bus_phase;
+static uint8_t Bus_written;
+static uint8_t Bus_read;
+static bool Bus_txPending;
+static uint8_t Bus_tx;
+
+static char Bus_trace[512];
+
+// Interrupt masks of the CPU
+static bool Test_masterDisabled;
+static bool Test_i2cDisabled;
+static bool Test_inInterrupt;
+
+// Left when the bus gets stuck or a read runs away
+static jmp_buf Test_stuck;
+
+//
+// Appends a condition to the trace.
+//
+static void Bus_log(const char *format, ...)
+{
+    size_t length = strlen(Bus_trace);
+    va_list args;
+
+    if ((length > 0) && (length < sizeof(Bus_trace) - 1))
+    {
+        Bus_trace[length++] = ' ';
+        Bus_trace[length] = '\0';
+    }
+
+    va_start(args, format);
+    vsnprintf(Bus_trace + length, sizeof(Bus_trace) - length, format, args);
+    va_end(args);
+}
+
+static void Bus_reset(void)
+{
+    Bus_phase = BUS_IDLE;
+    Bus_txPending = false;
+    Bus_trace[0] = '\0';
+}
+
+//
+// Start condition and address, once UCTXSTT is set.
+//
+static void Bus_start(void)
+{
+    bool write = (Sim_UCB1CTLW0 & UCTR) != 0;
+
+    Sim_UCB1CTLW0 &= ~UCTXSTT;
+    UCB1IFG &= ~UCTXIFG0;
+
+    Bus_log((Bus_phase == BUS_IDLE) ? "S" : "Sr");
+    if (UCB1I2CSA != BUS_ADDRESS)
+    {
+        Bus_log("%02X%cN", UCB1I2CSA, write ? 'W' : 'R');
+        UCB1IFG |= UCNACKIFG;
+        Bus_phase = BUS_NACKED;
+    }
+    else if (write)
+    {
+        Bus_log("%02XW", UCB1I2CSA);
+        Bus_written = 0;
+        UCB1IFG |= UCTXIFG0;
+        Bus_phase = BUS_WRITE;
+    }
+    else
+    {
+        Bus_log("%02XR", UCB1I2CSA);
+        Bus_read = 0;
+        Bus_phase = BUS_READ;
+    }
+}
+
+static void Bus_stop(void)
+{
+    Sim_UCB1CTLW0 &= ~UCTXSTP;
+    UCB1IFG &= ~UCTXIFG0;
+    UCB1IFG |= UCSTPIFG;
+
+    Bus_log("P");
+    Bus_phase = BUS_IDLE;
+}
+
+//
+// Moves the bus one byte or condition forward. Returns false when it waits
+// for the master.
+//
+static bool Bus_step(void)
+{
+    if (Bus_txPending)
+    {
+        // Byte from TXBUF, the pointer first
+        Bus_txPending = false;
+        Bus_log("%02X", Bus_tx);
+        if (Bus_written++ == 0)
+        {
+            Bus_pointer = Bus_tx;
+        }
+        else
+        {
+            Bus_memory[Bus_pointer++] = Bus_tx;
+        }
+        UCB1IFG |= UCTXIFG0;
+        return true;
+    }
+
+    if (Sim_UCB1CTLW0 & UCTXSTT)
+    {
+        Bus_start();
+        return true;
+    }
+
+    if (Bus_phase == BUS_READ)
+    {
+        // Next byte once RXBUF has been read, the last one with UCTXSTP set
+        if (UCB1IFG & UCRXIFG0)
+        {
+            return false;
+        }
+        if (Bus_read++ == BUS_READ_MAX)
+        {
+            longjmp(Test_stuck, 1);
+        }
+        UCB1RXBUF = Bus_memory[Bus_pointer++];
+        UCB1IFG |= UCRXIFG0;
+        if (Sim_UCB1CTLW0 & UCTXSTP)
+        {
+            Bus_log("%02XN", UCB1RXBUF);
+            Bus_stop();
+        }
+        else
+        {
+            Bus_log("%02X", UCB1RXBUF);
+        }
+        return true;
+    }
+
+    if (Sim_UCB1CTLW0 & UCTXSTP)
+    {
+        Bus_stop();
+        return true;
+    }
+
+    return false;
+}
+
+//
+// The start condition completes while the interrupt handler polls UCTXSTT.
+//
+volatile uint16_t *Sim_UCB1CTLW0_access(void)
+{
+    if (Sim_UCB1CTLW0 & UCTXSTT)
+    {
+        Bus_start();
+    }
+
+    return &Sim_UCB1CTLW0;
+}
+
+//
+// Takes the EUSCI_B1 interrupt if it is pending and not masked. Writing
+// TXBUF clears UCTXIFG0 and reading RXBUF clears UCRXIFG0, the handler
+// reads RXBUF when neither a NACK nor a TX request comes first.
+//
+static bool Test_interrupt(void)
+{
+    uint16_t status = UCB1IFG & UCB1IE;
+    bool received;
+
+    if (!status || Test_masterDisabled || Test_i2cDisabled || Test_inInterrupt)
+    {
+        return false;
+    }
+
+    received = !(status & (UCNACKIFG | UCTXIFG0)) && (status & UCRXIFG0);
+    UCB1TXBUF = BUS_TXBUF_EMPTY;
+
+    Test_inInterrupt = true;
+    EUSCIB1_IRQHandler();
+    Test_inInterrupt = false;
+
+    if (UCB1TXBUF != BUS_TXBUF_EMPTY)
+    {
+        Bus_tx = (uint8_t)UCB1TXBUF;
+        Bus_txPending = true;
+        UCB1IFG &= ~UCTXIFG0;
+    }
+    if (received)
+    {
+        UCB1IFG &= ~UCRXIFG0;
+    }
+
+    return true;
+}
+
+//
+// Runs the bus and the interrupt until the queue is empty or nothing moves.
+//
+static bool Test_run(void)
+{
+    uint16_t steps;
+
+    for (steps = 0; (steps < BUS_STEPS_MAX) && !I2C_isIdle(); steps++)
+    {
+        if (!Test_interrupt() && !Bus_step())
+        {
+            break;
+        }
+    }
+
+    return I2C_isIdle();
+}
+
+//
+// CPU side of the driverlib stand-in, as I2C_submit() and I2C_wait() use it.
+//
+void Interrupt_enableInterrupt(uint32_t interruptNumber)
+{
+    if (interruptNumber == INT_EUSCIB1)
+    {
+        Test_i2cDisabled = false;
+        while (Test_interrupt())
+        {
+        }
+    }
+}
+
+void Interrupt_disableInterrupt(uint32_t interruptNumber)
+{
+    if (interruptNumber == INT_EUSCIB1)
+    {
+        Test_i2cDisabled = true;
+    }
+}
+
+bool Interrupt_enableMaster(void)
+{
+    bool disabled = Test_masterDisabled;
+
+    Test_masterDisabled = false;
+    while (Test_interrupt())
+    {
+    }
+
+    return disabled;
+}
+
+bool Interrupt_disableMaster(void)
+{
+    bool disabled = Test_masterDisabled;
+
+    Test_masterDisabled = true;
+
+    return disabled;
+}
+
+//
+// Sleeps while the bus runs, until an interrupt is pending.
+//
+bool PCM_gotoLPM0(void)
+{
+    uint16_t steps;
+
+    for (steps = 0; steps < BUS_STEPS_MAX; steps++)
+    {
+        if (UCB1IFG & UCB1IE)
+        {
+            return true;
+        }
+        if (!Bus_step())
+        {
+            break;
+        }
+    }
+
+    longjmp(Test_stuck, 1);
+}
+
+//
+// Completed transactions, in order.
+//
+static I2C_Transaction *Test_completed[I2C_QUEUE_SIZE];
+static uint8_t Test_completions;
+
+static void Test_callback(I2C_Transaction *transaction)
+{
+    if (Test_completions < I2C_QUEUE_SIZE)
+    {
+        Test_completed[Test_completions] = transaction;
+    }
+    Test_completions++;
+}
+
+static void Test_reset(void)
+{
+    Bus_reset();
+    Test_completions = 0;
+}
+
+static void Test_registers(void)
+{
+    Test_reset();
+    I2C_setslave(BUS_ADDRESS);
+
+    //
+    // Pointer, then MSB first.
+    //
+    I2C_write16(0x02, 0x7200);
+    SIM_TEST_CHECK(strcmp(Bus_trace, "S 40W 02 72 00 P") == 0);
+    SIM_TEST_EQUAL(Bus_memory[0x02], 0x72);
+    SIM_TEST_EQUAL(Bus_memory[0x03], 0x00);
+
+    //
+    // Pointer, repeated start, two bytes with the second one NACKed.
+    //
+    Bus_reset();
+    Bus_memory[0xFE] = 0x54;
+    Bus_memory[0xFF] = 0x49;
+    SIM_TEST_EQUAL(I2C_read16(0xFE), 0x5449);
+    SIM_TEST_CHECK(strcmp(Bus_trace, "S 40W FE Sr 40R 54 49N P") == 0);
+
+    //
+    // Read back, sign extended.
+    //
+    Bus_reset();
+    I2C_write16(0x10, 0xFF38);
+    SIM_TEST_EQUAL(I2C_read16(0x10), -200);
+    SIM_TEST_CHECK(strcmp(Bus_trace, "S 40W 10 FF 38 P S 40W 10 Sr 40R FF 38N P")
+                   == 0);
+}
+
+static void Test_lengths(void)
+{
+    uint8_t one[BUS_READ_MAX], three[BUS_READ_MAX];
+    uint8_t byte = 0xAB;
+    I2C_Transaction readOne = { .slave = BUS_ADDRESS, .reg = 0x20,
+                                .read = true, .length = 1, .data = one };
+    I2C_Transaction readThree = { .slave = BUS_ADDRESS, .reg = 0x20,
+                                  .read = true, .length = 3, .data = three };
+    I2C_Transaction writeOne = { .slave = BUS_ADDRESS, .reg = 0x22,
+                                 .read = false, .length = 1, .data = &byte };
+
+    Test_reset();
+    Bus_memory[0x20] = 0x01;
+    Bus_memory[0x21] = 0x02;
+    Bus_memory[0x22] = 0x03;
+
+    //
+    // A single byte gets UCTXSTP as soon as its address is out.
+    //
+    SIM_TEST_CHECK(I2C_submit(&readOne));
+    SIM_TEST_CHECK(Test_run());
+    SIM_TEST_EQUAL(readOne.status, I2C_DONE);
+    SIM_TEST_EQUAL(one[0], 0x01);
+    SIM_TEST_CHECK(strcmp(Bus_trace, "S 40W 20 Sr 40R 01N P") == 0);
+
+    //
+    // Three bytes get UCTXSTP once the second one is in.
+    //
+    Bus_reset();
+    SIM_TEST_CHECK(I2C_submit(&readThree));
+    SIM_TEST_CHECK(Test_run());
+    SIM_TEST_EQUAL(readThree.status, I2C_DONE);
+    SIM_TEST_EQUAL(three[0], 0x01);
+    SIM_TEST_EQUAL(three[1], 0x02);
+    SIM_TEST_EQUAL(three[2], 0x03);
+    SIM_TEST_CHECK(strcmp(Bus_trace, "S 40W 20 Sr 40R 01 02 03N P") == 0);
+
+    Bus_reset();
+    SIM_TEST_CHECK(I2C_submit(&writeOne));
+    SIM_TEST_CHECK(Test_run());
+    SIM_TEST_EQUAL(writeOne.status, I2C_DONE);
+    SIM_TEST_EQUAL(Bus_memory[0x22], 0xAB);
+    SIM_TEST_CHECK(strcmp(Bus_trace, "S 40W 22 AB P") == 0);
+}
+
+static void Test_nack(void)
+{
+    uint8_t id[BUS_READ_MAX], absent[BUS_READ_MAX] = { 0x5A, 0x5A };
+    uint8_t config[2] = { 0x12, 0x34 };
+    I2C_Transaction first = { .slave = BUS_ADDRESS, .reg = 0xFE,
+                              .read = true, .length = 2, .data = id,
+                              .status = I2C_DONE, .callback = Test_callback };
+    I2C_Transaction missing = { .slave = BUS_ADDRESS + 1, .reg = 0xFE,
+                                .read = true, .length = 2, .data = absent,
+                                .status = I2C_DONE,
+                                .callback = Test_callback };
+    I2C_Transaction last = { .slave = BUS_ADDRESS, .reg = 0x02,
+                             .read = false, .length = 2, .data = config,
+                             .status = I2C_DONE, .callback = Test_callback };
+
+    Test_reset();
+
+    //
+    // The transaction to the absent slave stops after its address, and the
+    // queue goes on with the next one.
+    //
+    SIM_TEST_CHECK(I2C_submit(&first));
+    SIM_TEST_CHECK(I2C_submit(&missing));
+    SIM_TEST_CHECK(I2C_submit(&last));
+    SIM_TEST_CHECK(Test_run());
+
+    SIM_TEST_EQUAL(first.status, I2C_DONE);
+    SIM_TEST_EQUAL(missing.status, I2C_NACK);
+    SIM_TEST_EQUAL(last.status, I2C_DONE);
+    SIM_TEST_EQUAL(absent[0], 0x5A);
+    SIM_TEST_EQUAL(absent[1], 0x5A);
+    SIM_TEST_EQUAL(id[0], 0x54);
+    SIM_TEST_EQUAL(id[1], 0x49);
+    SIM_TEST_EQUAL(Bus_memory[0x03], 0x34);
+    SIM_TEST_CHECK(strcmp(Bus_trace, "S 40W FE Sr 40R 54 49N P S 41WN P "
+                                     "S 40W 02 12 34 P") == 0);
+
+    SIM_TEST_EQUAL(Test_completions, 3);
+    SIM_TEST_CHECK(Test_completed[0] == &first);
+    SIM_TEST_CHECK(Test_completed[1] == &missing);
+    SIM_TEST_CHECK(Test_completed[2] == &last);
+}
+
+static void Test_queue(void)
+{
+    uint8_t data[I2C_QUEUE_SIZE][BUS_READ_MAX];
+    I2C_Transaction transactions[I2C_QUEUE_SIZE];
+    uint8_t i;
+
+    Test_reset();
+
+    //
+    // The ring holds one transaction less than its size.
+    //
+    for (i = 0; i < I2C_QUEUE_SIZE; i++)
+    {
+        I2C_Transaction transaction = { .slave = BUS_ADDRESS,
+                                        .reg = (uint8_t)(2 * i),
+                                        .read = true, .length = 2,
+                                        .data = data[i], .status = I2C_DONE,
+                                        .callback = Test_callback };
+
+        transactions[i] = transaction;
+        Bus_memory[2 * i] = i;
+        Bus_memory[2 * i + 1] = 0x80 | i;
+    }
+    for (i = 0; i < I2C_QUEUE_SIZE - 1; i++)
+    {
+        SIM_TEST_CHECK(I2C_submit(&transactions[i]));
+    }
+    SIM_TEST_CHECK(!I2C_submit(&transactions[I2C_QUEUE_SIZE - 1]));
+
+    SIM_TEST_CHECK(Test_run());
+    SIM_TEST_EQUAL(Test_completions, I2C_QUEUE_SIZE - 1);
+    for (i = 0; i < I2C_QUEUE_SIZE - 1; i++)
+    {
+        SIM_TEST_CHECK(Test_completed[i] == &transactions[i]);
+        SIM_TEST_EQUAL(transactions[i].status, I2C_DONE);
+        SIM_TEST_EQUAL(data[i][0], i);
+        SIM_TEST_EQUAL(data[i][1], 0x80 | i);
+    }
+
+    //
+    // And takes new ones once emptied.
+    //
+    SIM_TEST_CHECK(I2C_submit(&transactions[I2C_QUEUE_SIZE - 1]));
+    SIM_TEST_CHECK(Test_run());
+    SIM_TEST_EQUAL(transactions[I2C_QUEUE_SIZE - 1].status, I2C_DONE);
+}
+
+int main(void)
+{
+    I2C_init();
+
+    if (setjmp(Test_stuck))
+    {
+        printf("bus stuck, trace: %s\n", Bus_trace);
+        return 1;
+    }
+
+    //
+    // I2C_read16() reads into a buffer of its own, of 2 bytes, only let it
+    // once reads are known to stop at the right length.
+    //
+    Test_lengths();
+    if (Sim_Test_failures == 0)
+    {
+        Test_registers();
+    }
+    Test_nack();
+    Test_queue();
+
+    return Sim_Test_report("i2c_test");
+}
+
+#endif /* LCD_SIM */
@@ -0,0 +1,227 @@
+//*****************************************************************************
+//
+// driverlib.h - Host stand-in for the MSP432 driverlib header.
+//
+// Only used by the LCD simulator and the host tests in sim/.  The LCD driver
+// and the pages in display.c do not touch the hardware themselves, all they
+// need from the real header are the standard integer and boolean types.  The
+// HAL functions they call are provided by sim/lcd_sim.c.
+//
+// The buttons, the temperature service, the I2C HAL and the LCD HAL do call
+// driverlib.  The part of it they use is declared below, with the same names,
+// types and values as the SDK, and sim/msp432_sim.c implements it as
+// functions that do nothing, which a test can replace with its own.  The one
+// difference is SPI_getTransmitBufferAddressForDMA(), which returns a host
+// pointer wide enough for the address of a variable.
+//
+//*****************************************************************************
+
+#ifndef __SIM_DRIVERLIB_H__
+#define __SIM_DRIVERLIB_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <ti/devices/msp432p4xx/inc/msp.h>
+
+//
+// GPIO
+//
+#define GPIO_PORT_P1                    1
+#define GPIO_PORT_P3                    3
+#define GPIO_PORT_P5                    5
+#define GPIO_PORT_P6                    6
+
+#define GPIO_PIN0                       0x0001
+#define GPIO_PIN1                       0x0002
+#define GPIO_PIN4                       0x0010
+#define GPIO_PIN5                       0x0020
+#define GPIO_PIN6                       0x0040
+#define GPIO_PIN7                       0x0080
+
+#define GPIO_PRIMARY_MODULE_FUNCTION    0x01
+#define GPIO_LOW_TO_HIGH_TRANSITION     0x00
+#define GPIO_HIGH_TO_LOW_TRANSITION     0x01
+#define GPIO_INPUT_PIN_HIGH             0x01
+#define GPIO_INPUT_PIN_LOW              0x00
+
+extern void GPIO_setAsPeripheralModuleFunctionOutputPin(uint_fast8_t selectedPort,
+                                                        uint_fast16_t selectedPins,
+                                                        uint_fast8_t mode);
+extern void GPIO_setAsInputPinWithPullUpResistor(uint_fast8_t selectedPort,
+                                                 uint_fast16_t selectedPins);
+extern uint8_t GPIO_getInputPinValue(uint_fast8_t selectedPort,
+                                     uint_fast16_t selectedPins);
+extern void GPIO_interruptEdgeSelect(uint_fast8_t selectedPort,
+                                     uint_fast16_t selectedPins,
+                                     uint_fast8_t edgeSelect);
+extern void GPIO_clearInterruptFlag(uint_fast8_t selectedPort,
+                                    uint_fast16_t selectedPins);
+extern void GPIO_enableInterrupt(uint_fast8_t selectedPort,
+                                 uint_fast16_t selectedPins);
+extern void GPIO_disableInterrupt(uint_fast8_t selectedPort,
+                                  uint_fast16_t selectedPins);
+extern uint_fast16_t GPIO_getEnabledInterruptStatus(uint_fast8_t selectedPort);
+extern void GPIO_setAsOutputPin(uint_fast8_t selectedPort,
+                                uint_fast16_t selectedPins);
+extern void GPIO_setOutputHighOnPin(uint_fast8_t selectedPort,
+                                    uint_fast16_t selectedPins);
+extern void GPIO_setOutputLowOnPin(uint_fast8_t selectedPort,
+                                   uint_fast16_t selectedPins);
+
+//
+// Interrupt controller and power
+//
+#define INT_TA0_0                       24
+#define INT_TA1_0                       26
+#define INT_T32_INT2                    42
+#define INT_EUSCIB1                     37
+#define INT_DMA_INT1                    49
+#define INT_PORT3                       53
+#define INT_PORT5                       55
+
+extern bool Interrupt_enableMaster(void);
+extern bool Interrupt_disableMaster(void);
+extern void Interrupt_enableInterrupt(uint32_t interruptNumber);
+extern void Interrupt_disableInterrupt(uint32_t interruptNumber);
+extern bool PCM_gotoLPM0(void);
+
+//
+// Timer32
+//
+#define TIMER32_0_BASE                  0x4000C000
+#define TIMER32_1_BASE                  0x4000C020
+#define TIMER32_PRESCALER_1             0x00
+#define TIMER32_32BIT                   0x02
+#define TIMER32_FREE_RUN_MODE           0x00
+#define TIMER32_PERIODIC_MODE           0x40
+
+extern void Timer32_initModule(uint32_t timer, uint32_t preScaler,
+                               uint32_t resolution, uint32_t mode);
+extern void Timer32_setCount(uint32_t timer, uint32_t count);
+extern void Timer32_startTimer(uint32_t timer, bool oneShot);
+extern uint32_t Timer32_getValue(uint32_t timer);
+extern void Timer32_enableInterrupt(uint32_t timer);
+extern void Timer32_clearInterruptFlag(uint32_t timer);
+
+//
+// Timer_A
+//
+#define TIMER_A0_BASE                           0x40000000
+#define TIMER_A1_BASE                           0x40000400
+#define TIMER_A_CLOCKSOURCE_ACLK                0x0100
+#define TIMER_A_CLOCKSOURCE_DIVIDER_1           0x01
+#define TIMER_A_TAIE_INTERRUPT_DISABLE          0x00
+#define TIMER_A_CCIE_CCR0_INTERRUPT_ENABLE      0x10
+#define TIMER_A_DO_CLEAR                        0x04
+#define TIMER_A_UP_MODE                         0x10
+#define TIMER_A_CAPTURECOMPARE_REGISTER_0       0x02
+
+typedef struct
+{
+    uint_fast16_t clockSource;
+    uint_fast16_t clockSourceDivider;
+    uint_fast16_t timerPeriod;
+    uint_fast16_t timerInterruptEnable_TAIE;
+    uint_fast16_t captureCompareInterruptEnable_CCR0_CCIE;
+    uint_fast16_t timerClear;
+} Timer_A_UpModeConfig;
+
+extern void Timer_A_configureUpMode(uint32_t timer,
+                                    const Timer_A_UpModeConfig *config);
+extern void Timer_A_startCounter(uint32_t timer, uint_fast16_t timerMode);
+extern void Timer_A_stopTimer(uint32_t timer);
+extern void Timer_A_clearCaptureCompareInterrupt(uint32_t timer,
+                                                 uint_fast16_t captureCompareRegister);
+
+//
+// eUSCI_B in I2C mode
+//
+#define EUSCI_B1_BASE                       0x40002400
+#define EUSCI_B_I2C_CLOCKSOURCE_SMCLK       0x0080
+#define EUSCI_B_I2C_SET_DATA_RATE_400KBPS   400000
+#define EUSCI_B_I2C_NO_AUTO_STOP            0x0000
+
+typedef struct
+{
+    uint_fast16_t selectClockSource;
+    uint32_t i2cClk;
+    uint32_t dataRate;
+    uint_fast8_t byteCounterThreshold;
+    uint_fast16_t autoSTOPGeneration;
+} eUSCI_I2C_MasterConfig;
+
+extern void I2C_initMaster(uint32_t moduleInstance,
+                           const eUSCI_I2C_MasterConfig *config);
+extern void I2C_enableModule(uint32_t moduleInstance);
+extern void I2C_disableModule(uint32_t moduleInstance);
+
+//
+// eUSCI_B in SPI mode
+//
+#define EUSCI_B0_BASE                                           0x40002000
+#define EUSCI_B_SPI_CLOCKSOURCE_SMCLK                           0x0080
+#define EUSCI_B_SPI_MSB_FIRST                                   0x2000
+#define EUSCI_B_SPI_PHASE_DATA_CAPTURED_ONFIRST_CHANGED_ON_NEXT 0x8000
+#define EUSCI_B_SPI_CLOCKPOLARITY_INACTIVITY_LOW                0x0000
+#define EUSCI_B_SPI_3PIN                                        0x0000
+
+typedef struct
+{
+    uint_fast8_t selectClockSource;
+    uint32_t clockSourceFrequency;
+    uint32_t desiredSpiClock;
+    uint_fast16_t msbFirst;
+    uint_fast16_t clockPhase;
+    uint_fast16_t clockPolarity;
+    uint_fast16_t spiMode;
+} eUSCI_SPI_MasterConfig;
+
+extern bool SPI_initMaster(uint32_t moduleInstance,
+                           const eUSCI_SPI_MasterConfig *config);
+extern void SPI_enableModule(uint32_t moduleInstance);
+extern uintptr_t SPI_getTransmitBufferAddressForDMA(uint32_t moduleInstance);
+
+//
+// uDMA
+//
+#define DMA_CHANNEL_0                   0
+#define DMA_CH0_EUSCIB0TX0              0x00000000
+#define DMA_INT1                        INT_DMA_INT1
+
+#define UDMA_PRI_SELECT                 0x00000000
+#define UDMA_ALT_SELECT                 0x00000008
+#define UDMA_ATTR_USEBURST              0x00000001
+#define UDMA_ATTR_ALTSELECT             0x00000002
+#define UDMA_ATTR_HIGH_PRIORITY         0x00000004
+#define UDMA_ATTR_REQMASK               0x00000008
+#define UDMA_MODE_BASIC                 0x00000001
+#define UDMA_SIZE_8                     0x00000000
+#define UDMA_SRC_INC_8                  0x00000000
+#define UDMA_SRC_INC_NONE               0x0C000000
+#define UDMA_DST_INC_NONE               0xC0000000
+#define UDMA_ARB_1                      0x00000000
+
+typedef struct
+{
+    volatile void *srcEndAddr;
+    volatile void *dstEndAddr;
+    volatile uint32_t control;
+    volatile uint32_t spare;
+} DMA_ControlTable;
+
+extern void DMA_enableModule(void);
+extern void DMA_setControlBase(void *controlTable);
+extern void DMA_assignChannel(uint32_t mapping);
+extern void DMA_disableChannelAttribute(uint32_t channelNum, uint32_t attr);
+extern void DMA_assignInterrupt(uint32_t interruptNumber, uint32_t channel);
+extern void DMA_enableInterrupt(uint32_t interruptNumber);
+extern void DMA_clearInterruptFlag(uint32_t intChannel);
+extern void DMA_setChannelControl(uint32_t channelStructIndex,
+                                  uint32_t control);
+extern void DMA_setChannelTransfer(uint32_t channelStructIndex, uint32_t mode,
+                                   void *srcAddr, void *dstAddr,
+                                   uint32_t transferSize);
+extern void DMA_enableChannel(uint32_t channelNum);
+extern bool DMA_isChannelEnabled(uint32_t channelNum);
+
+#endif /* __SIM_DRIVERLIB_H__ */
@@ -0,0 +1,89 @@
+//*****************************************************************************
+//
+// msp.h - Host stand-in for the MSP432 register header.
+//
+// Only used by the host tests in sim/.  The EUSCI_B1 registers the I2C HAL
+// drives are plain variables defined in sim/msp432_sim.c, which a test
+// reads and writes to play the part of the peripheral.  UCB1CTLW0 is reached
+// through Sim_UCB1CTLW0_access(), which a test can replace to complete a
+// start condition while HAL_I2C.c polls UCTXSTT.  The EUSCI_B0 status and
+// flag registers the LCD HAL polls are reached the same way, through
+// Sim_UCB0STATW_access() and Sim_UCB0IFG_access(), so a test can shift out
+// what was written to UCB0TXBUF when the CPU waits for it.  The cycle
+// counter of the DWT never runs by itself, a test moves DWT->CYCCNT to stand
+// for the time spent in the code it calls.  Bit values are the ones of the
+// MSP432P401R.
+//
+//*****************************************************************************
+
+#ifndef __SIM_MSP_H__
+#define __SIM_MSP_H__
+
+#include <stdint.h>
+
+extern volatile uint16_t Sim_UCB1CTLW0;
+extern volatile uint16_t *Sim_UCB1CTLW0_access(void);
+#define UCB1CTLW0   (*Sim_UCB1CTLW0_access())
+
+extern volatile uint16_t UCB1STATW;
+extern volatile uint16_t UCB1I2CSA;
+extern volatile uint16_t UCB1TXBUF;
+extern volatile uint16_t UCB1RXBUF;
+extern volatile uint16_t UCB1IE;
+extern volatile uint16_t UCB1IFG;
+
+extern volatile uint16_t Sim_UCB0STATW;
+extern volatile uint16_t *Sim_UCB0STATW_access(void);
+#define UCB0STATW   (*Sim_UCB0STATW_access())
+
+extern volatile uint16_t Sim_UCB0IFG;
+extern volatile uint16_t *Sim_UCB0IFG_access(void);
+#define UCB0IFG     (*Sim_UCB0IFG_access())
+
+extern volatile uint16_t UCB0TXBUF;
+
+// UCBxCTLW0
+#define UCTR        0x0010
+#define UCTXSTP     0x0004
+#define UCTXSTT     0x0002
+
+// UCBxSTATW, I2C and SPI
+#define UCBBUSY     0x0010
+#define UCBUSY      0x0001
+
+// UCBxIE and UCBxIFG
+#define UCNACKIE    0x0020
+#define UCSTPIE     0x0008
+#define UCTXIE0     0x0002
+#define UCRXIE0     0x0001
+#define UCNACKIFG   0x0020
+#define UCSTPIFG    0x0008
+#define UCTXIFG0    0x0002
+#define UCRXIFG0    0x0001
+
+// UCBxIFG in SPI mode
+#define UCTXIFG     0x0002
+
+// Debug and trace registers of the core, only the ones the cycle count uses
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} Sim_DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} Sim_CoreDebug_Type;
+
+extern Sim_DWT_Type Sim_DWT;
+extern Sim_CoreDebug_Type Sim_CoreDebug;
+#define DWT         (&Sim_DWT)
+#define CoreDebug   (&Sim_CoreDebug)
+
+#define DWT_CTRL_CYCCNTENA_Msk          0x00000001
+#define CoreDebug_DEMCR_TRCENA_Msk      0x01000000
+
+#define __DMB()     __sync_synchronize()
+
+#endif /* __SIM_MSP_H__ */
@@ -0,0 +1,437 @@
+//*****************************************************************************
+//
+// lcd_bench.c - Renders every page of the application on the virtual panel.
+//
+// Usage: lcd_bench [output folder [reference folder]]
+//
+// Draws the room temperature page and each city page in turn, the way the
+// buttons walk through them, and prints per page the bytes sent to the
+// controller, the time they take on the wire at LCD_SPI_CLOCK_SPEED and the
+// number of draw calls: driver callbacks made by grlib plus calls display.c
+// makes to the drawing functions of the driver.  With an output folder, what
+// the panel shows after each page is saved there as page<N>.ppm.  With a
+// reference folder too, each page must also match the page<N>.ppm there
+// pixel for pixel, or lcd_bench fails.  Reference images are the output of
+// a known good build; the comparison only runs in the SDK build, see
+// lcd_sim.h.
+//
+// A full display_weather() frame, and a display_temp() one, are then drawn
+// with and without LCD_WINDOW_ELISION, to show the command and data bytes
+// saved by not sending the address window again.  Build with
+// -DLCD_FRAMEBUFFER_ENABLE=0 to measure them when drawing straight to the
+// panel.
+//
+// Strings per second are then timed on the host, drawn with
+// Crystalfontz128x128_DrawString() from the glyph cache and with
+// Graphics_drawString() through the driver callbacks, one pixel run at a
+// time.
+//
+// It then reports the memory taken by each City_t and the host time spent
+// picking a weather icon, by table lookup and by comparing the condition
+// text the way cities used to be stored.
+//
+// See lcd_sim.h for how to build it.
+//
+//*****************************************************************************
+
+#ifdef LCD_SIM
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "lcd_sim.h"
+#include "LcdDriver/Crystalfontz128x128_ST7735.h"
+#include "temp_service.h"
+#include "history.h"
+#include <math.h>
+#include "weather.h"
+
+// Fixed room temperature, in tenths of degree Celsius
+#define BENCH_ROOM_TEMPERATURE  225
+
+// Swing of the room temperature recorded before drawing, in tenths
+#define BENCH_ROOM_SWING        15
+
+// Icon selections timed per method
+#define BENCH_SELECTIONS        10000000
+
+// Strings drawn per text path, and the string: a city page line
+#define BENCH_STRINGS           100000
+#define BENCH_STRING            "Humidity: 91%"
+
+extern Graphics_Context g_sContext;
+
+City_t cities[MAX_CITIES];
+uint16_t city_count = 0;
+
+// Pages that did not match their reference image
+static uint16_t Bench_mismatches;
+
+int16_t TempService_getTemperature(void)
+{
+    return BENCH_ROOM_TEMPERATURE;
+}
+
+//
+// Drawing functions of the driver, counted as draw calls when display.c
+// calls them.  They are linked with --wrap, see lcd_sim.h.
+//
+extern void __real_Crystalfontz128x128_DrawString(const Graphics_Context *context,
+                                                  const int8_t *string,
+                                                  int32_t length, int32_t x,
+                                                  int32_t y, bool opaque);
+extern void __real_Crystalfontz128x128_DrawStringCentered(const Graphics_Context *context,
+                                                          const int8_t *string,
+                                                          int32_t length,
+                                                          int32_t x, int32_t y,
+                                                          bool opaque);
+extern void __real_Crystalfontz128x128_DrawImage(const Graphics_Context *context,
+                                                 const Graphics_Image *image,
+                                                 int16_t x, int16_t y);
+extern void __real_Crystalfontz128x128_DrawSparkline(const Graphics_Context *context,
+                                                     const int16_t *values,
+                                                     uint16_t count, int16_t x,
+                                                     int16_t y, uint16_t height,
+                                                     int16_t min, int16_t max);
+
+void __wrap_Crystalfontz128x128_DrawString(const Graphics_Context *context,
+                                           const int8_t *string,
+                                           int32_t length, int32_t x,
+                                           int32_t y, bool opaque)
+{
+    Sim_LCD_stats.drawCalls++;
+    __real_Crystalfontz128x128_DrawString(context, string, length, x, y,
+                                          opaque);
+}
+
+void __wrap_Crystalfontz128x128_DrawStringCentered(const Graphics_Context *context,
+                                                   const int8_t *string,
+                                                   int32_t length, int32_t x,
+                                                   int32_t y, bool opaque)
+{
+    Sim_LCD_stats.drawCalls++;
+    __real_Crystalfontz128x128_DrawStringCentered(context, string, length, x,
+                                                  y, opaque);
+}
+
+void __wrap_Crystalfontz128x128_DrawImage(const Graphics_Context *context,
+                                          const Graphics_Image *image,
+                                          int16_t x, int16_t y)
+{
+    Sim_LCD_stats.drawCalls++;
+    __real_Crystalfontz128x128_DrawImage(context, image, x, y);
+}
+
+void __wrap_Crystalfontz128x128_DrawSparkline(const Graphics_Context *context,
+                                              const int16_t *values,
+                                              uint16_t count, int16_t x,
+                                              int16_t y, uint16_t height,
+                                              int16_t min, int16_t max)
+{
+    Sim_LCD_stats.drawCalls++;
+    __real_Crystalfontz128x128_DrawSparkline(context, values, count, x, y,
+                                             height, min, max);
+}
+
+//
+// Same data as _load_data() in main.c.
+//
+static void Bench_loadData(void)
+{
+    strcpy(cities[0].name, "ROME");
+    cities[0].temperature = 173;
+    cities[0].weather = WEATHER_PARTLY_CLOUDY;
+    cities[0].humidity = 63;
+
+    strcpy(cities[1].name, "MOSCOW");
+    cities[1].temperature = -51;
+    cities[1].weather = WEATHER_SNOWY;
+    cities[1].humidity = 50;
+
+    strcpy(cities[2].name, "TOKYO");
+    cities[2].temperature = 125;
+    cities[2].weather = WEATHER_SUNNY;
+    cities[2].humidity = 70;
+
+    strcpy(cities[3].name, "NEW YORK");
+    cities[3].temperature = 63;
+    cities[3].weather = WEATHER_RAINY;
+    cities[3].humidity = 91;
+
+    city_count = 4;
+}
+
+static void Bench_page(uint16_t page, const char *folder,
+                       const char *reference)
+{
+    char path[256];
+    int32_t differences;
+
+    Sim_LCD_resetStats();
+    if (page_state(page) == STATE_TEMP)
+    {
+        display_temp();
+    }
+    else
+    {
+        display_weather(page);
+    }
+
+    //
+    // Every frame of a transition, as the frame timer ticks.
+    //
+    while (Crystalfontz128x128_CarouselStep())
+    {
+    }
+
+    printf("%4d %10lu %10lu %8lu %8lu %10lu %10lu\n", page,
+           (unsigned long)Sim_LCD_stats.commandBytes,
+           (unsigned long)Sim_LCD_stats.dataBytes,
+           (unsigned long)Sim_LCD_stats.windows,
+           (unsigned long)Sim_LCD_stats.pixels,
+           (unsigned long)Sim_LCD_stats.drawCalls,
+           (unsigned long)Sim_LCD_wireTime());
+
+    if (folder)
+    {
+        snprintf(path, sizeof(path), "%s/page%d.ppm", folder, page);
+        if (Sim_LCD_writePPM(path))
+        {
+            printf("could not write %s\n", path);
+        }
+    }
+
+    if (reference)
+    {
+        snprintf(path, sizeof(path), "%s/page%d.ppm", reference, page);
+        differences = Sim_LCD_comparePPM(path);
+        if (differences < 0)
+        {
+            printf("could not read %s\n", path);
+            Bench_mismatches++;
+        }
+        else if (differences > 0)
+        {
+            printf("%ld pixels differ from %s\n", (long)differences, path);
+            Bench_mismatches++;
+        }
+    }
+}
+
+//
+// Bytes of a full display_weather() frame of the first city, drawn over the
+// room page, and of a display_temp() frame drawn over it, with and without
+// the window elision of the driver.
+//
+static void Bench_elision(void)
+{
+    uint8_t frame, elision;
+
+    printf("frame                     cmd bytes data bytes  windows   wire (us)\n");
+    for (frame = 0; frame < 2; frame++)
+    {
+        for (elision = 1; elision <= 2; elision++)
+        {
+            Sim_LCD_windowElision = (elision == 1);
+
+            if (frame == 0)
+            {
+                display_temp();
+                Sim_LCD_resetStats();
+                display_weather(1);
+            }
+            else
+            {
+                display_weather(1);
+                Sim_LCD_resetStats();
+                display_temp();
+            }
+
+            printf("%-12s %-12s %10lu %10lu %8lu %10lu\n",
+                   (frame == 0) ? "weather" : "temp",
+                   Sim_LCD_windowElision ? "elision" : "no elision",
+                   (unsigned long)Sim_LCD_stats.commandBytes,
+                   (unsigned long)Sim_LCD_stats.dataBytes,
+                   (unsigned long)Sim_LCD_stats.windows,
+                   (unsigned long)Sim_LCD_wireTime());
+        }
+    }
+    Sim_LCD_windowElision = 1;
+}
+
+//
+// Icon selection as done before City_t held a Weather_t: one strcmp() per
+// condition until the text matches.
+//
+static const Graphics_Image *Bench_iconByName(const char *weather_type)
+{
+    uint8_t weather;
+
+    for (weather = 0; weather < WEATHER_NUM; weather++)
+    {
+        if (strcmp(weather_type, weather_names[weather]) == 0)
+        {
+            return weather_icons[weather];
+        }
+    }
+    return 0;
+}
+
+static double Bench_seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+//
+// Host time drawing the same opaque string with the glyph cache and through
+// grlib, on a context with the plain driver callbacks so neither is counted.
+//
+static void Bench_strings(void)
+{
+    Graphics_Context context;
+    double start, cached, uncached;
+    uint32_t i;
+
+    Graphics_initContext(&context, &g_sCrystalfontz128x128,
+                         &g_sCrystalfontz128x128_funcs);
+    Graphics_setForegroundColor(&context, GRAPHICS_COLOR_WHITE);
+    Graphics_setBackgroundColor(&context, GRAPHICS_COLOR_BLACK);
+    GrContextFontSet(&context, &g_sFontFixed6x8);
+
+    start = Bench_seconds();
+    for (i = 0; i < BENCH_STRINGS; i++)
+    {
+        __real_Crystalfontz128x128_DrawString(&context, (int8_t *)BENCH_STRING,
+                                              AUTO_STRING_LENGTH, 10, 60,
+                                              OPAQUE_TEXT);
+    }
+    cached = Bench_seconds() - start;
+
+    start = Bench_seconds();
+    for (i = 0; i < BENCH_STRINGS; i++)
+    {
+        Graphics_drawString(&context, (int8_t *)BENCH_STRING,
+                            AUTO_STRING_LENGTH, 10, 60, OPAQUE_TEXT);
+    }
+    uncached = Bench_seconds() - start;
+    Graphics_flushBuffer(&context);
+
+    printf("\"%s\": glyph cache %.0f strings/s, Graphics_drawString %.0f "
+           "strings/s\n", BENCH_STRING, BENCH_STRINGS / cached,
+           BENCH_STRINGS / uncached);
+}
+
+static void Bench_cities(void)
+{
+    const Graphics_Image *volatile icon;
+    double start, lookup, compare;
+    uint32_t i;
+
+    printf("City_t %lu bytes, %d cities %lu bytes\n",
+           (unsigned long)sizeof(City_t), MAX_CITIES,
+           (unsigned long)sizeof(cities));
+
+    start = Bench_seconds();
+    for (i = 0; i < BENCH_SELECTIONS; i++)
+    {
+        icon = weather_icons[cities[i % city_count].weather];
+    }
+    lookup = Bench_seconds() - start;
+
+    start = Bench_seconds();
+    for (i = 0; i < BENCH_SELECTIONS; i++)
+    {
+        icon = Bench_iconByName(weather_names[cities[i % city_count].weather]);
+    }
+    compare = Bench_seconds() - start;
+    (void)icon;
+
+    printf("icon selection: table %.2f ns, strcmp %.2f ns\n",
+           lookup * 1e9 / BENCH_SELECTIONS, compare * 1e9 / BENCH_SELECTIONS);
+}
+
+int main(int argc, char **argv)
+{
+    const char *folder = (argc > 1) ? argv[1] : 0;
+    const char *reference = (argc > 2) ? argv[2] : 0;
+    uint16_t page;
+    uint32_t i;
+
+#ifdef SIM_GRLIB_STANDIN
+    //
+    // The stand-in's glyphs are not the SDK's, no page would match.
+    //
+    if (reference)
+    {
+        printf("reference images need the SDK build, not compared\n");
+        reference = 0;
+    }
+#endif
+
+    Bench_loadData();
+    _graphicsInit();
+
+    //
+    // An hour of samples at 2 Hz for the sparkline of the room page.
+    //
+    History_init();
+    for (i = 0; i < HISTORY_HOUR_INPUTS * HISTORY_POINTS; i++)
+    {
+        History_add(BENCH_ROOM_TEMPERATURE +
+                    (int16_t)(BENCH_ROOM_SWING * sin(i / 1000.0)));
+    }
+
+    //
+    // Same context as _graphicsInit() sets up, with callbacks counted.
+    //
+    Graphics_initContext(&g_sContext, &g_sCrystalfontz128x128,
+                         &Sim_LCD_countingFuncs);
+    Graphics_setForegroundColor(&g_sContext, GRAPHICS_COLOR_WHITE);
+    Graphics_setBackgroundColor(&g_sContext, GRAPHICS_COLOR_BLACK);
+    GrContextFontSet(&g_sContext, &g_sFontFixed6x8);
+
+    printf("page  cmd bytes data bytes  windows   pixels draw calls   wire (us)\n");
+
+    //
+    // Forward through all pages and back to the room, as the top button does.
+    //
+    page = 0;
+    do
+    {
+        Bench_page(page, folder, reference);
+        page = next_page(page);
+    }
+    while (page != 0);
+    Bench_page(page, 0, 0);
+
+    //
+    // Backwards with the carousel transition of the bottom button.
+    //
+    printf("with carousel transition\n");
+    transition = true;
+    transition_direction = LCD_CAROUSEL_PREVIOUS;
+    do
+    {
+        page = previous_page(page);
+        Bench_page(page, 0, 0);
+    }
+    while (page != 0);
+    transition = false;
+
+    Bench_elision();
+    Bench_strings();
+    Bench_cities();
+
+    if (Bench_mismatches)
+    {
+        printf("FAILED, %d pages differ from their reference\n",
+               Bench_mismatches);
+        return 1;
+    }
+    return 0;
+}
+
+#endif /* LCD_SIM */
@@ -0,0 +1,653 @@
+//*****************************************************************************
+//
+// lcd_dma_test.c - Runs the SPI and DMA paths of the LCD HAL against a
+// simulated EUSCI_B0 and uDMA channel.
+//
+// Links the real HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.c, which
+// lcd_sim.c replaces in the other host builds.  The test plays:
+//
+//   - the EUSCI_B0 in SPI mode: a byte written to UCB0TXBUF is shifted out
+//     when the CPU next polls UCB0STATW or UCB0IFG, or when a DMA transfer
+//     starts behind it, with the D/C pin as it is at that moment;
+//   - the uDMA channel of LCD_DMA_CHANNEL: a transfer is recorded when it is
+//     enabled and its bytes go out when it completes, either when the CPU
+//     polls DMA_isChannelEnabled() or when the test runs the queue, with the
+//     D/C pin as it is then;
+//   - the DMA_INT1 interrupt, taken when a transfer completes, unless the
+//     HAL masked it with Interrupt_disableInterrupt().
+//
+// Bytes sent are kept with their phase, so each check compares a trace of
+// commands and data runs, like "C2A D4 C2C D2500", and the DMA transfers
+// made, I<bytes> walking the source and R<bytes> repeating one byte.  It
+// checks single bytes, blocks and colors short enough for the CPU, blocks
+// split at LCD_DMA_MAX_TRANSFER, single byte and pattern colors, queued
+// blocks of several rows and several blocks in a row, and a queue aborted
+// while a transfer is running.  A D/C change while bytes are still on their
+// way shows up as a wrong phase in the trace.
+//
+// HAL_LCD_waitIdle() spins on the queue in memory, so the test only calls
+// the blocking functions once it has run the queue empty.
+//
+// Build and run from lcd-part2:
+//
+//   gcc -DLCD_SIM -Wall -Wextra -Isim/include -Isim/grlib/include -I.
+//       -o lcd_dma_test sim/lcd_dma_test.c sim/msp432_sim.c
+//       LcdDriver/HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.c
+//       && ./lcd_dma_test
+//
+//*****************************************************************************
+
+#ifdef LCD_SIM
+
+#include <stdarg.h>
+#include <string.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "sim_test.h"
+#include "LcdDriver/Crystalfontz128x128_ST7735.h"
+#include "LcdDriver/HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h"
+
+extern void DMA_INT1_IRQHandler(void);
+
+// Marks UCB0TXBUF as shifted out
+#define SPI_TXBUF_EMPTY     0xFFFF
+
+// Bytes the bus log holds
+#define SPI_LOG_SIZE        16384
+
+// Transfers after which a queue that has not drained is stuck
+#define DMA_STEPS_MAX       1000
+
+// Bytes sent, in order, with the phase they were sent in
+static uint8_t Spi_bytes[SPI_LOG_SIZE];
+static bool Spi_command[SPI_LOG_SIZE];
+static uint32_t Spi_count;
+
+// Data bytes only, for comparing with what was sent
+static uint8_t Spi_data[SPI_LOG_SIZE];
+static uint32_t Spi_dataCount;
+
+// D/C pin, high for data
+static bool Spi_dc = true;
+
+// DMA channel
+static uint32_t Dma_control;
+static const uint8_t *Dma_src;
+static void *Dma_dst;
+static uint32_t Dma_size;
+static bool Dma_enabled;
+static bool Dma_flag;
+static bool Dma_intEnabled;
+static char Dma_trace[512];
+
+// Interrupt mask of the CPU
+static bool Test_dmaMasked;
+static bool Test_inInterrupt;
+
+static char Test_trace[512];
+
+//
+// Appends an item to a trace.
+//
+static void Test_log(char *trace, size_t size, const char *format, ...)
+{
+    size_t length = strlen(trace);
+    va_list args;
+
+    if ((length > 0) && (length < size - 1))
+    {
+        trace[length++] = ' ';
+        trace[length] = '\0';
+    }
+
+    va_start(args, format);
+    vsnprintf(trace + length, size - length, format, args);
+    va_end(args);
+}
+
+//
+// A byte leaves the shift register in the current phase.
+//
+static void Spi_send(uint8_t byte)
+{
+    if (Spi_count < SPI_LOG_SIZE)
+    {
+        Spi_bytes[Spi_count] = byte;
+        Spi_command[Spi_count++] = !Spi_dc;
+    }
+    if (Spi_dc && (Spi_dataCount < SPI_LOG_SIZE))
+    {
+        Spi_data[Spi_dataCount++] = byte;
+    }
+}
+
+static void Spi_shift(void)
+{
+    if (UCB0TXBUF != SPI_TXBUF_EMPTY)
+    {
+        Spi_send((uint8_t)UCB0TXBUF);
+        UCB0TXBUF = SPI_TXBUF_EMPTY;
+    }
+}
+
+//
+// Whatever the CPU wrote is out by the time it sees the USCI idle.
+//
+volatile uint16_t *Sim_UCB0STATW_access(void)
+{
+    Spi_shift();
+    Sim_UCB0STATW = 0;
+
+    return &Sim_UCB0STATW;
+}
+
+volatile uint16_t *Sim_UCB0IFG_access(void)
+{
+    Spi_shift();
+    Sim_UCB0IFG = UCTXIFG;
+
+    return &Sim_UCB0IFG;
+}
+
+void GPIO_setOutputLowOnPin(uint_fast8_t selectedPort,
+                            uint_fast16_t selectedPins)
+{
+    if ((selectedPort == LCD_DC_PORT) && (selectedPins & LCD_DC_PIN))
+    {
+        Spi_dc = false;
+    }
+}
+
+void GPIO_setOutputHighOnPin(uint_fast8_t selectedPort,
+                             uint_fast16_t selectedPins)
+{
+    if ((selectedPort == LCD_DC_PORT) && (selectedPins & LCD_DC_PIN))
+    {
+        Spi_dc = true;
+    }
+}
+
+//
+// Takes the DMA interrupt if it is pending and not masked.
+//
+static bool Test_interrupt(void)
+{
+    if (!Dma_flag || !Dma_intEnabled || Test_dmaMasked || Test_inInterrupt)
+    {
+        return false;
+    }
+
+    Test_inInterrupt = true;
+    DMA_INT1_IRQHandler();
+    Test_inInterrupt = false;
+
+    return true;
+}
+
+//
+// The running transfer reaches the USCI, in the phase of the D/C pin now.
+//
+static void Dma_complete(void)
+{
+    uint32_t i;
+
+    if (!Dma_enabled)
+    {
+        return;
+    }
+
+    for (i = 0; i < Dma_size; i++)
+    {
+        Spi_send((Dma_control & UDMA_SRC_INC_NONE) ? Dma_src[0] : Dma_src[i]);
+    }
+    Dma_enabled = false;
+    Dma_flag = true;
+}
+
+//
+// uDMA side of the driverlib stand-in.
+//
+void DMA_enableInterrupt(uint32_t interruptNumber)
+{
+    SIM_TEST_EQUAL(interruptNumber, LCD_DMA_INT);
+    Dma_intEnabled = true;
+}
+
+void DMA_clearInterruptFlag(uint32_t intChannel)
+{
+    SIM_TEST_EQUAL(intChannel, LCD_DMA_CHANNEL_NUM);
+    Dma_flag = false;
+}
+
+void DMA_setChannelControl(uint32_t channelStructIndex, uint32_t control)
+{
+    SIM_TEST_EQUAL(channelStructIndex, UDMA_PRI_SELECT | LCD_DMA_CHANNEL);
+    Dma_control = control;
+}
+
+void DMA_setChannelTransfer(uint32_t channelStructIndex, uint32_t mode,
+                            void *srcAddr, void *dstAddr,
+                            uint32_t transferSize)
+{
+    SIM_TEST_EQUAL(channelStructIndex, UDMA_PRI_SELECT | LCD_DMA_CHANNEL);
+    SIM_TEST_EQUAL(mode, UDMA_MODE_BASIC);
+    Dma_src = srcAddr;
+    Dma_dst = dstAddr;
+    Dma_size = transferSize;
+}
+
+void DMA_enableChannel(uint32_t channelNum)
+{
+    SIM_TEST_EQUAL(channelNum, LCD_DMA_CHANNEL_NUM);
+    SIM_TEST_CHECK(!Dma_enabled);
+    SIM_TEST_CHECK(Dma_dst == (void *)&UCB0TXBUF);
+    SIM_TEST_CHECK((Dma_size > 0) && (Dma_size <= LCD_DMA_MAX_TRANSFER));
+
+    //
+    // The channel waits for the byte the CPU wrote last to leave.
+    //
+    Spi_shift();
+    Test_log(Dma_trace, sizeof(Dma_trace), "%c%lu",
+             (Dma_control & UDMA_SRC_INC_NONE) ? 'R' : 'I',
+             (unsigned long)Dma_size);
+    Dma_enabled = true;
+}
+
+bool DMA_isChannelEnabled(uint32_t channelNum)
+{
+    SIM_TEST_EQUAL(channelNum, LCD_DMA_CHANNEL_NUM);
+
+    //
+    // The CPU polls until the transfer completes, the interrupt is taken
+    // then unless it is masked.
+    //
+    Dma_complete();
+    Test_interrupt();
+
+    return Dma_enabled;
+}
+
+//
+// CPU side of the driverlib stand-in.
+//
+void Interrupt_enableInterrupt(uint32_t interruptNumber)
+{
+    if (interruptNumber == LCD_DMA_INT)
+    {
+        Test_dmaMasked = false;
+        while (Test_interrupt())
+        {
+        }
+    }
+}
+
+void Interrupt_disableInterrupt(uint32_t interruptNumber)
+{
+    if (interruptNumber == LCD_DMA_INT)
+    {
+        Test_dmaMasked = true;
+    }
+}
+
+void SysCtlDelay(uint32_t ui32Count)
+{
+    (void)ui32Count;
+}
+
+//
+// Completes transfers and takes their interrupt until the queue is empty.
+//
+static bool Test_run(void)
+{
+    uint16_t steps;
+
+    for (steps = 0; (steps < DMA_STEPS_MAX) && Dma_enabled; steps++)
+    {
+        Dma_complete();
+        Test_interrupt();
+    }
+
+    return !HAL_LCD_isBusy() && !Dma_enabled;
+}
+
+//
+// Trace of what was sent since the last Test_reset(): each command as
+// C<hex>, each run of data bytes as D<count>.
+//
+static const char *Test_bus(void)
+{
+    uint32_t i, run = 0;
+
+    //
+    // The last byte the CPU wrote goes out on its own.
+    //
+    Spi_shift();
+    Test_trace[0] = '\0';
+    for (i = 0; i < Spi_count; i++)
+    {
+        if (!Spi_command[i])
+        {
+            run++;
+            continue;
+        }
+        if (run)
+        {
+            Test_log(Test_trace, sizeof(Test_trace), "D%lu",
+                     (unsigned long)run);
+            run = 0;
+        }
+        Test_log(Test_trace, sizeof(Test_trace), "C%02X", Spi_bytes[i]);
+    }
+    if (run)
+    {
+        Test_log(Test_trace, sizeof(Test_trace), "D%lu", (unsigned long)run);
+    }
+
+    return Test_trace;
+}
+
+static void Test_reset(void)
+{
+    Spi_shift();
+    Spi_count = 0;
+    Spi_dataCount = 0;
+    Dma_trace[0] = '\0';
+}
+
+#define TEST_TRACE(actual, expected)                                        \
+    do                                                                      \
+    {                                                                       \
+        const char *testActual = (actual);                                  \
+        Sim_Test_checks++;                                                  \
+        if (strcmp(testActual, (expected)) != 0)                            \
+        {                                                                   \
+            printf("%s:%d: failed: %s is \"%s\", expected \"%s\"\n",        \
+                   __FILE__, __LINE__, #actual, testActual, (expected));    \
+            Sim_Test_failures++;                                            \
+        }                                                                   \
+    } while (0)
+
+//
+// True if the data sent holds count copies of the color, from offset on.
+//
+static bool Test_colorSent(uint32_t offset, uint16_t color, uint32_t count)
+{
+    uint32_t i;
+
+    if (offset + count * 2 > Spi_dataCount)
+    {
+        return false;
+    }
+    for (i = 0; i < count; i++)
+    {
+        if ((Spi_data[offset + i * 2] != (uint8_t)(color >> 8)) ||
+            (Spi_data[offset + i * 2 + 1] != (uint8_t)color))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Source of the data blocks, a byte pattern that does not repeat soon
+static uint8_t Test_source[4 * LCD_DMA_MAX_TRANSFER];
+
+//
+// A queue block for a window of rows, each length bytes, stride bytes apart
+// in Test_source.
+//
+static void Test_block(HAL_LCD_Block *block, uint32_t length, uint16_t stride,
+                       uint16_t rows)
+{
+    static const uint8_t header[] = {
+        CM_CASET, 0x00, 0x02, 0x00, 0x81,
+        CM_RASET, 0x00, 0x03, 0x00, 0x82,
+        CM_RAMWR
+    };
+
+    memcpy(block->header, header, sizeof(header));
+    block->headerLength = sizeof(header);
+    block->commandMask = (1 << 0) | (1 << 5) | (1 << 10);
+    block->data = Test_source;
+    block->length = length;
+    block->stride = stride;
+    block->rows = rows;
+}
+
+#define TEST_WINDOW_BUS "C2A D4 C2B D4 C2C"
+
+static void Test_direct(void)
+{
+    static const uint8_t params[] = { 0x00, 0x02, 0x00, 0x81 };
+
+    //
+    // Command and parameters, written by the CPU.
+    //
+    Test_reset();
+    HAL_LCD_writeCommand(CM_CASET);
+    HAL_LCD_writeData(params[0]);
+    HAL_LCD_writeData(params[1]);
+    HAL_LCD_writeData(params[2]);
+    HAL_LCD_writeData(params[3]);
+    HAL_LCD_writeCommand(CM_RAMWR);
+    TEST_TRACE(Test_bus(), "C2A D4 C2C");
+    SIM_TEST_CHECK(memcmp(Spi_data, params, sizeof(params)) == 0);
+    TEST_TRACE(Dma_trace, "");
+
+    //
+    // A block too short for the DMA.
+    //
+    Test_reset();
+    HAL_LCD_writeDataBlock(Test_source, LCD_DMA_MIN_TRANSFER - 1);
+    TEST_TRACE(Test_bus(), "D15");
+    TEST_TRACE(Dma_trace, "");
+    SIM_TEST_CHECK(memcmp(Spi_data, Test_source, LCD_DMA_MIN_TRANSFER - 1) == 0);
+
+    //
+    // Blocks split at LCD_DMA_MAX_TRANSFER, exactly and not.
+    //
+    Test_reset();
+    HAL_LCD_writeDataBlock(Test_source, LCD_DMA_MAX_TRANSFER);
+    TEST_TRACE(Test_bus(), "D1024");
+    TEST_TRACE(Dma_trace, "I1024");
+
+    Test_reset();
+    HAL_LCD_writeCommand(CM_RAMWR);
+    HAL_LCD_writeDataBlock(Test_source + 3, 2500);
+    HAL_LCD_writeCommand(CM_NOP);
+    TEST_TRACE(Test_bus(), "C2C D2500 C00");
+    TEST_TRACE(Dma_trace, "I1024 I1024 I452");
+    SIM_TEST_CHECK(memcmp(Spi_data, Test_source + 3, 2500) == 0);
+    SIM_TEST_CHECK(!Dma_flag);
+}
+
+static void Test_colors(void)
+{
+    //
+    // Short fills go through the CPU, high byte first.
+    //
+    Test_reset();
+    HAL_LCD_writeColor(0x1234, 7);
+    TEST_TRACE(Test_bus(), "D14");
+    TEST_TRACE(Dma_trace, "");
+    SIM_TEST_CHECK(Test_colorSent(0, 0x1234, 7));
+
+    //
+    // Two different bytes stream the pattern buffer.
+    //
+    Test_reset();
+    HAL_LCD_writeColor(0x1234, 1000);
+    TEST_TRACE(Test_bus(), "D2000");
+    TEST_TRACE(Dma_trace, "I256 I256 I256 I256 I256 I256 I256 I208");
+    SIM_TEST_CHECK(Test_colorSent(0, 0x1234, 1000));
+
+    //
+    // Equal bytes repeat a single one, in chunks of LCD_DMA_MAX_TRANSFER.
+    //
+    Test_reset();
+    HAL_LCD_writeColor(0xFFFF, 3000);
+    TEST_TRACE(Test_bus(), "D6000");
+    TEST_TRACE(Dma_trace, "R1024 R1024 R1024 R1024 R1024 R880");
+    SIM_TEST_CHECK(Test_colorSent(0, 0xFFFF, 3000));
+
+    //
+    // The single byte fill overwrote the start of the pattern, which must be
+    // filled again for the next two-byte color even if it is the same.
+    //
+    Test_reset();
+    HAL_LCD_writeColor(0x1234, 200);
+    HAL_LCD_writeColor(0x0000, 200);
+    HAL_LCD_writeColor(0x1234, 200);
+    HAL_LCD_writeColor(0x5678, 200);
+    TEST_TRACE(Test_bus(), "D1600");
+    SIM_TEST_CHECK(Test_colorSent(0, 0x1234, 200));
+    SIM_TEST_CHECK(Test_colorSent(400, 0x0000, 200));
+    SIM_TEST_CHECK(Test_colorSent(800, 0x1234, 200));
+    SIM_TEST_CHECK(Test_colorSent(1200, 0x5678, 200));
+}
+
+static void Test_queue(void)
+{
+    HAL_LCD_Block block;
+    uint16_t row;
+    bool rowsSent = true;
+    bool drained;
+
+    //
+    // The header goes out at once, the first row is started and the rest is
+    // left to the interrupt.
+    //
+    Test_reset();
+    Test_block(&block, 300, 400, 3);
+    HAL_LCD_queueBlock(&block);
+    TEST_TRACE(Test_bus(), TEST_WINDOW_BUS);
+    TEST_TRACE(Dma_trace, "I300");
+    SIM_TEST_CHECK(HAL_LCD_isBusy());
+    SIM_TEST_EQUAL(HAL_LCD_queueFree(), LCD_QUEUE_SIZE - 2);
+    SIM_TEST_CHECK(!Test_dmaMasked);
+
+    SIM_TEST_CHECK(Test_run());
+    TEST_TRACE(Test_bus(), TEST_WINDOW_BUS " D900");
+    TEST_TRACE(Dma_trace, "I300 I300 I300");
+    for (row = 0; row < 3; row++)
+    {
+        rowsSent = rowsSent && (memcmp(Spi_data + 4 + 4 + row * 300,
+                                       Test_source + row * 400, 300) == 0);
+    }
+    SIM_TEST_CHECK(rowsSent);
+    SIM_TEST_EQUAL(HAL_LCD_queueFree(), LCD_QUEUE_SIZE - 1);
+
+    //
+    // Rows longer than a transfer are split, and blocks queued while one is
+    // sent follow it in order, a header only block included.
+    //
+    Test_reset();
+    Test_block(&block, 2500, 2500, 1);
+    HAL_LCD_queueBlock(&block);
+    Test_block(&block, 20, 20, 2);
+    HAL_LCD_queueBlock(&block);
+    block.headerLength = 2;
+    block.header[0] = CM_MADCTL;
+    block.header[1] = 0xC8;
+    block.commandMask = 1 << 0;
+    block.length = 0;
+    HAL_LCD_queueBlock(&block);
+    TEST_TRACE(Dma_trace, "I1024");
+    SIM_TEST_EQUAL(HAL_LCD_queueFree(), LCD_QUEUE_SIZE - 4);
+
+    drained = Test_run();
+    SIM_TEST_CHECK(drained);
+    TEST_TRACE(Test_bus(),
+               TEST_WINDOW_BUS " D2500 " TEST_WINDOW_BUS " D40 C36 D1");
+    TEST_TRACE(Dma_trace, "I1024 I1024 I452 I20 I20");
+    SIM_TEST_CHECK(memcmp(Spi_data + 8, Test_source, 2500) == 0);
+
+    //
+    // Then the CPU writes straight again, once the queue it waits for is
+    // empty.
+    //
+    if (!drained)
+    {
+        return;
+    }
+    Test_reset();
+    HAL_LCD_writeCommand(CM_NOP);
+    TEST_TRACE(Test_bus(), "C00");
+}
+
+static void Test_abort(void)
+{
+    HAL_LCD_Block block;
+
+    //
+    // Nothing to abort.
+    //
+    SIM_TEST_CHECK(!HAL_LCD_abortQueue());
+
+    //
+    // Aborted during the first row of the first block: that transfer ends,
+    // nothing after it is sent and its interrupt is not taken.
+    //
+    Test_reset();
+    Test_block(&block, 300, 300, 3);
+    HAL_LCD_queueBlock(&block);
+    HAL_LCD_queueBlock(&block);
+    SIM_TEST_CHECK(HAL_LCD_abortQueue());
+    SIM_TEST_CHECK(!HAL_LCD_isBusy());
+    SIM_TEST_CHECK(!Dma_enabled);
+    SIM_TEST_CHECK(!Dma_flag);
+    SIM_TEST_CHECK(!Test_dmaMasked);
+    TEST_TRACE(Test_bus(), TEST_WINDOW_BUS " D300");
+    TEST_TRACE(Dma_trace, "I300");
+
+    //
+    // The next block starts with its own header.
+    //
+    Test_reset();
+    Test_block(&block, 20, 20, 1);
+    HAL_LCD_queueBlock(&block);
+    SIM_TEST_CHECK(Test_run());
+    TEST_TRACE(Test_bus(), TEST_WINDOW_BUS " D20");
+    TEST_TRACE(Dma_trace, "I20");
+
+    //
+    // Aborted during the data of the second block, started by the interrupt
+    // of the first: that block still ends with its data.
+    //
+    Test_reset();
+    Test_block(&block, 300, 300, 1);
+    HAL_LCD_queueBlock(&block);
+    HAL_LCD_queueBlock(&block);
+    Dma_complete();
+    SIM_TEST_CHECK(Test_interrupt());
+    TEST_TRACE(Test_bus(), TEST_WINDOW_BUS " D300 " TEST_WINDOW_BUS);
+    SIM_TEST_CHECK(HAL_LCD_abortQueue());
+    SIM_TEST_CHECK(!HAL_LCD_isBusy());
+    TEST_TRACE(Test_bus(), TEST_WINDOW_BUS " D300 " TEST_WINDOW_BUS " D300");
+    TEST_TRACE(Dma_trace, "I300 I300");
+}
+
+int main(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(Test_source); i++)
+    {
+        Test_source[i] = (uint8_t)(i * 7 + i / 251);
+    }
+    UCB0TXBUF = SPI_TXBUF_EMPTY;
+
+    HAL_LCD_PortInit();
+    HAL_LCD_SpiInit();
+    HAL_LCD_DmaInit();
+    SIM_TEST_CHECK(Spi_dc);
+    SIM_TEST_CHECK(Dma_intEnabled);
+
+    Test_direct();
+    Test_colors();
+    Test_queue();
+    Test_abort();
+
+    return Sim_Test_report("lcd_dma_test");
+}
+
+#endif /* LCD_SIM */
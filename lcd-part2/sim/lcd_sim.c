@@ -0,0 +1,506 @@
+//*****************************************************************************
+//
+// lcd_sim.c - Virtual Crystalfontz128x128 / ST7735 panel for host builds.
+//
+// See lcd_sim.h for what it models and how to build it.
+//
+//*****************************************************************************
+
+#ifdef LCD_SIM
+
+#include <stdio.h>
+#include <string.h>
+#include "lcd_sim.h"
+#include "LcdDriver/Crystalfontz128x128_ST7735.h"
+#include "LcdDriver/HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.h"
+
+Sim_LCD_Stats Sim_LCD_stats;
+uint8_t Sim_LCD_windowElision = 1;
+
+// Controller memory, RGB565, indexed by physical line then column
+static uint16_t Sim_Memory[SIM_LCD_MEMORY_LINES][SIM_LCD_MEMORY_COLUMNS];
+
+// Command being received and its parameters
+static uint8_t Sim_Command;
+static uint8_t Sim_Params[8];
+static uint8_t Sim_ParamCount;
+
+// Controller registers
+static uint8_t Sim_Madctl;
+static uint16_t Sim_ColStart, Sim_ColEnd, Sim_RowStart, Sim_RowEnd;
+static uint16_t Sim_TopFixed, Sim_ScrollLines = SIM_LCD_MEMORY_LINES;
+static uint16_t Sim_ScrollStart;
+static uint8_t Sim_Scrolling;
+
+// RAMWR write position (in MADCTL coordinates) and first byte of a pixel
+static uint16_t Sim_Col, Sim_Row;
+static uint8_t Sim_HighByte;
+static uint8_t Sim_HaveHighByte;
+
+
+//*****************************************************************************
+//
+// Controller model
+//
+//*****************************************************************************
+static void Sim_storePixel(uint16_t value)
+{
+    uint16_t column = Sim_Col;
+    uint16_t line = Sim_Row;
+    uint16_t swap;
+
+    //
+    // Column and row addresses are exchanged first, then mirrored.
+    //
+    if (Sim_Madctl & CM_MADCTL_MV)
+    {
+        swap = column;
+        column = line;
+        line = swap;
+    }
+    if (Sim_Madctl & CM_MADCTL_MX)
+    {
+        column = SIM_LCD_MEMORY_COLUMNS - 1 - column;
+    }
+    if (Sim_Madctl & CM_MADCTL_MY)
+    {
+        line = SIM_LCD_MEMORY_LINES - 1 - line;
+    }
+
+    if ((line < SIM_LCD_MEMORY_LINES) && (column < SIM_LCD_MEMORY_COLUMNS))
+    {
+        Sim_Memory[line][column] = value;
+    }
+    Sim_LCD_stats.pixels++;
+
+    if (++Sim_Col > Sim_ColEnd)
+    {
+        Sim_Col = Sim_ColStart;
+        if (++Sim_Row > Sim_RowEnd)
+        {
+            Sim_Row = Sim_RowStart;
+        }
+    }
+}
+
+static void Sim_parameter(uint8_t data)
+{
+    if (Sim_ParamCount < sizeof(Sim_Params))
+    {
+        Sim_Params[Sim_ParamCount++] = data;
+    }
+
+    switch (Sim_Command)
+    {
+        case CM_CASET:
+            if (Sim_ParamCount == 4)
+            {
+                Sim_ColStart = (Sim_Params[0] << 8) | Sim_Params[1];
+                Sim_ColEnd = (Sim_Params[2] << 8) | Sim_Params[3];
+            }
+            break;
+        case CM_RASET:
+            if (Sim_ParamCount == 4)
+            {
+                Sim_RowStart = (Sim_Params[0] << 8) | Sim_Params[1];
+                Sim_RowEnd = (Sim_Params[2] << 8) | Sim_Params[3];
+            }
+            break;
+        case CM_MADCTL:
+            Sim_Madctl = data;
+            break;
+        case CM_VSCRDEF:
+            if (Sim_ParamCount == 6)
+            {
+                Sim_TopFixed = (Sim_Params[0] << 8) | Sim_Params[1];
+                Sim_ScrollLines = (Sim_Params[2] << 8) | Sim_Params[3];
+            }
+            break;
+        case CM_VSCSAD:
+            if (Sim_ParamCount == 2)
+            {
+                Sim_ScrollStart = (Sim_Params[0] << 8) | Sim_Params[1];
+                Sim_Scrolling = 1;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+//
+// Memory line shown on display line (0 at the top of the scan).
+//
+static uint16_t Sim_displayLine(uint16_t line)
+{
+    if (!Sim_Scrolling || (Sim_ScrollLines == 0) || (line < Sim_TopFixed) ||
+        (line >= Sim_TopFixed + Sim_ScrollLines))
+    {
+        return line;
+    }
+
+    return Sim_TopFixed + ((Sim_ScrollStart - Sim_TopFixed) +
+                           (line - Sim_TopFixed)) % Sim_ScrollLines;
+}
+
+
+//*****************************************************************************
+//
+// HAL_LCD_* stand-ins
+//
+//*****************************************************************************
+void HAL_LCD_PortInit(void)
+{
+}
+
+void HAL_LCD_SpiInit(void)
+{
+}
+
+void HAL_LCD_DmaInit(void)
+{
+}
+
+void HAL_LCD_reset(void)
+{
+    memset(Sim_Memory, 0, sizeof(Sim_Memory));
+    Sim_Madctl = 0;
+    Sim_ColStart = Sim_RowStart = 0;
+    Sim_ColEnd = SIM_LCD_MEMORY_COLUMNS - 1;
+    Sim_RowEnd = SIM_LCD_MEMORY_LINES - 1;
+    Sim_TopFixed = 0;
+    Sim_ScrollLines = SIM_LCD_MEMORY_LINES;
+    Sim_ScrollStart = 0;
+    Sim_Scrolling = 0;
+}
+
+void HAL_LCD_writeCommand(uint8_t command)
+{
+    Sim_LCD_stats.commandBytes++;
+
+    Sim_Command = command;
+    Sim_ParamCount = 0;
+    Sim_HaveHighByte = 0;
+
+    switch (command)
+    {
+        case CM_RAMWR:
+            Sim_Col = Sim_ColStart;
+            Sim_Row = Sim_RowStart;
+            Sim_LCD_stats.windows++;
+            break;
+        case CM_NORON:
+            Sim_Scrolling = 0;
+            break;
+        case CM_SWRESET:
+            HAL_LCD_reset();
+            break;
+        default:
+            break;
+    }
+}
+
+void HAL_LCD_writeData(uint8_t data)
+{
+    Sim_LCD_stats.dataBytes++;
+
+    if (Sim_Command != CM_RAMWR)
+    {
+        Sim_parameter(data);
+        return;
+    }
+
+    if (!Sim_HaveHighByte)
+    {
+        Sim_HighByte = data;
+        Sim_HaveHighByte = 1;
+        return;
+    }
+
+    Sim_HaveHighByte = 0;
+    Sim_storePixel((Sim_HighByte << 8) | data);
+}
+
+void HAL_LCD_writeDataBlock(const uint8_t *data, uint32_t length)
+{
+    while (length--)
+    {
+        HAL_LCD_writeData(*data++);
+    }
+}
+
+void HAL_LCD_writeColor(uint16_t color, uint32_t count)
+{
+    while (count--)
+    {
+        HAL_LCD_writeData(color >> 8);
+        HAL_LCD_writeData(color);
+    }
+}
+
+//
+// The transfer queue sends blocks as soon as they are queued, so the queue is
+// never busy.
+//
+void HAL_LCD_queueBlock(const HAL_LCD_Block *block)
+{
+    uint16_t row;
+    uint8_t i;
+
+    for (i = 0; i < block->headerLength; i++)
+    {
+        if (block->commandMask & (1 << i))
+        {
+            HAL_LCD_writeCommand(block->header[i]);
+        }
+        else
+        {
+            HAL_LCD_writeData(block->header[i]);
+        }
+    }
+
+    for (row = 0; row < block->rows; row++)
+    {
+        HAL_LCD_writeDataBlock(block->data + (uint32_t)row * block->stride,
+                               block->length);
+    }
+}
+
+uint16_t HAL_LCD_queueFree(void)
+{
+    return LCD_QUEUE_SIZE - 1;
+}
+
+bool HAL_LCD_isBusy(void)
+{
+    return false;
+}
+
+void HAL_LCD_waitIdle(void)
+{
+}
+
+bool HAL_LCD_abortQueue(void)
+{
+    return false;
+}
+
+void SysCtlDelay(uint32_t ui32Count)
+{
+    Sim_LCD_stats.delayCycles += ui32Count;
+}
+
+//
+// The frame timer has no interrupt to wait for: every read of the tick count
+// is one period later, counted as delay.
+//
+static uint32_t Sim_FramePeriod;
+static uint16_t Sim_FrameTicks;
+
+void HAL_LCD_frameStart(uint32_t period)
+{
+    Sim_FramePeriod = period;
+    Sim_FrameTicks = 0;
+}
+
+void HAL_LCD_frameStop(void)
+{
+    Sim_FramePeriod = 0;
+}
+
+uint16_t HAL_LCD_frameTicks(void)
+{
+    if (Sim_FramePeriod)
+    {
+        Sim_LCD_stats.delayCycles += (uint64_t)Sim_FramePeriod *
+                                     (LCD_SYSTEM_CLOCK_SPEED / 1000000);
+        Sim_FrameTicks++;
+    }
+
+    return Sim_FrameTicks;
+}
+
+
+//*****************************************************************************
+//
+// Draw call counting display functions
+//
+//*****************************************************************************
+static void Sim_pixelDraw(const Graphics_Display *pDisplay, int16_t lX,
+                          int16_t lY, uint16_t ulValue)
+{
+    Sim_LCD_stats.drawCalls++;
+    g_sCrystalfontz128x128_funcs.pfnPixelDraw(pDisplay, lX, lY, ulValue);
+}
+
+static void Sim_pixelDrawMultiple(const Graphics_Display *pDisplay, int16_t lX,
+                                  int16_t lY, int16_t lX0, int16_t lCount,
+                                  int16_t lBPP, const uint8_t *pucData,
+                                  const uint32_t *pucPalette)
+{
+    Sim_LCD_stats.drawCalls++;
+    g_sCrystalfontz128x128_funcs.pfnPixelDrawMultiple(pDisplay, lX, lY, lX0,
+                                                      lCount, lBPP, pucData,
+                                                      pucPalette);
+}
+
+static void Sim_lineDrawH(const Graphics_Display *pDisplay, int16_t lX1,
+                          int16_t lX2, int16_t lY, uint16_t ulValue)
+{
+    Sim_LCD_stats.drawCalls++;
+    g_sCrystalfontz128x128_funcs.pfnLineDrawH(pDisplay, lX1, lX2, lY, ulValue);
+}
+
+static void Sim_lineDrawV(const Graphics_Display *pDisplay, int16_t lX,
+                          int16_t lY1, int16_t lY2, uint16_t ulValue)
+{
+    Sim_LCD_stats.drawCalls++;
+    g_sCrystalfontz128x128_funcs.pfnLineDrawV(pDisplay, lX, lY1, lY2, ulValue);
+}
+
+static void Sim_rectFill(const Graphics_Display *pDisplay,
+                         const Graphics_Rectangle *pRect, uint16_t ulValue)
+{
+    Sim_LCD_stats.drawCalls++;
+    g_sCrystalfontz128x128_funcs.pfnRectFill(pDisplay, pRect, ulValue);
+}
+
+static uint32_t Sim_colorTranslate(const Graphics_Display *pDisplay,
+                                   uint32_t ulValue)
+{
+    return g_sCrystalfontz128x128_funcs.pfnColorTranslate(pDisplay, ulValue);
+}
+
+static void Sim_flush(const Graphics_Display *pDisplay)
+{
+    g_sCrystalfontz128x128_funcs.pfnFlush(pDisplay);
+}
+
+static void Sim_clearDisplay(const Graphics_Display *pDisplay, uint16_t ulValue)
+{
+    Sim_LCD_stats.drawCalls++;
+    g_sCrystalfontz128x128_funcs.pfnClearDisplay(pDisplay, ulValue);
+}
+
+const Graphics_Display_Functions Sim_LCD_countingFuncs =
+{
+    Sim_pixelDraw,
+    Sim_pixelDrawMultiple,
+    Sim_lineDrawH,
+    Sim_lineDrawV,
+    Sim_rectFill,
+    Sim_colorTranslate,
+    Sim_flush,
+    Sim_clearDisplay
+};
+
+
+//*****************************************************************************
+//
+// Results
+//
+//*****************************************************************************
+void Sim_LCD_resetStats(void)
+{
+    memset(&Sim_LCD_stats, 0, sizeof(Sim_LCD_stats));
+}
+
+uint32_t Sim_LCD_wireTime(void)
+{
+    uint64_t bits = (uint64_t)(Sim_LCD_stats.commandBytes +
+                               Sim_LCD_stats.dataBytes) * 8;
+
+    return (uint32_t)(bits * 1000000 / LCD_SPI_CLOCK_SPEED +
+                      Sim_LCD_stats.delayCycles * 1000000 /
+                      LCD_SYSTEM_CLOCK_SPEED);
+}
+
+uint16_t Sim_LCD_getPixel(int16_t x, int16_t y)
+{
+    //
+    // In LCD_ORIENTATION_UP the rows and columns are mirrored and the panel
+    // shows memory columns 2 to 129 and display lines 1 to 128.
+    //
+    uint16_t column = SIM_LCD_MEMORY_COLUMNS - 3 - x;
+    uint16_t line = Sim_displayLine(SIM_LCD_MEMORY_LINES - 4 - y);
+
+    return Sim_Memory[line][column];
+}
+
+int Sim_LCD_writePPM(const char *path)
+{
+    FILE *file;
+    uint16_t value;
+    uint8_t rgb[3];
+    int16_t x, y;
+
+    file = fopen(path, "wb");
+    if (!file)
+    {
+        return -1;
+    }
+
+    fprintf(file, "P6\n%d %d\n255\n", LCD_HORIZONTAL_MAX, LCD_VERTICAL_MAX);
+    for (y = 0; y < LCD_VERTICAL_MAX; y++)
+    {
+        for (x = 0; x < LCD_HORIZONTAL_MAX; x++)
+        {
+            value = Sim_LCD_getPixel(x, y);
+            rgb[0] = (value >> 11) << 3;
+            rgb[1] = ((value >> 5) & 0x3F) << 2;
+            rgb[2] = (value & 0x1F) << 3;
+            fwrite(rgb, 1, 3, file);
+        }
+    }
+
+    return fclose(file);
+}
+
+int32_t Sim_LCD_comparePPM(const char *path)
+{
+    FILE *file;
+    int width, height, depth;
+    uint16_t value;
+    uint8_t rgb[3];
+    int16_t x, y;
+    int32_t differences = 0;
+
+    file = fopen(path, "rb");
+    if (!file)
+    {
+        return -1;
+    }
+
+    //
+    // Only the header Sim_LCD_writePPM() writes is understood.
+    //
+    if ((fscanf(file, "P6 %d %d %d", &width, &height, &depth) != 3) ||
+        (width != LCD_HORIZONTAL_MAX) || (height != LCD_VERTICAL_MAX) ||
+        (depth != 255) || (fgetc(file) != '\n'))
+    {
+        fclose(file);
+        return -1;
+    }
+
+    for (y = 0; y < LCD_VERTICAL_MAX; y++)
+    {
+        for (x = 0; x < LCD_HORIZONTAL_MAX; x++)
+        {
+            if (fread(rgb, 1, 3, file) != 3)
+            {
+                fclose(file);
+                return -1;
+            }
+            value = ((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3);
+            if (value != Sim_LCD_getPixel(x, y))
+            {
+                differences++;
+            }
+        }
+    }
+
+    fclose(file);
+    return differences;
+}
+
+#endif /* LCD_SIM */
@@ -0,0 +1,117 @@
+//*****************************************************************************
+//
+// lcd_sim.h - Virtual Crystalfontz128x128 / ST7735 panel for host builds.
+//
+// lcd_sim.c implements the HAL_LCD_* functions of
+// HAL_MSP_EXP432P401R_Crystalfontz128x128_ST7735.c on Linux.  Instead of
+// driving the SPI bus it decodes the command and data stream the way the
+// ST7735 does (CASET, RASET, RAMWR, MADCTL, VSCRDEF, VSCSAD, NORON) into a
+// copy of the controller memory, from which the 128x128 image seen on the
+// panel can be rebuilt and written out as a PPM file.  Every byte on the wire
+// is counted so rendering can be benchmarked without a LaunchPad.
+//
+// Build with a single command from lcd-part2, SDK being the SimpleLink
+// MSP432P4 SDK folder:
+//
+//   gcc -DLCD_SIM -Isim/include -I$SDK/source -I. -o lcd_bench
+//       sim/lcd_sim.c sim/lcd_bench.c display.c history.c
+//       LcdDriver/Crystalfontz128x128_ST7735.c icons/*.c
+//       $SDK/source/ti/grlib/{context,display,image,line,rectangle,string}.c
+//       $SDK/source/ti/grlib/fonts/fontfixed6x8.c -lm $WRAP
+//
+// Without the SDK, sim/grlib holds a stand-in for the grlib functions in use:
+//
+//   gcc -DLCD_SIM -Isim/include -Isim/grlib/include -I. -o lcd_bench
+//       sim/lcd_sim.c sim/lcd_bench.c display.c history.c
+//       LcdDriver/Crystalfontz128x128_ST7735.c icons/*.c sim/grlib/grlib.c
+//       -lm $WRAP
+//
+// WRAP lets lcd_bench count the calls display.c makes to the drawing
+// functions of the driver, which do not go through grlib:
+//
+//   WRAP=-Wl,--wrap=Crystalfontz128x128_DrawString,
+//        --wrap=Crystalfontz128x128_DrawStringCentered,
+//        --wrap=Crystalfontz128x128_DrawImage,
+//        --wrap=Crystalfontz128x128_DrawSparkline
+//
+// The stand-in font has made-up glyphs, so images and byte counts are close
+// to but not the same as those of the SDK build; use the SDK build for
+// figures that have to match the LaunchPad.  For the same reason lcd_bench
+// only compares pages with reference images, pixel for pixel, in the SDK
+// build: the stand-in defines SIM_GRLIB_STANDIN and the comparison is
+// skipped.
+//
+// lcd_sim.c stands in for the whole HAL, so none of these builds run its SPI
+// and DMA code; lcd_dma_test.c links the real HAL file against a simulated
+// EUSCI_B0 and uDMA channel instead.
+//
+// The sources are empty unless LCD_SIM is defined, so they can stay in the
+// CCS project folder.
+//
+//*****************************************************************************
+
+#ifndef __LCD_SIM_H__
+#define __LCD_SIM_H__
+
+#include <stdint.h>
+#include <ti/grlib/grlib.h>
+
+// Controller memory, in physical lines and columns
+#define SIM_LCD_MEMORY_LINES   132
+#define SIM_LCD_MEMORY_COLUMNS 132
+
+//*****************************************************************************
+//
+// Counters kept by the virtual panel.  Sim_LCD_resetStats() clears them.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t commandBytes;      // bytes sent with D/C low
+    uint32_t dataBytes;         // bytes sent with D/C high
+    uint32_t pixels;            // pixels written through RAMWR
+    uint32_t windows;           // RAMWR commands
+    uint32_t drawCalls;         // driver callbacks and driver draw calls
+    uint64_t delayCycles;       // MCLK cycles spent in HAL_LCD_delay()
+} Sim_LCD_Stats;
+
+extern Sim_LCD_Stats Sim_LCD_stats;
+
+//
+// LCD_WINDOW_ELISION of the driver, 1 unless a bench clears it to measure
+// the windows sent in full.
+//
+extern uint8_t Sim_LCD_windowElision;
+
+//
+// Display functions that count every callback in Sim_LCD_stats.drawCalls
+// before handing it to g_sCrystalfontz128x128_funcs.
+//
+extern const Graphics_Display_Functions Sim_LCD_countingFuncs;
+
+extern void Sim_LCD_resetStats(void);
+
+//
+// Time the counted bytes take on the wire at LCD_SPI_CLOCK_SPEED, plus the
+// counted delays, in microseconds.
+//
+extern uint32_t Sim_LCD_wireTime(void);
+
+//
+// Color of a pixel of the panel as seen in its natural (LCD_ORIENTATION_UP)
+// position, as RGB565.
+//
+extern uint16_t Sim_LCD_getPixel(int16_t x, int16_t y);
+
+//
+// Writes what the panel shows to a binary PPM file.  Returns 0 on success.
+//
+extern int Sim_LCD_writePPM(const char *path);
+
+//
+// Number of pixels of the panel that differ from a PPM file written by
+// Sim_LCD_writePPM(), or -1 if the file cannot be read.
+//
+extern int32_t Sim_LCD_comparePPM(const char *path);
+
+#endif /* __LCD_SIM_H__ */
@@ -0,0 +1,326 @@
+//*****************************************************************************
+//
+// msp432_sim.c - Do-nothing MSP432 peripherals for the host tests.
+//
+// Implements what the stand-in driverlib.h and msp.h declare, so that
+// buttons.c, temp_service.c, HAL/HAL_I2C.c and the LCD HAL link on the host.
+// Pins read released, timers never run, the SPI is never busy, DMA channels
+// never start and interrupts are never taken: a test drives the module under
+// test itself, through Buttons_tick(), TempFilter_add(), EUSCIB1_IRQHandler()
+// or DMA_INT1_IRQHandler().  The functions are weak so a test can provide its
+// own, like a PCM_gotoLPM0() that lets a simulated I2C slave answer.
+//
+//*****************************************************************************
+
+#ifdef LCD_SIM
+
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+
+#define SIM_WEAK __attribute__((weak))
+
+volatile uint16_t Sim_UCB1CTLW0;
+volatile uint16_t UCB1STATW;
+volatile uint16_t UCB1I2CSA;
+volatile uint16_t UCB1TXBUF;
+volatile uint16_t UCB1RXBUF;
+volatile uint16_t UCB1IE;
+volatile uint16_t UCB1IFG;
+
+volatile uint16_t Sim_UCB0STATW;
+volatile uint16_t Sim_UCB0IFG = UCTXIFG;
+volatile uint16_t UCB0TXBUF;
+
+Sim_DWT_Type Sim_DWT;
+Sim_CoreDebug_Type Sim_CoreDebug;
+
+SIM_WEAK volatile uint16_t *Sim_UCB1CTLW0_access(void)
+{
+    return &Sim_UCB1CTLW0;
+}
+
+SIM_WEAK volatile uint16_t *Sim_UCB0STATW_access(void)
+{
+    return &Sim_UCB0STATW;
+}
+
+SIM_WEAK volatile uint16_t *Sim_UCB0IFG_access(void)
+{
+    return &Sim_UCB0IFG;
+}
+
+SIM_WEAK void GPIO_setAsPeripheralModuleFunctionOutputPin(uint_fast8_t selectedPort,
+                                                          uint_fast16_t selectedPins,
+                                                          uint_fast8_t mode)
+{
+    (void)selectedPort;
+    (void)selectedPins;
+    (void)mode;
+}
+
+SIM_WEAK void GPIO_setAsInputPinWithPullUpResistor(uint_fast8_t selectedPort,
+                                                   uint_fast16_t selectedPins)
+{
+    (void)selectedPort;
+    (void)selectedPins;
+}
+
+SIM_WEAK uint8_t GPIO_getInputPinValue(uint_fast8_t selectedPort,
+                                       uint_fast16_t selectedPins)
+{
+    (void)selectedPort;
+    (void)selectedPins;
+
+    return GPIO_INPUT_PIN_HIGH;
+}
+
+SIM_WEAK void GPIO_interruptEdgeSelect(uint_fast8_t selectedPort,
+                                       uint_fast16_t selectedPins,
+                                       uint_fast8_t edgeSelect)
+{
+    (void)selectedPort;
+    (void)selectedPins;
+    (void)edgeSelect;
+}
+
+SIM_WEAK void GPIO_clearInterruptFlag(uint_fast8_t selectedPort,
+                                      uint_fast16_t selectedPins)
+{
+    (void)selectedPort;
+    (void)selectedPins;
+}
+
+SIM_WEAK void GPIO_enableInterrupt(uint_fast8_t selectedPort,
+                                   uint_fast16_t selectedPins)
+{
+    (void)selectedPort;
+    (void)selectedPins;
+}
+
+SIM_WEAK void GPIO_disableInterrupt(uint_fast8_t selectedPort,
+                                    uint_fast16_t selectedPins)
+{
+    (void)selectedPort;
+    (void)selectedPins;
+}
+
+SIM_WEAK uint_fast16_t GPIO_getEnabledInterruptStatus(uint_fast8_t selectedPort)
+{
+    (void)selectedPort;
+
+    return 0;
+}
+
+SIM_WEAK void GPIO_setAsOutputPin(uint_fast8_t selectedPort,
+                                  uint_fast16_t selectedPins)
+{
+    (void)selectedPort;
+    (void)selectedPins;
+}
+
+SIM_WEAK void GPIO_setOutputHighOnPin(uint_fast8_t selectedPort,
+                                      uint_fast16_t selectedPins)
+{
+    (void)selectedPort;
+    (void)selectedPins;
+}
+
+SIM_WEAK void GPIO_setOutputLowOnPin(uint_fast8_t selectedPort,
+                                     uint_fast16_t selectedPins)
+{
+    (void)selectedPort;
+    (void)selectedPins;
+}
+
+SIM_WEAK bool Interrupt_enableMaster(void)
+{
+    return true;
+}
+
+SIM_WEAK bool Interrupt_disableMaster(void)
+{
+    return false;
+}
+
+SIM_WEAK void Interrupt_enableInterrupt(uint32_t interruptNumber)
+{
+    (void)interruptNumber;
+}
+
+SIM_WEAK void Interrupt_disableInterrupt(uint32_t interruptNumber)
+{
+    (void)interruptNumber;
+}
+
+SIM_WEAK bool PCM_gotoLPM0(void)
+{
+    return true;
+}
+
+SIM_WEAK void Timer32_initModule(uint32_t timer, uint32_t preScaler,
+                                 uint32_t resolution, uint32_t mode)
+{
+    (void)timer;
+    (void)preScaler;
+    (void)resolution;
+    (void)mode;
+}
+
+SIM_WEAK void Timer32_setCount(uint32_t timer, uint32_t count)
+{
+    (void)timer;
+    (void)count;
+}
+
+SIM_WEAK void Timer32_startTimer(uint32_t timer, bool oneShot)
+{
+    (void)timer;
+    (void)oneShot;
+}
+
+SIM_WEAK uint32_t Timer32_getValue(uint32_t timer)
+{
+    (void)timer;
+
+    return 0xFFFFFFFF;
+}
+
+SIM_WEAK void Timer32_enableInterrupt(uint32_t timer)
+{
+    (void)timer;
+}
+
+SIM_WEAK void Timer32_clearInterruptFlag(uint32_t timer)
+{
+    (void)timer;
+}
+
+SIM_WEAK void Timer_A_configureUpMode(uint32_t timer,
+                                      const Timer_A_UpModeConfig *config)
+{
+    (void)timer;
+    (void)config;
+}
+
+SIM_WEAK void Timer_A_startCounter(uint32_t timer, uint_fast16_t timerMode)
+{
+    (void)timer;
+    (void)timerMode;
+}
+
+SIM_WEAK void Timer_A_stopTimer(uint32_t timer)
+{
+    (void)timer;
+}
+
+SIM_WEAK void Timer_A_clearCaptureCompareInterrupt(uint32_t timer,
+                                                   uint_fast16_t captureCompareRegister)
+{
+    (void)timer;
+    (void)captureCompareRegister;
+}
+
+SIM_WEAK void I2C_initMaster(uint32_t moduleInstance,
+                             const eUSCI_I2C_MasterConfig *config)
+{
+    (void)moduleInstance;
+    (void)config;
+}
+
+SIM_WEAK void I2C_enableModule(uint32_t moduleInstance)
+{
+    (void)moduleInstance;
+}
+
+SIM_WEAK void I2C_disableModule(uint32_t moduleInstance)
+{
+    (void)moduleInstance;
+}
+
+SIM_WEAK bool SPI_initMaster(uint32_t moduleInstance,
+                             const eUSCI_SPI_MasterConfig *config)
+{
+    (void)moduleInstance;
+    (void)config;
+
+    return true;
+}
+
+SIM_WEAK void SPI_enableModule(uint32_t moduleInstance)
+{
+    (void)moduleInstance;
+}
+
+SIM_WEAK uintptr_t SPI_getTransmitBufferAddressForDMA(uint32_t moduleInstance)
+{
+    (void)moduleInstance;
+
+    return (uintptr_t)&UCB0TXBUF;
+}
+
+SIM_WEAK void DMA_enableModule(void)
+{
+}
+
+SIM_WEAK void DMA_setControlBase(void *controlTable)
+{
+    (void)controlTable;
+}
+
+SIM_WEAK void DMA_assignChannel(uint32_t mapping)
+{
+    (void)mapping;
+}
+
+SIM_WEAK void DMA_disableChannelAttribute(uint32_t channelNum, uint32_t attr)
+{
+    (void)channelNum;
+    (void)attr;
+}
+
+SIM_WEAK void DMA_assignInterrupt(uint32_t interruptNumber, uint32_t channel)
+{
+    (void)interruptNumber;
+    (void)channel;
+}
+
+SIM_WEAK void DMA_enableInterrupt(uint32_t interruptNumber)
+{
+    (void)interruptNumber;
+}
+
+SIM_WEAK void DMA_clearInterruptFlag(uint32_t intChannel)
+{
+    (void)intChannel;
+}
+
+SIM_WEAK void DMA_setChannelControl(uint32_t channelStructIndex,
+                                    uint32_t control)
+{
+    (void)channelStructIndex;
+    (void)control;
+}
+
+SIM_WEAK void DMA_setChannelTransfer(uint32_t channelStructIndex,
+                                     uint32_t mode, void *srcAddr,
+                                     void *dstAddr, uint32_t transferSize)
+{
+    (void)channelStructIndex;
+    (void)mode;
+    (void)srcAddr;
+    (void)dstAddr;
+    (void)transferSize;
+}
+
+SIM_WEAK void DMA_enableChannel(uint32_t channelNum)
+{
+    (void)channelNum;
+}
+
+SIM_WEAK bool DMA_isChannelEnabled(uint32_t channelNum)
+{
+    (void)channelNum;
+
+    return false;
+}
+
+#endif /* LCD_SIM */
@@ -0,0 +1,101 @@
+//*****************************************************************************
+//
+// page_test.c - Checks the page navigation of display.c.
+//
+// next_page() and previous_page() must walk the room page and the city_count
+// city pages as a ring in both directions, including with no city and with a
+// single one, and bring a page number left over from a longer list back
+// into the ring.
+//
+// Build and run from lcd-part2, like lcd_bench (see lcd_sim.h):
+//
+//   gcc -DLCD_SIM -Isim/include -Isim/grlib/include -I. -o page_test
+//       sim/page_test.c sim/lcd_sim.c display.c history.c
+//       LcdDriver/Crystalfontz128x128_ST7735.c icons/*.c
+//       sim/grlib/grlib.c -lm && ./page_test
+//
+//*****************************************************************************
+
+#ifdef LCD_SIM
+
+#include <string.h>
+#include "sim_test.h"
+#include "weather.h"
+
+City_t cities[MAX_CITIES];
+uint16_t city_count = 0;
+
+int16_t TempService_getTemperature(void)
+{
+    return 0;
+}
+
+//
+// Walks count + 1 steps each way from the room page and checks that every
+// page is met exactly once, in order, before coming back to the room.
+//
+static void Test_ring(uint16_t count)
+{
+    uint16_t page;
+    uint16_t step;
+
+    city_count = count;
+
+    page = 0;
+    for (step = 1; step <= count; step++)
+    {
+        page = next_page(page);
+        SIM_TEST_EQUAL(page, step);
+        SIM_TEST_EQUAL(page_state(page), STATE_CITY);
+    }
+    SIM_TEST_EQUAL(next_page(page), 0);
+
+    page = 0;
+    for (step = 1; step <= count; step++)
+    {
+        page = previous_page(page);
+        SIM_TEST_EQUAL(page, count + 1 - step);
+    }
+    SIM_TEST_EQUAL(previous_page(page), 0);
+
+    for (page = 0; page <= count; page++)
+    {
+        SIM_TEST_EQUAL(previous_page(next_page(page)), page);
+        SIM_TEST_EQUAL(next_page(previous_page(page)), page);
+    }
+
+    //
+    // Page past the end, as after the list got shorter.
+    //
+    SIM_TEST_EQUAL(next_page(count + 1), 0);
+    SIM_TEST_EQUAL(previous_page(count + 1), count);
+}
+
+int main(void)
+{
+    //
+    // No city: both buttons stay on the room page.
+    //
+    city_count = 0;
+    SIM_TEST_EQUAL(next_page(0), 0);
+    SIM_TEST_EQUAL(previous_page(0), 0);
+    SIM_TEST_EQUAL(page_state(0), STATE_TEMP);
+    Test_ring(0);
+
+    //
+    // One city: both buttons toggle between the room and that city.
+    //
+    city_count = 1;
+    SIM_TEST_EQUAL(next_page(0), 1);
+    SIM_TEST_EQUAL(next_page(1), 0);
+    SIM_TEST_EQUAL(previous_page(0), 1);
+    SIM_TEST_EQUAL(previous_page(1), 0);
+    Test_ring(1);
+
+    Test_ring(4);
+    Test_ring(MAX_CITIES);
+
+    return Sim_Test_report("page_test");
+}
+
+#endif /* LCD_SIM */
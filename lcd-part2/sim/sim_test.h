@@ -0,0 +1,62 @@
+//*****************************************************************************
+//
+// sim_test.h - Checks shared by the host tests in sim/.
+//
+// Each test is a program of its own, built with a gcc line given in its
+// header comment.  A failed check prints where it is and what it compared,
+// and the program exits with 1 if any check failed, 0 if all passed:
+//
+//   int main(void)
+//   {
+//       SIM_TEST_EQUAL(next_page(0), 1);
+//       return Sim_Test_report("page_test");
+//   }
+//
+//*****************************************************************************
+
+#ifndef __SIM_TEST_H__
+#define __SIM_TEST_H__
+
+#include <stdio.h>
+
+static int Sim_Test_failures;
+static int Sim_Test_checks;
+
+#define SIM_TEST_CHECK(condition)                                           \
+    do                                                                      \
+    {                                                                       \
+        Sim_Test_checks++;                                                  \
+        if (!(condition))                                                   \
+        {                                                                   \
+            printf("%s:%d: failed: %s\n", __FILE__, __LINE__, #condition);  \
+            Sim_Test_failures++;                                            \
+        }                                                                   \
+    } while (0)
+
+#define SIM_TEST_EQUAL(actual, expected)                                    \
+    do                                                                      \
+    {                                                                       \
+        long long simActual = (long long)(actual);                          \
+        long long simExpected = (long long)(expected);                      \
+        Sim_Test_checks++;                                                  \
+        if (simActual != simExpected)                                       \
+        {                                                                   \
+            printf("%s:%d: failed: %s is %lld, expected %s (%lld)\n",       \
+                   __FILE__, __LINE__, #actual, simActual, #expected,       \
+                   simExpected);                                            \
+            Sim_Test_failures++;                                            \
+        }                                                                   \
+    } while (0)
+
+//
+// Prints the totals and returns the exit status of the test.
+//
+static inline int Sim_Test_report(const char *name)
+{
+    printf("%s: %d checks, %d failed\n", name, Sim_Test_checks,
+           Sim_Test_failures);
+
+    return (Sim_Test_failures > 0) ? 1 : 0;
+}
+
+#endif /* __SIM_TEST_H__ */
@@ -0,0 +1,290 @@
+//*****************************************************************************
+//
+// temp_filter_test.c - Checks the room temperature filter of temp_service.c.
+//
+// Feeds TempFilter_add() readings in tenths of degree Celsius and checks
+// that:
+//
+//   - a steady reading comes out unchanged from the first one on,
+//   - the median of TEMP_FILTER_SIZE readings drops single and double
+//     spikes, up or down, without moving the output,
+//   - after a step the output starts moving once the median has taken it,
+//     by 1 / 2^TEMP_FILTER_SHIFT of the step, then converges to the new
+//     value without overshooting it, rising as well as falling,
+//   - noise of a tenth around a value stays within that tenth.
+//
+// It also runs the sampling tick of temp_service.c against stand-ins of the
+// I2C and TMP006 HALs and checks that the two registers read reach
+// TMP006_calcTemp() and History_add(), that the cycles of the calculation
+// are counted, that a failed read drops the sample and that no read is
+// queued while the previous ones are pending.
+//
+// Build and run from lcd-part2:
+//
+//   gcc -DLCD_SIM -Wall -Wextra -Isim/include -Isim/grlib/include -I.
+//       -o temp_filter_test sim/temp_filter_test.c sim/msp432_sim.c
+//       temp_service.c && ./temp_filter_test
+//
+//*****************************************************************************
+
+#ifdef LCD_SIM
+
+#include <stdlib.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "sim_test.h"
+#include "temp_service.h"
+#include "history.h"
+#include "HAL/HAL_I2C.h"
+#include "HAL/HAL_TMP006.h"
+
+extern void T32_INT2_IRQHandler(void);
+
+// Readings after which a step must have been followed to the tenth
+#define TEST_SETTLE     30
+
+// Cycles the TMP006_calcTemp() stand-in moves the DWT cycle counter by
+#define TEST_CALC_CYCLES    1234
+
+//
+// What temp_service.c uses besides the filter. The reads submitted are kept
+// for the test to complete, the registers given to TMP006_calcTemp() and the
+// samples added to the history are counted. The calculation takes
+// TEST_CALC_CYCLES of the DWT cycle counter.
+//
+static I2C_Transaction *Test_submitted[2];
+static uint8_t Test_submits;
+static int16_t Test_vobj, Test_tdie;
+static uint8_t Test_calcs, Test_added;
+
+float TMP006_getTemp(void)
+{
+    return 0;
+}
+
+float TMP006_calcTemp(int16_t vobj, int16_t tdie)
+{
+    Test_vobj = vobj;
+    Test_tdie = tdie;
+    Test_calcs++;
+    DWT->CYCCNT += TEST_CALC_CYCLES;
+
+    return 0;
+}
+
+bool I2C_submit(I2C_Transaction *transaction)
+{
+    if (Test_submits < 2)
+    {
+        transaction->status = I2C_PENDING;
+        Test_submitted[Test_submits] = transaction;
+    }
+    Test_submits++;
+
+    return true;
+}
+
+void History_init(void)
+{
+}
+
+void History_add(int16_t temperature)
+{
+    (void)temperature;
+
+    Test_added++;
+}
+
+//
+// Starts the filter on value and fills its ring with it.
+//
+static void Test_steady(TempFilter_t *filter, int16_t value)
+{
+    uint8_t i;
+
+    TempFilter_init(filter, value);
+    for (i = 1; i < TEMP_FILTER_SIZE; i++)
+    {
+        SIM_TEST_EQUAL(TempFilter_add(filter, value), value);
+    }
+}
+
+static void Test_spikes(void)
+{
+    TempFilter_t filter;
+
+    Test_steady(&filter, 215);
+
+    SIM_TEST_EQUAL(TempFilter_add(&filter, 900), 215);
+    SIM_TEST_EQUAL(TempFilter_add(&filter, 215), 215);
+    SIM_TEST_EQUAL(TempFilter_add(&filter, -400), 215);
+    SIM_TEST_EQUAL(TempFilter_add(&filter, 215), 215);
+    SIM_TEST_EQUAL(TempFilter_add(&filter, 215), 215);
+
+    //
+    // Two in a row are still the minority of the ring.
+    //
+    SIM_TEST_EQUAL(TempFilter_add(&filter, 900), 215);
+    SIM_TEST_EQUAL(TempFilter_add(&filter, 900), 215);
+    SIM_TEST_EQUAL(TempFilter_add(&filter, 215), 215);
+    SIM_TEST_EQUAL(TempFilter_add(&filter, -400), 215);
+    SIM_TEST_EQUAL(TempFilter_add(&filter, -400), 215);
+    SIM_TEST_EQUAL(TempFilter_add(&filter, 215), 215);
+}
+
+static void Test_step(int16_t from, int16_t to)
+{
+    TempFilter_t filter;
+    int16_t previous, output;
+    int16_t quarter = from + (to - from) / (1 << TEMP_FILTER_SHIFT);
+    uint8_t i;
+
+    Test_steady(&filter, from);
+
+    //
+    // The median holds the old value until the new one is the majority.
+    //
+    for (i = 0; i < TEMP_FILTER_SIZE / 2; i++)
+    {
+        SIM_TEST_EQUAL(TempFilter_add(&filter, to), from);
+    }
+    SIM_TEST_EQUAL(TempFilter_add(&filter, to), quarter);
+
+    previous = quarter;
+    for (i = 0; i < TEST_SETTLE; i++)
+    {
+        output = TempFilter_add(&filter, to);
+        if (to > from)
+        {
+            SIM_TEST_CHECK((output >= previous) && (output <= to));
+        }
+        else
+        {
+            SIM_TEST_CHECK((output <= previous) && (output >= to));
+        }
+        previous = output;
+    }
+    SIM_TEST_EQUAL(previous, to);
+
+    //
+    // And stays there.
+    //
+    SIM_TEST_EQUAL(TempFilter_add(&filter, to), to);
+}
+
+static void Test_noise(void)
+{
+    TempFilter_t filter;
+    int16_t output;
+    uint16_t i;
+
+    Test_steady(&filter, 215);
+
+    srand(1);
+    for (i = 0; i < 1000; i++)
+    {
+        output = TempFilter_add(&filter, 214 + rand() % 3);
+        SIM_TEST_CHECK((output >= 214) && (output <= 216));
+    }
+}
+
+//
+// Completes the reads of a tick the way the I2C interrupt does, in order,
+// with the register values given or a NACK.
+//
+static void Test_complete(uint16_t vobj, I2C_Status vobjStatus, uint16_t tdie,
+                          I2C_Status tdieStatus)
+{
+    uint16_t values[2] = { vobj, tdie };
+    I2C_Status status[2] = { vobjStatus, tdieStatus };
+    I2C_Transaction *transaction;
+    uint8_t i;
+
+    for (i = 0; i < 2; i++)
+    {
+        transaction = Test_submitted[i];
+        transaction->data[0] = values[i] >> 8;
+        transaction->data[1] = values[i] & 0xFF;
+        transaction->status = status[i];
+        if (transaction->callback)
+        {
+            transaction->callback(transaction);
+        }
+    }
+}
+
+static void Test_sampling(void)
+{
+    TempService_init();
+    SIM_TEST_CHECK(CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk);
+    SIM_TEST_CHECK(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk);
+
+    //
+    // A tick queues the object voltage then the die temperature, and their
+    // completion makes one sample of the two registers. The cycle counter
+    // wraps around during the calculation.
+    //
+    DWT->CYCCNT = 0xFFFFFF00;
+    T32_INT2_IRQHandler();
+    SIM_TEST_EQUAL(Test_submits, 2);
+    SIM_TEST_EQUAL(Test_submitted[0]->reg, TMP006_P_VOBJ);
+    SIM_TEST_EQUAL(Test_submitted[1]->reg, TMP006_P_TABT);
+    Test_complete(0xFF38, I2C_DONE, 0x0C80, I2C_DONE);
+    SIM_TEST_EQUAL(Test_calcs, 1);
+    SIM_TEST_EQUAL(Test_vobj, -200);
+    SIM_TEST_EQUAL(Test_tdie, 0x0C80);
+    SIM_TEST_EQUAL(Test_added, 1);
+    SIM_TEST_EQUAL(TempService_getCalcCycles(), TEST_CALC_CYCLES);
+
+    //
+    // Nothing is queued while the reads of the last tick are pending.
+    //
+    Test_submits = 0;
+    T32_INT2_IRQHandler();
+    SIM_TEST_EQUAL(Test_submits, 2);
+    T32_INT2_IRQHandler();
+    SIM_TEST_EQUAL(Test_submits, 2);
+
+    //
+    // A NACK on either register drops the sample.
+    //
+    Test_complete(0x0010, I2C_NACK, 0x0C80, I2C_DONE);
+    Test_submits = 0;
+    T32_INT2_IRQHandler();
+    Test_complete(0x0010, I2C_DONE, 0x0C80, I2C_NACK);
+    SIM_TEST_EQUAL(Test_calcs, 1);
+    SIM_TEST_EQUAL(Test_added, 1);
+
+    //
+    // And the next good tick samples again.
+    //
+    Test_submits = 0;
+    T32_INT2_IRQHandler();
+    Test_complete(0x0010, I2C_DONE, 0x0D00, I2C_DONE);
+    SIM_TEST_EQUAL(Test_calcs, 2);
+    SIM_TEST_EQUAL(Test_vobj, 16);
+    SIM_TEST_EQUAL(Test_tdie, 0x0D00);
+    SIM_TEST_EQUAL(Test_added, 2);
+}
+
+int main(void)
+{
+    TempFilter_t filter;
+
+    //
+    // No start-up transient, the first reading fills the average.
+    //
+    TempFilter_init(&filter, 215);
+    SIM_TEST_EQUAL(TempFilter_add(&filter, 215), 215);
+
+    Test_spikes();
+    Test_step(200, 300);
+    Test_step(300, -100);
+    Test_step(-100, -99);
+    Test_step(216, 215);
+    Test_noise();
+    Test_sampling();
+
+    return Sim_Test_report("temp_filter_test");
+}
+
+#endif /* LCD_SIM */
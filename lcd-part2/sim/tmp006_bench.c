@@ -0,0 +1,163 @@
+//*****************************************************************************
+//
+// tmp006_bench.c - Accuracy and speed of TMP006_calcTemp() on the host.
+//
+// Usage: tmp006_bench
+//
+// Compares TMP006_calcTemp() with the long double model TMP006_getTemp()
+// used before, over every die temperature register value from -40 to 125 C
+// and object voltages from -5 to 5 mV giving an object temperature in the
+// same range, and fails if they differ by 0.05 C or more anywhere. Then times
+// both on the host.
+//
+// Build from lcd-part2 with:
+//
+//   gcc -DLCD_SIM -Wall -Wextra -Isim/include -I. -O2 -o tmp006_bench
+//       sim/tmp006_bench.c HAL/HAL_TMP006.c -lm
+//
+//*****************************************************************************
+
+#ifdef LCD_SIM
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include "HAL/HAL_TMP006.h"
+
+// Largest difference allowed with the reference model, in Celsius
+#define BENCH_TOLERANCE         0.05
+
+// Die and object temperature range of the sensor, in Celsius
+#define BENCH_TEMP_MIN          -40
+#define BENCH_TEMP_MAX          125
+
+// Step between object voltage register values, 156.25 nV each
+#define BENCH_VOBJ_STEP         7
+
+// Calculations timed per model
+#define BENCH_CALCULATIONS      1000000
+
+//
+// The register reads of HAL_TMP006.c, unused here.
+//
+void I2C_setslave(unsigned int slaveAdr)
+{
+    (void)slaveAdr;
+}
+
+int I2C_read16(unsigned char writeByte)
+{
+    (void)writeByte;
+
+    return 0;
+}
+
+void I2C_write16(unsigned char pointer, unsigned int writeByte)
+{
+    (void)pointer;
+    (void)writeByte;
+}
+
+//
+// Model of TMP006_getTemp() before TMP006_calcTemp(), in Fahrenheit.
+//
+static long double Bench_reference(int Vobj, int Tdie)
+{
+    Tdie = Tdie >> 2;
+
+    long double Vobj2 = (double)Vobj*.00000015625;
+    long double Tdie2 = (double)Tdie*.03525 + 273.15;
+
+    long double S0 = 6 * pow(10, -14);
+    long double a1 = 1.75*pow(10, -3);
+    long double a2 = -1.678*pow(10, -5);
+    long double b0 = -2.94*pow(10, -5);
+    long double b1 = -5.7*pow(10, -7);
+    long double b2 = 4.63*pow(10, -9);
+    long double c2 = 13.4;
+    long double Tref = 298.15;
+
+    long double S = S0*(1+a1*(Tdie2 - Tref)+a2*pow((Tdie2 - Tref),2));
+    long double Vos = b0 + b1*(Tdie2 - Tref) + b2*pow((Tdie2 - Tref),2);
+    long double fObj = (Vobj2 - Vos) + c2*pow((Vobj2 - Vos),2);
+    long double Tobj = pow(pow(Tdie2,4) + (fObj/S),.25);
+
+    return (9.0/5.0)*(Tobj - 273.15) + 32;
+}
+
+static double Bench_seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(void)
+{
+    int tdie, vobj, worstTdie = 0, worstVobj = 0;
+    unsigned long count = 0;
+    double error, worst = 0;
+    volatile long double sink;
+    double start, reference, single;
+    int i;
+
+    //
+    // Register values, the die temperature is left aligned by 2 bits and
+    // reads 1/32 C per LSB.
+    //
+    for (tdie = (int)(BENCH_TEMP_MIN / 0.03125) * 4;
+         tdie <= (int)(BENCH_TEMP_MAX / 0.03125) * 4; tdie += 4)
+    {
+        for (vobj = -32000; vobj <= 32000; vobj += BENCH_VOBJ_STEP)
+        {
+            long double expected = Bench_reference(vobj, tdie);
+            long double celsius = (expected - 32) / 1.8;
+
+            if (!(celsius >= BENCH_TEMP_MIN && celsius <= BENCH_TEMP_MAX))
+            {
+                continue;
+            }
+            error = fabs((double)(TMP006_calcTemp(vobj, tdie) - expected))
+                    / 1.8;
+            count++;
+            if (!(error < worst))
+            {
+                worst = error;
+                worstTdie = tdie;
+                worstVobj = vobj;
+            }
+        }
+    }
+
+    printf("%lu readings, largest difference %.5f C (tdie 0x%04x, "
+           "vobj %d)\n", count, worst, worstTdie & 0xFFFF, worstVobj);
+
+    start = Bench_seconds();
+    for (i = 0; i < BENCH_CALCULATIONS; i++)
+    {
+        sink = Bench_reference(i & 0x3FF, 0x3200);
+    }
+    reference = Bench_seconds() - start;
+
+    start = Bench_seconds();
+    for (i = 0; i < BENCH_CALCULATIONS; i++)
+    {
+        sink = TMP006_calcTemp(i & 0x3FF, 0x3200);
+    }
+    single = Bench_seconds() - start;
+    (void)sink;
+
+    printf("long double %.1f ns, single precision %.1f ns per reading\n",
+           reference * 1e9 / BENCH_CALCULATIONS,
+           single * 1e9 / BENCH_CALCULATIONS);
+
+    if (!(worst < BENCH_TOLERANCE))
+    {
+        printf("FAILED, tolerance is %.2f C\n", BENCH_TOLERANCE);
+        return 1;
+    }
+    return 0;
+}
+
+#endif /* LCD_SIM */
@@ -0,0 +1,162 @@
+/* Background sampling of the room temperature, see temp_service.h. */
+#include <stddef.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "HAL/HAL_I2C.h"
+#include "HAL/HAL_TMP006.h"
+#include "temp_service.h"
+#include "history.h"
+
+/* Filter and its latest output. */
+static TempFilter_t filter;
+static volatile int16_t temperature;
+
+/* MCU cycles spent in TMP006_calcTemp() for the latest sample. */
+static volatile uint32_t calc_cycles;
+
+/* Register reads queued at every tick, the second completes the sample and
+ * carries the first as its context. */
+static uint8_t vobj_data[2];
+static uint8_t tdie_data[2];
+static void TempService_sampled(I2C_Transaction *transaction);
+static I2C_Transaction vobj_read = {
+    .slave = TMP006_SLAVE_ADDRESS,
+    .reg = TMP006_P_VOBJ,
+    .read = true,
+    .length = 2,
+    .data = vobj_data,
+    .status = I2C_DONE,
+    .callback = NULL,
+    .context = NULL
+};
+static I2C_Transaction tdie_read = {
+    .slave = TMP006_SLAVE_ADDRESS,
+    .reg = TMP006_P_TABT,
+    .read = true,
+    .length = 2,
+    .data = tdie_data,
+    .status = I2C_DONE,
+    .callback = TempService_sampled,
+    .context = &vobj_read
+};
+
+/* Object temperature in Fahrenheit to tenths of degree Celsius, rounded. */
+static int16_t TempService_tenths(float fahrenheit)
+{
+    float tenths = (fahrenheit - 32) * (10 / 1.8f);
+
+    return (int16_t) (tenths + ((tenths < 0) ? -0.5f : 0.5f));
+}
+
+void TempFilter_init(TempFilter_t *filter, int16_t sample)
+{
+    filter->samples[0] = sample;
+    filter->count = 1;
+    filter->next = 1;
+    filter->average = (int32_t) sample << TEMP_FILTER_SHIFT;
+}
+
+int16_t TempFilter_add(TempFilter_t *filter, int16_t sample)
+{
+    int16_t sorted[TEMP_FILTER_SIZE];
+    int16_t value, rounded;
+    uint8_t i, j;
+
+    filter->samples[filter->next] = sample;
+    filter->next = (filter->next + 1) % TEMP_FILTER_SIZE;
+    if (filter->count < TEMP_FILTER_SIZE)
+    {
+        filter->count++;
+    }
+
+    /* Median by insertion sort, the ring is only a few readings long. */
+    for (i = 0; i < filter->count; i++)
+    {
+        value = filter->samples[i];
+        for (j = i; j > 0 && sorted[j - 1] > value; j--)
+        {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = value;
+    }
+
+    /* Moving average of the medians, kept with TEMP_FILTER_SHIFT extra bits.
+     * The average is rounded the same way when it is fed back, truncating it
+     * would leave it up to 3/4 of a tenth above a falling temperature. */
+    rounded = (int16_t) ((filter->average + (1 << (TEMP_FILTER_SHIFT - 1)))
+            >> TEMP_FILTER_SHIFT);
+    filter->average += sorted[filter->count / 2] - rounded;
+
+    return (int16_t) ((filter->average + (1 << (TEMP_FILTER_SHIFT - 1)))
+            >> TEMP_FILTER_SHIFT);
+}
+
+void TempService_init(void)
+{
+    /* One blocking reading so the room page has a value from the start. */
+    temperature = TempService_tenths(TMP006_getTemp());
+    TempFilter_init(&filter, temperature);
+    History_init();
+
+    /* Starts the cycle counter of the core. */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    Timer32_initModule(TEMP_SERVICE_TIMER, TIMER32_PRESCALER_1, TIMER32_32BIT,
+                       TIMER32_PERIODIC_MODE);
+    Timer32_setCount(TEMP_SERVICE_TIMER, TEMP_SERVICE_PERIOD);
+    Timer32_enableInterrupt(TEMP_SERVICE_TIMER);
+    Interrupt_enableInterrupt(TEMP_SERVICE_INT);
+    Timer32_startTimer(TEMP_SERVICE_TIMER, false);
+}
+
+int16_t TempService_getTemperature(void)
+{
+    return temperature;
+}
+
+uint32_t TempService_getCalcCycles(void)
+{
+    return calc_cycles;
+}
+
+/* Both registers are in, called from the I2C interrupt with the die
+ * temperature read, the object voltage read being its context. */
+static void TempService_sampled(I2C_Transaction *transaction)
+{
+    const I2C_Transaction *vobj_transaction = transaction->context;
+    int16_t vobj, tdie;
+    uint32_t start;
+    float fahrenheit;
+
+    if (vobj_transaction->status != I2C_DONE || transaction->status != I2C_DONE)
+    {
+        return;
+    }
+
+    vobj = (int16_t) ((vobj_transaction->data[0] << 8)
+            | vobj_transaction->data[1]);
+    tdie = (int16_t) ((transaction->data[0] << 8) | transaction->data[1]);
+
+    start = DWT->CYCCNT;
+    fahrenheit = TMP006_calcTemp(vobj, tdie);
+    calc_cycles = DWT->CYCCNT - start;
+
+    temperature = TempFilter_add(&filter, TempService_tenths(fahrenheit));
+    History_add(temperature);
+}
+
+/* Sampling tick, queues the register reads unless the last ones are pending. */
+void T32_INT2_IRQHandler(void)
+{
+    Timer32_clearInterruptFlag(TEMP_SERVICE_TIMER);
+
+    if (vobj_read.status == I2C_PENDING || tdie_read.status == I2C_PENDING)
+    {
+        return;
+    }
+
+    if (I2C_submit(&vobj_read))
+    {
+        I2C_submit(&tdie_read);
+    }
+}
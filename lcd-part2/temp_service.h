@@ -0,0 +1,75 @@
+/**
+ * Background sampling of the room temperature.
+ *
+ * A Timer32 interrupt queues a read of the TMP006 registers on the I2C bus
+ * at the conversion rate of the sensor. When it completes, the object
+ * temperature goes through a median of the last TEMP_FILTER_SIZE readings,
+ * which drops single outliers, and an exponential moving average, which
+ * smooths the noise. display_temp() only reads the filtered value, so the
+ * room page draws without waiting for the sensor. Every filtered value is
+ * also recorded by history.c.
+ */
+#ifndef __TEMP_SERVICE_H__
+#define __TEMP_SERVICE_H__
+
+#include <stdint.h>
+
+/* Timer32 module and its interrupt pacing the samples. */
+#define TEMP_SERVICE_TIMER TIMER32_1_BASE
+#define TEMP_SERVICE_INT INT_T32_INT2
+
+/* Time between samples in MCLK cycles, 0.5 s like the sensor conversions
+ * set up by TMP006_init(). */
+#define TEMP_SERVICE_PERIOD 24000000
+
+/* Readings in the median, odd. */
+#define TEMP_FILTER_SIZE 5
+
+/* The moving average follows the medians by 1 / 2^TEMP_FILTER_SHIFT. */
+#define TEMP_FILTER_SHIFT 2
+
+/**
+ * Filter state, in tenths of degree Celsius.
+ *
+ * samples -> ring of the last readings.
+ * count -> readings in samples, up to TEMP_FILTER_SIZE.
+ * next -> slot of samples written next.
+ * average -> moving average scaled by 2^TEMP_FILTER_SHIFT.
+ */
+typedef struct
+{
+    int16_t samples[TEMP_FILTER_SIZE];
+    uint8_t count;
+    uint8_t next;
+    int32_t average;
+} TempFilter_t;
+
+/**
+ * Starts the filter from a first reading.
+ */
+void TempFilter_init(TempFilter_t *filter, int16_t sample);
+
+/**
+ * Adds a reading and returns the filtered temperature. Uses no hardware,
+ * so it can be fed recorded readings on the host.
+ */
+int16_t TempFilter_add(TempFilter_t *filter, int16_t sample);
+
+/**
+ * Takes a first reading of the sensor, then starts the periodic sampling.
+ * TMP006_init() must have been called.
+ */
+void TempService_init(void);
+
+/**
+ * Latest filtered room temperature in tenths of degree Celsius.
+ */
+int16_t TempService_getTemperature(void);
+
+/**
+ * MCU cycles TMP006_calcTemp() took for the latest sample, counted by the
+ * DWT cycle counter TempService_init() starts.
+ */
+uint32_t TempService_getCalcCycles(void);
+
+#endif
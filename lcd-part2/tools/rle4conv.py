@@ -0,0 +1,285 @@
+#!/usr/bin/env python3
+"""Converts icons to the grlib IMAGE_FMT_4BPP_COMP_RLE4 format.
+
+Each byte of the compressed data holds a run: the upper nibble is the run
+length minus one (1 to 16 pixels) and the lower nibble the palette index.
+Runs continue from the end of one row to the start of the next, which is how
+Crystalfontz128x128_DrawImage() and Graphics_drawImage() read them.
+
+Inputs can be an uncompressed 4bpp icon in C (the JSFormer output found in
+icons/) or a binary PPM (P6) image with at most 16 colors.
+
+    rle4conv.py sunny.c -o sunny.c           convert an icon in place
+    rle4conv.py moon.ppm --name moon -o moon.c
+    rle4conv.py --verify sunny_uncomp.c sunny.c
+    rle4conv.py --self-test
+
+Every conversion is decoded again and compared with its input before the
+output is written.
+"""
+
+import argparse
+import os
+import random
+import re
+import sys
+
+MAX_RUN = 16
+
+
+def encode(pixels):
+    """Compresses a list of palette indices into RLE4 bytes."""
+    data = []
+    i = 0
+    while i < len(pixels):
+        index = pixels[i]
+        run = 1
+        while (i + run < len(pixels) and run < MAX_RUN and
+               pixels[i + run] == index):
+            run += 1
+        data.append(((run - 1) << 4) | index)
+        i += run
+    return data
+
+
+def decode(data, count):
+    """Expands RLE4 bytes back into count palette indices."""
+    pixels = []
+    for byte in data:
+        pixels.extend([byte & 0x0F] * ((byte >> 4) + 1))
+    if len(pixels) != count:
+        raise ValueError("RLE4 data holds %d pixels, expected %d" %
+                         (len(pixels), count))
+    return pixels
+
+
+def _c_array(source, prefix):
+    match = re.search(r"\b%s\w*\[\]\s*=\s*\{(.*?)\};" % prefix, source, re.S)
+    if not match:
+        raise ValueError("no %s array found" % prefix)
+    return [int(value, 16) for value in re.findall(r"0x[0-9a-fA-F]+",
+                                                   match.group(1))]
+
+
+def read_c(path):
+    """Reads a C icon. Returns (width, height, palette, pixels)."""
+    with open(path) as f:
+        source = f.read()
+
+    image = re.search(r"const\s+Graphics_Image\s+\w+\s*=\s*\{\s*(\w+)\s*,"
+                      r"\s*(\d+)\s*,\s*(\d+)\s*,", source)
+    if not image:
+        raise ValueError("%s: no Graphics_Image found" % path)
+    fmt, width, height = image.group(1), int(image.group(2)), \
+        int(image.group(3))
+
+    palette = _c_array(source, "palette_")
+    data = _c_array(source, "pixel_")
+
+    if fmt == "IMAGE_FMT_4BPP_COMP_RLE4":
+        pixels = decode(data, width * height)
+    elif fmt == "IMAGE_FMT_4BPP_UNCOMP":
+        stride = (width + 1) // 2
+        pixels = []
+        for y in range(height):
+            for x in range(width):
+                byte = data[y * stride + x // 2]
+                pixels.append(byte >> 4 if x % 2 == 0 else byte & 0x0F)
+    else:
+        raise ValueError("%s: unsupported format %s" % (path, fmt))
+
+    return width, height, palette, pixels
+
+
+def read_ppm(path):
+    """Reads a binary PPM. Returns (width, height, palette, pixels)."""
+    with open(path, "rb") as f:
+        content = f.read()
+
+    fields = []
+    position = 0
+    while len(fields) < 4:
+        match = re.compile(rb"\s*(#[^\n]*\n\s*)*(\S+)").match(content,
+                                                               position)
+        fields.append(match.group(2))
+        position = match.end()
+    if fields[0] != b"P6" or int(fields[3]) != 255:
+        raise ValueError("%s: only 8-bit binary PPM (P6) is supported" % path)
+    width, height = int(fields[1]), int(fields[2])
+    raster = content[position + 1:position + 1 + width * height * 3]
+
+    palette = []
+    pixels = []
+    for i in range(0, len(raster), 3):
+        color = (raster[i] << 16) | (raster[i + 1] << 8) | raster[i + 2]
+        if color not in palette:
+            if len(palette) == 16:
+                raise ValueError("%s: more than 16 colors" % path)
+            palette.append(color)
+        pixels.append(palette.index(color))
+
+    return width, height, palette, pixels
+
+
+def read_image(path):
+    if path.endswith(".ppm"):
+        return read_ppm(path)
+    return read_c(path)
+
+
+def _hex_rows(values, digits, per_row):
+    rows = []
+    for i in range(0, len(values), per_row):
+        rows.append("    " + ",".join("0x%0*x" % (digits, value)
+                                      for value in values[i:i + per_row]))
+    return ",\n".join(rows)
+
+
+def write_c(path, name, width, height, palette, data):
+    colors = len(palette)
+    text = """/** Generated with rle4conv.py
+  *
+  * Image name: %(name)s
+  * %(width)dx%(height)d@4bpp (%(colors)d colors), RLE4 compressed (%(size)d bytes)
+  */
+
+#include <ti/grlib/grlib.h>
+
+static const uint8_t pixel_image4BPP_COMP_RLE4[] = {
+%(pixels)s
+};
+
+static const uint32_t palette_image4BPP_COMP_RLE4[] = {
+%(palette)s
+};
+
+const Graphics_Image %(name)s = {
+    IMAGE_FMT_4BPP_COMP_RLE4,
+    %(width)d,
+    %(height)d,
+    %(colors)d,
+    palette_image4BPP_COMP_RLE4,
+    pixel_image4BPP_COMP_RLE4
+};
+""" % {"name": name, "width": width, "height": height, "colors": colors,
+       "size": len(data), "pixels": _hex_rows(data, 2, 8),
+       "palette": _hex_rows(palette, 6, 4)}
+
+    if path == "-":
+        sys.stdout.write(text)
+    else:
+        with open(path, "w") as f:
+            f.write(text)
+
+
+def convert(source, output, name):
+    width, height, palette, pixels = read_image(source)
+
+    # Only keep the palette entries the image can reach
+    palette = palette[:max(pixels) + 1]
+
+    data = encode(pixels)
+    if decode(data, width * height) != pixels:
+        raise ValueError("%s: round trip mismatch" % source)
+
+    write_c(output, name, width, height, palette, data)
+    return width * height // 2, len(data)
+
+
+def verify(original, compressed):
+    """Checks that two icons hold the same pixels and colors."""
+    width, height, palette, pixels = read_image(original)
+    cwidth, cheight, cpalette, cpixels = read_image(compressed)
+    if (width, height) != (cwidth, cheight):
+        return "size differs"
+    for a, b in zip(pixels, cpixels):
+        if palette[a] != cpalette[b]:
+            return "pixels differ"
+    return None
+
+
+def self_test():
+    """Round trips edge cases and random images through encode/decode and
+    through the generated C source."""
+    import tempfile
+
+    cases = [
+        [0] * 576,
+        [15] * 16 + [15] + [3],
+        [i % 16 for i in range(576)],
+        [1] * 17 + [2] * 32 + [1] * 15,
+    ]
+    generator = random.Random(1)
+    for _ in range(200):
+        length = generator.randint(1, 576)
+        colors = generator.randint(1, 16)
+        pixels = []
+        while len(pixels) < length:
+            pixels.extend([generator.randrange(colors)] *
+                          generator.randint(1, 40))
+        cases.append(pixels[:length])
+
+    for pixels in cases:
+        if decode(encode(pixels), len(pixels)) != pixels:
+            print("self test failed: %r" % pixels[:32])
+            return 1
+
+    directory = tempfile.mkdtemp()
+    source = os.path.join(directory, "source.ppm")
+    output = os.path.join(directory, "output.c")
+    width, height = 24, 24
+    palette = [generator.randrange(1 << 24) for _ in range(16)]
+    pixels = cases[-1][:width * height]
+    pixels += [0] * (width * height - len(pixels))
+    with open(source, "wb") as f:
+        f.write(b"P6\n%d %d\n255\n" % (width, height))
+        f.write(bytes(sum(([palette[i] >> 16, (palette[i] >> 8) & 255,
+                            palette[i] & 255] for i in pixels), [])))
+    convert(source, output, "test")
+    error = verify(source, output)
+    if error:
+        print("self test failed: %s" % error)
+        return 1
+
+    print("self test passed: %d cases" % (len(cases) + 1))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("input", nargs="?", help="C icon or PPM image")
+    parser.add_argument("compressed", nargs="?",
+                        help="compressed icon to check with --verify")
+    parser.add_argument("-o", "--output", default="-",
+                        help="output C file (default: stdout)")
+    parser.add_argument("--name", help="Graphics_Image symbol name "
+                        "(default: input file name)")
+    parser.add_argument("--verify", action="store_true",
+                        help="compare input with an already compressed icon")
+    parser.add_argument("--self-test", action="store_true",
+                        help="run the round trip tests")
+    args = parser.parse_args()
+
+    if args.self_test:
+        return self_test()
+    if not args.input:
+        parser.error("an input file is required")
+
+    if args.verify:
+        if not args.compressed:
+            parser.error("--verify needs the compressed icon")
+        error = verify(args.input, args.compressed)
+        if error:
+            print("%s: %s" % (args.compressed, error))
+            return 1
+        return 0
+
+    name = args.name or os.path.splitext(os.path.basename(args.input))[0]
+    before, after = convert(args.input, args.output, name)
+    if args.output != "-":
+        print("%s: %d -> %d bytes" % (args.output, before, after))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
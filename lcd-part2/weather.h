@@ -7,67 +7,115 @@
 #ifndef __WEATHER_H__
 #define __WEATHER_H__
 
-/* Constants for string length for city data. */
-#define NAME_LENGTH 50
-#define TEMP_LENGTH 7
-#define WEATHER_LENGTH 100
-#define HUMIDITY_LENGTH 20
+#include <stdbool.h>
+#include <stdint.h>
+#include <ti/grlib/grlib.h>
+
+/* Constants for string length for city data, terminator included. */
+#define NAME_LENGTH 16
+#define TEMP_LENGTH 10
+#define HUMIDITY_LENGTH 10
+
+/* Maximum number of cities the pages can cycle through. */
+#define MAX_CITIES 256
 
 /**
  * Defines the different states.
- * 
- * STATE_TEMP -> default state to display room temperature.
- * STATE_X -> one state for each city.
+ *
+ * STATE_TEMP -> default state to display room temperature, page 0.
+ * STATE_CITY -> state shared by the city pages, 1 to city_count.
  * STATE_NUM -> used for control purposes.
  *
  */
 typedef enum
 {
-    STATE_TEMP, STATE_ROME, STATE_MOSCOW, STATE_TOKYO, STATE_NEWYORK, STATE_NUM
+    STATE_TEMP, STATE_CITY, STATE_NUM
 } State_t;
 
 /**
  * Defines the state machine struct.
  *
- * state -> State_t enum corresponding to the current city.
- * void (*state_function) -> function to be called based on current state.
+ * state -> State_t enum corresponding to the current page.
+ * void (*state_function) -> function to be called based on current state,
+ * with the number of the page to display.
  */
 typedef struct
 {
     State_t state;
-    void (*state_function)(void);
+    void (*state_function)(uint16_t page);
 } StateMachine_t;
 
 /**
  * Defines the enum for button presses
- * or none as event.
+ * or none as event. BUTTONx_REPEATED
+ * follow while the button is held.
  */
 typedef enum
 {
-    EVENT_NONE, BUTTON1_PRESSED, BUTTON2_PRESSED
+    EVENT_NONE, BUTTON1_PRESSED, BUTTON2_PRESSED, BUTTON1_REPEATED,
+    BUTTON2_REPEATED
 } Event_t;
 
 /**
- * Struct that holds information for a specific city.
+ * Defines the weather conditions, used as index
+ * in the icon and text tables of display.c.
+ */
+typedef enum
+{
+    WEATHER_PARTLY_CLOUDY, WEATHER_SNOWY, WEATHER_SUNNY, WEATHER_RAINY,
+    WEATHER_NUM
+} Weather_t;
+
+/**
+ * Struct that holds information for a specific city,
+ * turned into text only when the city page is drawn.
+ *
+ * name -> city name, at most NAME_LENGTH - 1 characters.
+ * temperature -> tenths of degree Celsius.
+ * humidity -> relative humidity in percent.
+ * weather -> Weather_t condition.
  */
 typedef struct
 {
     char name[NAME_LENGTH];
-    char temperature[TEMP_LENGTH];
-    char weather_type[WEATHER_LENGTH];
-    char humidity[HUMIDITY_LENGTH];
+    int16_t temperature;
+    uint8_t humidity;
+    uint8_t weather;
 } City_t;
 
+/* City information, filled in by _load_data() in main.c. Only the first
+ * city_count entries are shown. */
+extern City_t cities[MAX_CITIES];
+extern uint16_t city_count;
+
 /**
  * Executed function called based on the current
  * state and events. TEMP is the default displayed
  * data after hardware initialization.
  */
-void fn_TEMP(void);
-void fn_ROME(void);
-void fn_MOSCOW(void);
-void fn_TOKYO(void);
-void fn_NEWYORK(void);
+void fn_TEMP(uint16_t page);
+void fn_CITY(uint16_t page);
+
+/**
+ * Page navigation. Page 0 is the room temperature, page N the city
+ * cities[N - 1]. Both directions wrap around the room page.
+ */
+uint16_t next_page(uint16_t page);
+uint16_t previous_page(uint16_t page);
+State_t page_state(uint16_t page);
+
+/**
+ * Set while handling a button press so the new page scrolls in, in the
+ * direction given by transition_direction (LCD_CAROUSEL_NEXT or
+ * LCD_CAROUSEL_PREVIOUS). Defined in display.c.
+ */
+extern bool transition;
+extern uint8_t transition_direction;
+
+/**
+ * Initializes the LCD and the graphics context.
+ */
+void _graphicsInit();
 
 /**
  * Updates the LCD display with the correct
@@ -75,5 +123,24 @@ void fn_NEWYORK(void);
  */
 void display_temp();
 void display_weather(int);
+void show_page();
+
+/**
+ * Draws the sparkline of a HistoryTier_t of history.h
+ * on the room page.
+ */
+void display_history(int);
+
+/**
+ * Icon and text of each Weather_t condition.
+ */
+extern const Graphics_Image *const weather_icons[WEATHER_NUM];
+extern const char *const weather_names[WEATHER_NUM];
+
+/**
+ * Writes tenths of degree Celsius as text, like "-5.1C",
+ * in a buffer of TEMP_LENGTH characters.
+ */
+void format_temperature(char *str, int16_t temperature);
 
 #endif
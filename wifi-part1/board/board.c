@@ -322,6 +322,111 @@ void Delay(unsigned long interval)
     }
 }
 
+/* Timer32 counts per 2 ms at MCLK / 256 (48 MHz / 256 = 187.5 kHz). */
+#define TICK_COUNTS_2MS     375
+
+/* Wraps of the timer, each 2^32 counts. */
+static volatile unsigned long tickWraps = 0;
+
+void initTick()
+{
+    MAP_Timer32_initModule(TIMER32_1_BASE, TIMER32_PRESCALER_256,
+                           TIMER32_32BIT, TIMER32_PERIODIC_MODE);
+    MAP_Timer32_setCount(TIMER32_1_BASE, 0xFFFFFFFF);
+    MAP_Timer32_enableInterrupt(TIMER32_1_BASE);
+    MAP_Interrupt_enableInterrupt(INT_T32_INT2);
+    MAP_Timer32_startTimer(TIMER32_1_BASE, false);
+
+    /* Module 0 times out waitForEvent(). */
+    MAP_Timer32_initModule(TIMER32_0_BASE, TIMER32_PRESCALER_256,
+                           TIMER32_32BIT, TIMER32_PERIODIC_MODE);
+    MAP_Timer32_enableInterrupt(TIMER32_0_BASE);
+    MAP_Interrupt_enableInterrupt(INT_T32_INT1);
+}
+
+unsigned long getTick()
+{
+    unsigned long long counts;
+    unsigned long wraps;
+    uint32_t value;
+    uint32_t pending;
+
+    do
+    {
+        wraps = tickWraps;
+        value = MAP_Timer32_getValue(TIMER32_1_BASE);
+        pending = MAP_Timer32_getInterruptStatus(TIMER32_1_BASE);
+    }
+    while (wraps != tickWraps);
+
+    /* A wrap not handled yet, with interrupts disabled. The value read
+     * before it would be close to zero. */
+    if (pending && (value > 0x80000000))
+    {
+        wraps++;
+    }
+
+    /* The timer counts down from 0xFFFFFFFF. */
+    counts = ((unsigned long long) wraps << 32) | (0xFFFFFFFF - value);
+    return (unsigned long) (counts * 2 / TICK_COUNTS_2MS);
+}
+
+void T32_INT2_IRQHandler(void)
+{
+    MAP_Timer32_clearInterruptFlag(TIMER32_1_BASE);
+    tickWraps++;
+}
+
+/* Set by the host IRQ, cleared by waitForEvent(). */
+static volatile unsigned char hostEvent = 0;
+
+/* Timer32 counts spent in LPM0 by waitForEvent(). */
+static unsigned long long sleepCounts = 0;
+
+void waitForEvent(unsigned long timeout)
+{
+    bool masked;
+    uint32_t start;
+
+    /* With the interrupts masked an IRQ cannot slip in between the check of
+     * hostEvent and the WFI. WFI still wakes on it, its handler runs once
+     * the interrupts are unmasked. */
+    masked = MAP_Interrupt_disableMaster();
+
+    if (!hostEvent && (timeout > 0))
+    {
+        MAP_Timer32_setCount(TIMER32_0_BASE,
+                             (uint32_t) ((unsigned long long) timeout *
+                                         TICK_COUNTS_2MS / 2));
+        MAP_Timer32_startTimer(TIMER32_0_BASE, true);
+
+        start = MAP_Timer32_getValue(TIMER32_1_BASE);
+        MAP_PCM_gotoLPM0();
+        sleepCounts += (uint32_t) (start -
+                                   MAP_Timer32_getValue(TIMER32_1_BASE));
+
+        MAP_Timer32_haltTimer(TIMER32_0_BASE);
+        MAP_Timer32_clearInterruptFlag(TIMER32_0_BASE);
+    }
+    hostEvent = 0;
+
+    if (!masked)
+    {
+        MAP_Interrupt_enableMaster();
+    }
+}
+
+unsigned long getSleepTime()
+{
+    return (unsigned long) (sleepCounts * 2 / TICK_COUNTS_2MS);
+}
+
+/* Only there to wake waitForEvent(). */
+void T32_INT1_IRQHandler(void)
+{
+    MAP_Timer32_clearInterruptFlag(TIMER32_0_BASE);
+}
+
 
 /*!
     \brief          The IntSpiGPIOHandler interrupt handler
@@ -343,6 +448,7 @@ void PORT2_IRQHandler(void)
     {
 
 #ifndef SL_IF_TYPE_UART
+        hostEvent = 1;
         if (pIraEventHandler)
         {
             pIraEventHandler(0);
@@ -405,6 +511,7 @@ void CC3100_UART_ISR(void)
                     puartFlowctrl->JitterBufferFreeBytes--;
                     puartFlowctrl->JitterBufferWriteIdx++;
 
+                    hostEvent = 1;
                     if((FALSE == IntIsMasked) && (NULL != pIraEventHandler))
                     {
                         pIraEventHandler(0);
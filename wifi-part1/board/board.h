@@ -252,6 +252,69 @@ unsigned char GetLEDStatus();
 */
 void Delay(unsigned long interval);
 
+/*!
+    \brief          Starts the millisecond clock on Timer32 module 1
+
+    \param[in]      none
+
+    \return         none
+
+    \note           The timer runs from MCLK / 256 and only interrupts
+                    when it wraps, about every 6 hours, so it does not
+                    keep the MCU awake. Also prepares Timer32 module 0
+                    for waitForEvent(). initClk() must have been called.
+
+    \warning
+*/
+void initTick();
+
+/*!
+    \brief          Milliseconds since initTick()
+
+    \param[in]      none
+
+    \return         time in ms, wraps after about 49 days: compare
+                    times by their difference
+
+    \note           Can be called with interrupts disabled
+
+    \warning
+*/
+unsigned long getTick();
+
+/* Longest sleep in the waits for the CC3100, in ms. A host IRQ missed by
+   waitForEvent() delays them this much at most. */
+#define EVENT_WAIT_MS       10
+
+/*!
+    \brief          Sleeps in LPM0 until the host IRQ or a timeout
+
+    \param[in]      timeout - longest sleep in ms, zero returns at once
+
+    \return         none
+
+    \note           Returns at once if the host IRQ came since the last
+                    call. Any other interrupt also ends the sleep, so the
+                    caller checks what it waits for and calls again.
+                    Uses Timer32 module 0, initTick() must have been called.
+
+    \warning
+*/
+void waitForEvent(unsigned long timeout);
+
+/*!
+    \brief          Milliseconds spent asleep in waitForEvent()
+
+    \param[in]      none
+
+    \return         time in ms since initTick(), wraps like getTick()
+
+    \note
+
+    \warning
+*/
+unsigned long getSleepTime();
+
 /*!
     \brief      Masks the Host IRQ
 
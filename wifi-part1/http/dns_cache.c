@@ -0,0 +1,250 @@
+/* Cache of host name resolutions, see dns_cache.h. */
+#include "dns_cache.h"
+#include "board.h"
+#include "sl_common.h"
+#include <string.h>
+
+/* Marks dns_store as filled in before the reset. */
+#define DNS_CACHE_MAGIC     0x444E5343
+
+/* Bits of DnsEntry_t.flags. */
+#define DNS_ENTRY_USED          0x01
+#define DNS_ENTRY_REVALIDATE    0x02
+
+/**
+ * Resolution of a host name.
+ *
+ * name -> host name.
+ * ip -> address, host byte order, when status is zero.
+ * expires -> getTick() at which the entry expires.
+ * status -> zero or the error of the lookup.
+ * flags -> DNS_ENTRY_ bits.
+ */
+typedef struct
+{
+    char name[DNS_NAME_LENGTH];
+    _u32 ip;
+    _u32 expires;
+    _i16 status;
+    _u8 flags;
+} DnsEntry_t;
+
+typedef struct
+{
+    _u32 magic;
+    DnsEntry_t entries[DNS_CACHE_SIZE];
+    _u32 checksum;
+} DnsCacheStore_t;
+
+/* Left alone by the C startup, so it lasts through a soft reset. */
+#if defined(__TI_COMPILER_VERSION__)
+#pragma NOINIT(dns_store)
+static DnsCacheStore_t dns_store;
+#elif defined(__GNUC__)
+static DnsCacheStore_t dns_store __attribute__((section(".noinit")));
+#else
+static DnsCacheStore_t dns_store;
+#endif
+
+DnsCacheStats_t DnsCache_stats;
+
+static _u32 DnsCache_checksum(void)
+{
+    const _u8 *byte = (const _u8*) dns_store.entries;
+    _u32 sum = DNS_CACHE_MAGIC;
+    _u16 i;
+
+    for (i = 0; i < sizeof(dns_store.entries); i++)
+    {
+        sum = ((sum << 1) | (sum >> 31)) + byte[i];
+    }
+    return sum;
+}
+
+static void DnsCache_save(void)
+{
+    dns_store.magic = DNS_CACHE_MAGIC;
+    dns_store.checksum = DnsCache_checksum();
+}
+
+/* Time left before the entry expires, negative once it has. */
+static _i32 DnsCache_left(const DnsEntry_t *entry, _u32 now)
+{
+    return (_i32) (entry->expires - now);
+}
+
+static DnsEntry_t *DnsCache_find(const char *name)
+{
+    _u8 i;
+
+    for (i = 0; i < DNS_CACHE_SIZE; i++)
+    {
+        if ((dns_store.entries[i].flags & DNS_ENTRY_USED) &&
+            (pal_Strcmp(dns_store.entries[i].name, name) == 0))
+        {
+            return &dns_store.entries[i];
+        }
+    }
+    return NULL;
+}
+
+/* A free entry, or else the one closest to expiring. */
+static DnsEntry_t *DnsCache_victim(_u32 now)
+{
+    DnsEntry_t *victim = &dns_store.entries[0];
+    _u8 i;
+
+    for (i = 0; i < DNS_CACHE_SIZE; i++)
+    {
+        if (!(dns_store.entries[i].flags & DNS_ENTRY_USED))
+        {
+            return &dns_store.entries[i];
+        }
+        if (DnsCache_left(&dns_store.entries[i], now) <
+            DnsCache_left(victim, now))
+        {
+            victim = &dns_store.entries[i];
+        }
+    }
+    return victim;
+}
+
+static _i16 DnsCache_query(const char *name, _u32 *ip)
+{
+    _i16 status;
+
+    status = sl_NetAppDnsGetHostByName((_i8*) name, pal_Strlen(name), ip,
+                                       SL_AF_INET);
+    if (status < 0)
+    {
+        DnsCache_stats.failures++;
+    }
+    return status;
+}
+
+void DnsCache_init(void)
+{
+    _u32 now = getTick();
+    _u8 i;
+
+    pal_Memset(&DnsCache_stats, 0, sizeof(DnsCache_stats));
+
+    if ((dns_store.magic != DNS_CACHE_MAGIC) ||
+        (dns_store.checksum != DnsCache_checksum()))
+    {
+        pal_Memset(&dns_store, 0, sizeof(dns_store));
+        DnsCache_save();
+        return;
+    }
+
+    /* The clock started again: addresses are kept as just expired,
+     * failures are forgotten. */
+    for (i = 0; i < DNS_CACHE_SIZE; i++)
+    {
+        if (dns_store.entries[i].status != 0)
+        {
+            dns_store.entries[i].flags = 0;
+        }
+        dns_store.entries[i].expires = now;
+    }
+    DnsCache_save();
+}
+
+_i32 DnsCache_resolve(const char *name, _u32 *ip)
+{
+    DnsEntry_t *entry;
+    _u32 now = getTick();
+    _u32 address;
+    _i32 left;
+    _i16 status;
+
+    DnsCache_stats.lookups++;
+
+    if (pal_Strlen(name) >= DNS_NAME_LENGTH)
+    {
+        return DNS_CACHE_TOO_LONG;
+    }
+
+    entry = DnsCache_find(name);
+    if (entry)
+    {
+        left = DnsCache_left(entry, now);
+        if ((left > 0) && (entry->status == 0))
+        {
+            DnsCache_stats.hits++;
+            *ip = entry->ip;
+            return 0;
+        }
+        if (left > 0)
+        {
+            DnsCache_stats.negative_hits++;
+            return entry->status;
+        }
+        if ((entry->status == 0) && (-left < (_i32) DNS_STALE_TTL))
+        {
+            DnsCache_stats.stale_hits++;
+            entry->flags |= DNS_ENTRY_REVALIDATE;
+            DnsCache_save();
+            *ip = entry->ip;
+            return 0;
+        }
+    }
+    else
+    {
+        entry = DnsCache_victim(now);
+    }
+
+    DnsCache_stats.misses++;
+    status = DnsCache_query(name, &address);
+
+    pal_Strcpy(entry->name, name);
+    entry->flags = DNS_ENTRY_USED;
+    entry->status = (status < 0) ? status : 0;
+    entry->ip = (status < 0) ? 0 : address;
+    entry->expires = getTick() +
+            ((status < 0) ? DNS_NEGATIVE_TTL : DNS_CACHE_TTL);
+    DnsCache_save();
+
+    if (status < 0)
+    {
+        return status;
+    }
+    *ip = address;
+    return 0;
+}
+
+void DnsCache_revalidate(void)
+{
+    DnsEntry_t *entry;
+    _u32 address;
+    _u8 i;
+
+    for (i = 0; i < DNS_CACHE_SIZE; i++)
+    {
+        entry = &dns_store.entries[i];
+        if (!(entry->flags & DNS_ENTRY_REVALIDATE))
+        {
+            continue;
+        }
+
+        DnsCache_stats.revalidations++;
+        entry->flags &= ~DNS_ENTRY_REVALIDATE;
+        if (DnsCache_query(entry->name, &address) >= 0)
+        {
+            entry->ip = address;
+            entry->expires = getTick() + DNS_CACHE_TTL;
+        }
+        DnsCache_save();
+    }
+}
+
+void DnsCache_invalidate(const char *name)
+{
+    DnsEntry_t *entry = DnsCache_find(name);
+
+    if (entry)
+    {
+        entry->flags = 0;
+        DnsCache_save();
+    }
+}
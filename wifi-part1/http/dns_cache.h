@@ -0,0 +1,81 @@
+/**
+ * Cache of host name resolutions in front of sl_NetAppDnsGetHostByName().
+ *
+ * Addresses are kept for DNS_CACHE_TTL and failed lookups for
+ * DNS_NEGATIVE_TTL, so a refresh only asks the network processor when the
+ * entry has expired. For DNS_STALE_TTL past its expiry an address is still
+ * returned at once and the entry is only marked: DnsCache_revalidate(),
+ * called once the fetch is over, looks it up again.
+ *
+ * The entries sit in RAM left alone by the C startup, so after a soft reset
+ * the first fetch can reuse them as stale addresses. They are checked with
+ * a checksum and dropped after a power cycle.
+ */
+#ifndef __DNS_CACHE_H__
+#define __DNS_CACHE_H__
+
+#include "simplelink.h"
+
+/* Host names kept. */
+#define DNS_CACHE_SIZE      4
+
+/* Longest host name kept, terminator included. */
+#define DNS_NAME_LENGTH     32
+
+/* Lifetimes in ms: of an address, of a failure, and how long an expired
+ * address is still used while it is looked up again. */
+#define DNS_CACHE_TTL       (10 * 60 * 1000UL)
+#define DNS_NEGATIVE_TTL    (30 * 1000UL)
+#define DNS_STALE_TTL       (60 * 60 * 1000UL)
+
+/* Returned for a name too long to be looked up. */
+#define DNS_CACHE_TOO_LONG  (-0x0BC0)
+
+/**
+ * Counters of the cache, see DnsCache_stats.
+ *
+ * lookups -> calls to DnsCache_resolve().
+ * hits -> answered with an address still valid.
+ * stale_hits -> answered with an expired address, revalidated later.
+ * negative_hits -> answered with a recent failure.
+ * misses -> sent to the network processor.
+ * failures -> lookups of the network processor that failed.
+ * revalidations -> lookups made by DnsCache_revalidate().
+ */
+typedef struct
+{
+    _u16 lookups;
+    _u16 hits;
+    _u16 stale_hits;
+    _u16 negative_hits;
+    _u16 misses;
+    _u16 failures;
+    _u16 revalidations;
+} DnsCacheStats_t;
+
+extern DnsCacheStats_t DnsCache_stats;
+
+/**
+ * Restores the entries kept across a soft reset, as stale addresses, or
+ * empties the cache. Call after initTick().
+ */
+void DnsCache_init(void);
+
+/**
+ * Gives the IPv4 address of name, in host byte order. Returns zero or the
+ * error of the lookup, possibly remembered.
+ */
+_i32 DnsCache_resolve(const char *name, _u32 *ip);
+
+/**
+ * Looks up again the addresses returned stale. Call when the network is
+ * otherwise idle. A failure keeps the stale address until DNS_STALE_TTL.
+ */
+void DnsCache_revalidate(void);
+
+/**
+ * Drops the entry of name, for example when its address stopped answering.
+ */
+void DnsCache_invalidate(const char *name);
+
+#endif
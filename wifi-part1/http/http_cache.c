@@ -0,0 +1,311 @@
+/* Bounded store of responses for conditional GET, see http_cache.h. */
+#include "http_cache.h"
+#include "http_parser.h"
+#include "sl_common.h"
+#include <string.h>
+
+/* Marks http_store as filled in before the reset. */
+#define HTTP_CACHE_MAGIC    0x48544350
+
+/**
+ * Response kept for a resource.
+ *
+ * path -> resource, empty when the entry is free.
+ * validators -> of the response.
+ * offset, length -> data in HttpCacheStore_t.data.
+ * body_length -> size of the body the data was made from.
+ * used -> HttpCacheStore_t.clock when the entry was last stored or loaded.
+ */
+typedef struct
+{
+    char path[HTTP_CACHE_PATH];
+    HttpValidators_t validators;
+    _u16 offset;
+    _u16 length;
+    _u32 body_length;
+    _u32 used;
+} HttpCacheEntry_t;
+
+/**
+ * Entries and their data.
+ *
+ * clock -> orders the uses of the entries.
+ * fill -> bytes of data in use, packed from the start.
+ */
+typedef struct
+{
+    _u32 magic;
+    _u32 clock;
+    HttpCacheEntry_t entries[HTTP_CACHE_ENTRIES];
+    _u16 fill;
+    _u8 data[HTTP_CACHE_DATA];
+    _u32 checksum;
+} HttpCacheStore_t;
+
+/* Left alone by the C startup, so it lasts through a soft reset. */
+#if defined(__TI_COMPILER_VERSION__)
+#pragma NOINIT(http_store)
+static HttpCacheStore_t http_store;
+#elif defined(__GNUC__)
+static HttpCacheStore_t http_store __attribute__((section(".noinit")));
+#else
+static HttpCacheStore_t http_store;
+#endif
+
+HttpCacheStats_t HttpCache_stats;
+
+static _u32 HttpCache_fold(_u32 sum, const void *data, _u16 length)
+{
+    const _u8 *byte = (const _u8*) data;
+    _u16 i;
+
+    for (i = 0; i < length; i++)
+    {
+        sum = ((sum << 1) | (sum >> 31)) + byte[i];
+    }
+    return sum;
+}
+
+/* Covers the data in use only, fill must be within data. */
+static _u32 HttpCache_checksum(void)
+{
+    _u32 sum = HTTP_CACHE_MAGIC;
+
+    sum = HttpCache_fold(sum, &http_store.clock, sizeof(http_store.clock));
+    sum = HttpCache_fold(sum, http_store.entries, sizeof(http_store.entries));
+    sum = HttpCache_fold(sum, &http_store.fill, sizeof(http_store.fill));
+    return HttpCache_fold(sum, http_store.data, http_store.fill);
+}
+
+static void HttpCache_save(void)
+{
+    http_store.magic = HTTP_CACHE_MAGIC;
+    http_store.checksum = HttpCache_checksum();
+}
+
+static HttpCacheEntry_t *HttpCache_find(const char *path)
+{
+    _u8 i;
+
+    for (i = 0; i < HTTP_CACHE_ENTRIES; i++)
+    {
+        if ((http_store.entries[i].path[0] != '\0') &&
+            (pal_Strcmp(http_store.entries[i].path, path) == 0))
+        {
+            return &http_store.entries[i];
+        }
+    }
+    return NULL;
+}
+
+/* Frees the entry, the data after its own moves down to fill the gap. */
+static void HttpCache_drop(HttpCacheEntry_t *entry)
+{
+    _u16 end = entry->offset + entry->length;
+    _u8 i;
+
+    memmove(&http_store.data[entry->offset], &http_store.data[end], http_store.fill - end);
+    http_store.fill -= entry->length;
+
+    for (i = 0; i < HTTP_CACHE_ENTRIES; i++)
+    {
+        if ((http_store.entries[i].path[0] != '\0') &&
+            (http_store.entries[i].offset >= end))
+        {
+            http_store.entries[i].offset -= entry->length;
+        }
+    }
+    pal_Memset(entry, 0, sizeof(HttpCacheEntry_t));
+}
+
+/* The entry used longest ago, NULL when all are free. */
+static HttpCacheEntry_t *HttpCache_oldest(void)
+{
+    HttpCacheEntry_t *oldest = NULL;
+    _u8 i;
+
+    for (i = 0; i < HTTP_CACHE_ENTRIES; i++)
+    {
+        if ((http_store.entries[i].path[0] != '\0') &&
+            (!oldest || ((_i32) (http_store.entries[i].used - oldest->used) < 0)))
+        {
+            oldest = &http_store.entries[i];
+        }
+    }
+    return oldest;
+}
+
+static HttpCacheEntry_t *HttpCache_free(void)
+{
+    _u8 i;
+
+    for (i = 0; i < HTTP_CACHE_ENTRIES; i++)
+    {
+        if (http_store.entries[i].path[0] == '\0')
+        {
+            return &http_store.entries[i];
+        }
+    }
+    return NULL;
+}
+
+/* Appends text to the headers, HTTP_CONDITIONS_SIZE fits both lines. */
+static _u16 HttpCache_append(char *headers, _u16 length, const char *text)
+{
+    _u16 size = pal_Strlen(text);
+
+    if (length + size >= HTTP_CONDITIONS_SIZE)
+    {
+        return length;
+    }
+    pal_Memcpy(&headers[length], text, size);
+    headers[length + size] = '\0';
+    return length + size;
+}
+
+void HttpCache_init(void)
+{
+    pal_Memset(&HttpCache_stats, 0, sizeof(HttpCache_stats));
+
+    if ((http_store.magic != HTTP_CACHE_MAGIC) ||
+        (http_store.fill > HTTP_CACHE_DATA) ||
+        (http_store.checksum != HttpCache_checksum()))
+    {
+        pal_Memset(&http_store, 0, sizeof(http_store));
+        HttpCache_save();
+    }
+}
+
+_u16 HttpCache_conditions(const char *path, char *headers)
+{
+    HttpCacheEntry_t *entry = HttpCache_find(path);
+    _u16 length = 0;
+
+    headers[0] = '\0';
+    if (!entry)
+    {
+        return 0;
+    }
+
+    if (entry->validators.etag[0] != '\0')
+    {
+        length = HttpCache_append(headers, length, "If-None-Match: ");
+        length = HttpCache_append(headers, length, entry->validators.etag);
+        length = HttpCache_append(headers, length, "\r\n");
+    }
+    if (entry->validators.modified[0] != '\0')
+    {
+        length = HttpCache_append(headers, length, "If-Modified-Since: ");
+        length = HttpCache_append(headers, length, entry->validators.modified);
+        length = HttpCache_append(headers, length, "\r\n");
+    }
+
+    HttpCache_stats.conditional++;
+    return length;
+}
+
+void HttpCache_header(HttpValidators_t *validators, const char *name,
+                      const char *value)
+{
+    char *validator;
+
+    if (HttpParser_equals(name, "ETag"))
+    {
+        validator = validators->etag;
+    }
+    else if (HttpParser_equals(name, "Last-Modified"))
+    {
+        validator = validators->modified;
+    }
+    else
+    {
+        return;
+    }
+
+    /* A validator cut short would never match, it is not kept. */
+    if (pal_Strlen(value) < HTTP_VALIDATOR_SIZE)
+    {
+        pal_Strcpy(validator, value);
+    }
+    else
+    {
+        validator[0] = '\0';
+    }
+}
+
+_i32 HttpCache_store(const char *path, const HttpValidators_t *validators,
+                     const void *data, _u16 length, _u32 body_length)
+{
+    HttpCacheEntry_t *entry = HttpCache_find(path);
+
+    if (entry)
+    {
+        HttpCache_drop(entry);
+    }
+
+    if ((validators->etag[0] == '\0') && (validators->modified[0] == '\0'))
+    {
+        HttpCache_save();
+        return SUCCESS;
+    }
+    if ((pal_Strlen(path) >= HTTP_CACHE_PATH) || (length > HTTP_CACHE_DATA))
+    {
+        HttpCache_save();
+        return HTTP_CACHE_TOO_LARGE;
+    }
+
+    /* Makes room, the entries used longest ago go first. */
+    for (entry = HttpCache_free();
+         !entry || (HTTP_CACHE_DATA - http_store.fill < length);
+         entry = HttpCache_free())
+    {
+        HttpCache_drop(HttpCache_oldest());
+        HttpCache_stats.evictions++;
+    }
+
+    pal_Strcpy(entry->path, path);
+    pal_Memcpy(&entry->validators, validators, sizeof(HttpValidators_t));
+    entry->offset = http_store.fill;
+    entry->length = length;
+    entry->body_length = body_length;
+    entry->used = ++http_store.clock;
+    pal_Memcpy(&http_store.data[http_store.fill], data, length);
+    http_store.fill += length;
+    HttpCache_save();
+
+    HttpCache_stats.stores++;
+    return SUCCESS;
+}
+
+_i32 HttpCache_load(const char *path, void *data, _u16 size)
+{
+    HttpCacheEntry_t *entry = HttpCache_find(path);
+
+    if (!entry)
+    {
+        return HTTP_CACHE_MISSING;
+    }
+    if (entry->length > size)
+    {
+        return HTTP_CACHE_TOO_LARGE;
+    }
+
+    pal_Memcpy(data, &http_store.data[entry->offset], entry->length);
+    entry->used = ++http_store.clock;
+    HttpCache_save();
+
+    HttpCache_stats.hits++;
+    HttpCache_stats.bytes_saved += entry->body_length;
+    return entry->length;
+}
+
+void HttpCache_invalidate(const char *path)
+{
+    HttpCacheEntry_t *entry = HttpCache_find(path);
+
+    if (entry)
+    {
+        HttpCache_drop(entry);
+        HttpCache_save();
+    }
+}
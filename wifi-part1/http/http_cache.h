@@ -0,0 +1,113 @@
+/**
+ * Bounded store of responses for conditional GET requests.
+ *
+ * For every resource the store keeps the ETag and Last-Modified of its last
+ * full response, along with what the application made of the body. The next
+ * request for the resource carries If-None-Match, If-Modified-Since or both,
+ * for the validators the server gave, and when the server answers 304 the
+ * kept data is given back instead of downloading and parsing the body again.
+ * The size of that body is counted as saved. A response without validators,
+ * or with more data than HTTP_CACHE_DATA, is not kept and the next request
+ * for it is a plain GET.
+ *
+ * The entries share HTTP_CACHE_DATA bytes of data. The one used longest ago
+ * is dropped to make room for a new one.
+ *
+ * The store sits in RAM left alone by the C startup, as dns_cache.c does, so
+ * the first refresh after a soft reset can already be conditional. It is
+ * checked with a checksum and emptied after a power cycle.
+ */
+#ifndef __HTTP_CACHE_H__
+#define __HTTP_CACHE_H__
+
+#include "simplelink.h"
+
+/* Resources kept. */
+#define HTTP_CACHE_ENTRIES      4
+
+/* Data bytes shared by the entries, enough for the MAX_CITIES City_t of
+ * main.c, 5120 bytes. */
+#define HTTP_CACHE_DATA         6144
+
+/* Longest path kept, terminator included. */
+#define HTTP_CACHE_PATH         32
+
+/* Longest ETag or Last-Modified kept, terminator included. */
+#define HTTP_VALIDATOR_SIZE     48
+
+/* Longest conditional headers written by HttpCache_conditions(). */
+#define HTTP_CONDITIONS_SIZE    (2 * HTTP_VALIDATOR_SIZE + 40)
+
+/* Status codes of the store, past those of dns_cache.h. */
+#define HTTP_CACHE_TOO_LARGE    (-0x0BC1) /* path, validator or data over
+                                             the limits */
+#define HTTP_CACHE_MISSING      (-0x0BC2) /* nothing kept for the path */
+
+/**
+ * Validators of a response, empty strings when the server gave none.
+ */
+typedef struct
+{
+    char etag[HTTP_VALIDATOR_SIZE];
+    char modified[HTTP_VALIDATOR_SIZE];
+} HttpValidators_t;
+
+/**
+ * Counters of the store, see HttpCache_stats.
+ *
+ * conditional -> requests sent with validators.
+ * hits -> 304 answers served from the store.
+ * stores -> full responses kept.
+ * evictions -> entries dropped to make room.
+ * bytes_saved -> body bytes the 304 answers did not download.
+ */
+typedef struct
+{
+    _u16 conditional;
+    _u16 hits;
+    _u16 stores;
+    _u16 evictions;
+    _u32 bytes_saved;
+} HttpCacheStats_t;
+
+extern HttpCacheStats_t HttpCache_stats;
+
+/**
+ * Keeps the entries stored before a soft reset, or empties the store.
+ */
+void HttpCache_init(void);
+
+/**
+ * Writes the If-None-Match and If-Modified-Since lines for path into
+ * headers, of HTTP_CONDITIONS_SIZE bytes. Returns their length, zero when
+ * nothing is kept for path.
+ */
+_u16 HttpCache_conditions(const char *path, char *headers);
+
+/**
+ * Picks the validators out of a header of the response, call it from the
+ * header callback of the parser. validators starts empty.
+ */
+void HttpCache_header(HttpValidators_t *validators, const char *name,
+                      const char *value);
+
+/**
+ * Keeps length bytes of data for path, replacing what was kept. Nothing is
+ * kept when the response had no validator. body_length is the size of the
+ * body the data was made from. Returns zero or a negative status code.
+ */
+_i32 HttpCache_store(const char *path, const HttpValidators_t *validators,
+                     const void *data, _u16 length, _u32 body_length);
+
+/**
+ * Copies the data kept for path into data, of size bytes, when the server
+ * answered 304. Returns its length or a negative status code.
+ */
+_i32 HttpCache_load(const char *path, void *data, _u16 size);
+
+/**
+ * Drops what is kept for path.
+ */
+void HttpCache_invalidate(const char *path);
+
+#endif
@@ -0,0 +1,457 @@
+/* Concurrent HTTP/1.1 GET requests, see http_fetch.h. */
+#include "http_fetch.h"
+#include "board.h"
+#include "sl_common.h"
+#include <string.h>
+
+/* HttpConnection_t.state */
+#define HTTP_CONNECTION_CLOSED      0
+#define HTTP_CONNECTION_CONNECTING  1
+#define HTTP_CONNECTION_OPEN        2
+
+void HttpFetch_init(HttpFetch_t *fetch, const char *host, _u32 ip,
+                    _u16 port, _u8 *buffer, _u16 size)
+{
+    fetch->host = host;
+    fetch->ip = ip;
+    fetch->port = port;
+    fetch->buffer = buffer;
+    fetch->size = size;
+    fetch->requests = NULL;
+    fetch->count = 0;
+    fetch->sockets = 0;
+    fetch->connects = 0;
+    fetch->total_ms = 0;
+}
+
+static _u32 HttpFetch_elapsed(HttpFetch_t *fetch)
+{
+    return getTick() - fetch->start;
+}
+
+static void HttpFetch_disconnect(HttpConnection_t *connection)
+{
+    if (connection->sd >= 0)
+    {
+        sl_Close(connection->sd);
+        connection->sd = -1;
+    }
+    connection->state = HTTP_CONNECTION_CLOSED;
+}
+
+/* Gives status to the requests of the connection still waiting and closes
+ * it for good. */
+static void HttpFetch_fail(HttpFetch_t *fetch, HttpConnection_t *connection,
+                           _i32 status)
+{
+    _u16 i;
+
+    for (i = connection->next_receive; i < fetch->count; i += fetch->sockets)
+    {
+        fetch->requests[i].result = status;
+        fetch->requests[i].done_ms = HttpFetch_elapsed(fetch);
+    }
+    connection->next_receive = fetch->count;
+    HttpFetch_disconnect(connection);
+}
+
+/* Ends the response being read with result, moving to the next one. */
+static void HttpFetch_complete(HttpFetch_t *fetch,
+                               HttpConnection_t *connection, _i32 result)
+{
+    HttpRequest_t *request = &fetch->requests[connection->next_receive];
+
+    request->result = result;
+    request->done_ms = HttpFetch_elapsed(fetch);
+    connection->next_receive += fetch->sockets;
+    connection->reconnects = HTTP_RECONNECTS;
+    connection->started = 0;
+}
+
+/* Opens a non-blocking connection, the requests waiting on it are sent
+ * again once it is made. */
+static _i32 HttpFetch_connect(HttpFetch_t *fetch, HttpConnection_t *connection)
+{
+    SlSockNonblocking_t nonBlocking;
+    SlSockAddrIn_t Addr;
+    _i32 retVal;
+
+    HttpFetch_disconnect(connection);
+    connection->next_send = connection->next_receive;
+    connection->started = 0;
+
+    Addr.sin_family = SL_AF_INET;
+    Addr.sin_port = sl_Htons(fetch->port);
+    Addr.sin_addr.s_addr = sl_Htonl(fetch->ip);
+
+    connection->sd = sl_Socket(SL_AF_INET, SL_SOCK_STREAM, 0);
+    ASSERT_ON_ERROR(connection->sd);
+
+    nonBlocking.NonblockingEnabled = 1;
+    retVal = sl_SetSockOpt(connection->sd, SL_SOL_SOCKET, SL_SO_NONBLOCKING,
+                           &nonBlocking, sizeof(nonBlocking));
+    if (retVal < 0)
+    {
+        HttpFetch_disconnect(connection);
+        return retVal;
+    }
+
+    retVal = sl_Connect(connection->sd, (SlSockAddr_t*) &Addr,
+                        sizeof(SlSockAddrIn_t));
+    if ((retVal < 0) && (retVal != SL_EALREADY))
+    {
+        HttpFetch_disconnect(connection);
+        return retVal;
+    }
+    fetch->connects++;
+    connection->state = (retVal == SL_EALREADY) ?
+            HTTP_CONNECTION_CONNECTING : HTTP_CONNECTION_OPEN;
+    return SUCCESS;
+}
+
+/* Appends text to the request, returns the new length or 0 if too long. */
+static _u16 HttpFetch_append(HttpFetch_t *fetch, _u16 length, const char *text)
+{
+    _u16 size = pal_Strlen(text);
+
+    if (length + size >= HTTP_REQUEST_SIZE)
+    {
+        return 0;
+    }
+    pal_Memcpy(&fetch->request[length], text, size);
+    return length + size;
+}
+
+/* Sends the requests of the connection that fit in the pipeline. Returns
+ * zero, also when the network processor has no buffer left for now, or a
+ * negative status code. */
+static _i32 HttpFetch_write(HttpFetch_t *fetch, HttpConnection_t *connection)
+{
+    HttpRequest_t *request;
+    _u16 length;
+    _i32 retVal;
+
+    while ((connection->next_send < fetch->count) &&
+           ((connection->next_send - connection->next_receive) <
+            HTTP_PIPELINE_DEPTH * fetch->sockets))
+    {
+        request = &fetch->requests[connection->next_send];
+
+        length = HttpFetch_append(fetch, 0, "GET ");
+        length = length ? HttpFetch_append(fetch, length, request->path) : 0;
+        length = length ? HttpFetch_append(fetch, length,
+                                           " HTTP/1.1\r\nHost: ") : 0;
+        length = length ? HttpFetch_append(fetch, length, fetch->host) : 0;
+        length = length ? HttpFetch_append(fetch, length,
+                                           "\r\nAccept: */*\r\n") : 0;
+        if (request->headers)
+        {
+            length = length ? HttpFetch_append(fetch, length,
+                                               request->headers) : 0;
+        }
+        length = length ? HttpFetch_append(fetch, length, "\r\n") : 0;
+        if (length == 0)
+        {
+            return HTTP_FETCH_TOO_LONG;
+        }
+
+        retVal = sl_Send(connection->sd, fetch->request, length, 0);
+        if (retVal == SL_EAGAIN)
+        {
+            break;
+        }
+        if (retVal != length)
+        {
+            return (retVal < 0) ? retVal : SL_SOC_ERROR;
+        }
+        request->sent_ms = HttpFetch_elapsed(fetch);
+        connection->next_send += fetch->sockets;
+    }
+    return SUCCESS;
+}
+
+/* Feeds what the connection received to the parsers of its responses. */
+static _i32 HttpFetch_read(HttpFetch_t *fetch, HttpConnection_t *connection)
+{
+    HttpParser_t *parser;
+    _u16 offset = 0;
+    _i32 received;
+    _i32 retVal;
+
+    received = sl_Recv(connection->sd, fetch->buffer, fetch->size, 0);
+    if (received == SL_EAGAIN)
+    {
+        return SUCCESS;
+    }
+    if (received <= 0)
+    {
+        /* A body lasting until the connection closes. */
+        parser = fetch->requests[connection->next_receive].parser;
+        if (connection->started && (received == 0) &&
+            (HttpParser_finish(parser) == 0))
+        {
+            HttpFetch_complete(fetch, connection, parser->status);
+            HttpFetch_disconnect(connection);
+            return SUCCESS;
+        }
+        HttpFetch_disconnect(connection);
+        if (connection->started)
+        {
+            HttpFetch_complete(fetch, connection, (received < 0) ?
+                               received : HTTP_FETCH_CLOSED);
+        }
+        return (received < 0) ? received : HTTP_FETCH_CLOSED;
+    }
+
+    /* Bytes past the end of a response start the next one. */
+    while ((offset < received) && (connection->next_receive < fetch->count))
+    {
+        parser = fetch->requests[connection->next_receive].parser;
+        if (!connection->started)
+        {
+            connection->started = 1;
+            fetch->requests[connection->next_receive].first_byte_ms =
+                    HttpFetch_elapsed(fetch);
+        }
+
+        retVal = HttpParser_feed(parser, &fetch->buffer[offset],
+                                 received - offset);
+        if (retVal < 0)
+        {
+            HttpFetch_complete(fetch, connection, HTTP_FETCH_INVALID);
+            HttpFetch_disconnect(connection);
+            return HTTP_FETCH_INVALID;
+        }
+        offset += retVal;
+
+        if (HttpParser_isDone(parser))
+        {
+            HttpFetch_complete(fetch, connection, parser->status);
+
+            /* The server closes after this response, the requests still
+             * waiting go on a new connection. */
+            if (parser->flags & HTTP_FLAG_CLOSE)
+            {
+                HttpFetch_disconnect(connection);
+                return SUCCESS;
+            }
+        }
+    }
+    return SUCCESS;
+}
+
+/* Moves the connection on after sl_Select(), or right after it is opened
+ * when both sets are NULL. */
+static void HttpFetch_service(HttpFetch_t *fetch, HttpConnection_t *connection,
+                              SlFdSet_t *readable, SlFdSet_t *writable)
+{
+    SlSockAddrIn_t Addr;
+    _i32 retVal = SUCCESS;
+
+    if (connection->state == HTTP_CONNECTION_CONNECTING)
+    {
+        if (!writable || !SL_FD_ISSET(connection->sd, writable))
+        {
+            return;
+        }
+
+        /* Asking again tells whether the connect is over. */
+        Addr.sin_family = SL_AF_INET;
+        Addr.sin_port = sl_Htons(fetch->port);
+        Addr.sin_addr.s_addr = sl_Htonl(fetch->ip);
+        retVal = sl_Connect(connection->sd, (SlSockAddr_t*) &Addr,
+                            sizeof(SlSockAddrIn_t));
+        if (retVal == SL_EALREADY)
+        {
+            return;
+        }
+        if (retVal < 0)
+        {
+            HttpFetch_fail(fetch, connection, retVal);
+            return;
+        }
+        connection->state = HTTP_CONNECTION_OPEN;
+    }
+    else if ((connection->state == HTTP_CONNECTION_OPEN) && readable &&
+             SL_FD_ISSET(connection->sd, readable))
+    {
+        retVal = HttpFetch_read(fetch, connection);
+    }
+
+    if ((retVal == SUCCESS) && (connection->state == HTTP_CONNECTION_OPEN))
+    {
+        retVal = HttpFetch_write(fetch, connection);
+        if (retVal == HTTP_FETCH_TOO_LONG)
+        {
+            HttpFetch_fail(fetch, connection, retVal);
+            return;
+        }
+        if (retVal < 0)
+        {
+            HttpFetch_disconnect(connection);
+        }
+    }
+
+    if (connection->next_receive >= fetch->count)
+    {
+        HttpFetch_disconnect(connection);
+        return;
+    }
+    if (connection->state != HTTP_CONNECTION_CLOSED)
+    {
+        return;
+    }
+
+    /* Closed before answering, most likely an idle connection timed out:
+     * the requests waiting are sent again. A close announced by the server
+     * does not count. */
+    if (retVal < 0)
+    {
+        if (connection->reconnects == 0)
+        {
+            HttpFetch_fail(fetch, connection, retVal);
+            return;
+        }
+        connection->reconnects--;
+    }
+    retVal = HttpFetch_connect(fetch, connection);
+    if (retVal < 0)
+    {
+        HttpFetch_fail(fetch, connection, retVal);
+    }
+}
+
+_i32 HttpFetch_run(HttpFetch_t *fetch, HttpRequest_t *requests, _u8 count,
+                   _u32 timeout_ms)
+{
+    HttpConnection_t *connection;
+    SlFdSet_t readable;
+    SlFdSet_t writable;
+    SlTimeval_t wait;
+    _i32 answered = 0;
+    _u32 elapsed;
+    _i16 nfds;
+    _i32 retVal;
+    _u8 active;
+    _u8 i;
+
+    fetch->requests = requests;
+    fetch->count = count;
+    fetch->sockets = (count < HTTP_FETCH_SOCKETS) ? count : HTTP_FETCH_SOCKETS;
+    fetch->connects = 0;
+    fetch->start = getTick();
+
+    for (i = 0; i < count; i++)
+    {
+        requests[i].result = HTTP_FETCH_PENDING;
+        requests[i].sent_ms = 0;
+        requests[i].first_byte_ms = 0;
+        requests[i].done_ms = 0;
+    }
+
+    for (i = 0; i < fetch->sockets; i++)
+    {
+        connection = &fetch->connections[i];
+        connection->sd = -1;
+        connection->state = HTTP_CONNECTION_CLOSED;
+        connection->next_receive = i;
+        connection->reconnects = HTTP_RECONNECTS;
+
+        retVal = HttpFetch_connect(fetch, connection);
+        if (retVal < 0)
+        {
+            HttpFetch_fail(fetch, connection, retVal);
+        }
+        else if (connection->state == HTTP_CONNECTION_OPEN)
+        {
+            HttpFetch_service(fetch, connection, NULL, NULL);
+        }
+    }
+
+    for (;;)
+    {
+        SL_FD_ZERO(&readable);
+        SL_FD_ZERO(&writable);
+        nfds = 0;
+        active = 0;
+
+        for (i = 0; i < fetch->sockets; i++)
+        {
+            connection = &fetch->connections[i];
+            if (connection->next_receive >= count)
+            {
+                continue;
+            }
+            active = 1;
+            if (connection->sd < 0)
+            {
+                continue;
+            }
+            /* The write set only tells when a connect is over. */
+            if (connection->state == HTTP_CONNECTION_CONNECTING)
+            {
+                SL_FD_SET(connection->sd, &writable);
+            }
+            else
+            {
+                SL_FD_SET(connection->sd, &readable);
+            }
+            if (connection->sd >= nfds)
+            {
+                nfds = connection->sd + 1;
+            }
+        }
+        if (!active)
+        {
+            break;
+        }
+
+        elapsed = HttpFetch_elapsed(fetch);
+        if (elapsed >= timeout_ms)
+        {
+            for (i = 0; i < fetch->sockets; i++)
+            {
+                HttpFetch_fail(fetch, &fetch->connections[i],
+                               HTTP_FETCH_TIMEOUT);
+            }
+            break;
+        }
+        elapsed = timeout_ms - elapsed;
+        if (elapsed > HTTP_SELECT_MS)
+        {
+            elapsed = HTTP_SELECT_MS;
+        }
+        wait.tv_sec = 0;
+        wait.tv_usec = elapsed * 1000;
+
+        retVal = sl_Select(nfds, &readable, &writable, NULL, &wait);
+        if (retVal < 0)
+        {
+            for (i = 0; i < fetch->sockets; i++)
+            {
+                HttpFetch_fail(fetch, &fetch->connections[i], retVal);
+            }
+            fetch->total_ms = HttpFetch_elapsed(fetch);
+            return retVal;
+        }
+
+        for (i = 0; i < fetch->sockets; i++)
+        {
+            connection = &fetch->connections[i];
+            if ((connection->next_receive < count) && (connection->sd >= 0))
+            {
+                HttpFetch_service(fetch, connection, &readable, &writable);
+            }
+        }
+    }
+
+    fetch->total_ms = HttpFetch_elapsed(fetch);
+    for (i = 0; i < count; i++)
+    {
+        if (requests[i].result >= 0)
+        {
+            answered++;
+        }
+    }
+    return answered;
+}
@@ -0,0 +1,135 @@
+/**
+ * Concurrent HTTP/1.1 GET requests over non-blocking sockets.
+ *
+ * The requests are spread over up to HTTP_FETCH_SOCKETS connections to the
+ * same server, request i going on connection i % HTTP_FETCH_SOCKETS. The
+ * connections are opened together and served by a single loop around
+ * sl_Select(): connects complete, requests are sent and responses are fed
+ * to the parser of their request as the bytes arrive, so a refresh takes
+ * about one round trip however many requests it makes.
+ *
+ * Each connection is kept alive for all of its requests, sending up to
+ * HTTP_PIPELINE_DEPTH of them ahead of their responses. When the server
+ * closes it, because it timed out an idle connection or answered with
+ * "Connection: close", a new one is made and the requests still waiting
+ * are sent again.
+ *
+ * The time each request is sent, gets its first byte and completes is
+ * kept in its HttpRequest_t.
+ */
+#ifndef __HTTP_FETCH_H__
+#define __HTTP_FETCH_H__
+
+#include "simplelink.h"
+#include "http_parser.h"
+
+/* Connections opened at once, at most SL_MAX_SOCKETS. */
+#define HTTP_FETCH_SOCKETS      4
+
+/* Requests sent on a connection and waiting for their response. */
+#define HTTP_PIPELINE_DEPTH     4
+
+/* Longest request line and headers, extra headers included. */
+#define HTTP_REQUEST_SIZE       320
+
+/* New connections tried in a row without a response before giving up. */
+#define HTTP_RECONNECTS         1
+
+/* Longest wait in sl_Select(), in ms, between two checks of the timeout. */
+#define HTTP_SELECT_MS          100
+
+/* Status codes of the requests, past STATUS_CODE_MAX of main.c. */
+#define HTTP_FETCH_TOO_LONG     (-0x0BB9) /* request over HTTP_REQUEST_SIZE */
+#define HTTP_FETCH_CLOSED       (-0x0BBA) /* closed in the middle of a
+                                             response */
+#define HTTP_FETCH_INVALID      (-0x0BBB) /* malformed response */
+#define HTTP_FETCH_TIMEOUT      (-0x0BBC) /* no response in time */
+#define HTTP_FETCH_PENDING      (-0x0BBD) /* not answered yet */
+
+/**
+ * A request and its outcome.
+ *
+ * path -> resource to GET, must last until HttpFetch_run() returns.
+ * headers -> extra header lines, each ending with CRLF, or NULL.
+ * parser -> prepared by HttpParser_init(), receives the response.
+ * result -> status code of the response or a negative status code.
+ * sent_ms, first_byte_ms, done_ms -> when the request was last sent, its
+ * first response byte arrived and the response was complete, in ms from
+ * the start of HttpFetch_run().
+ */
+typedef struct
+{
+    const char *path;
+    const char *headers;
+    HttpParser_t *parser;
+    _i32 result;
+    _u32 sent_ms;
+    _u32 first_byte_ms;
+    _u32 done_ms;
+} HttpRequest_t;
+
+/**
+ * Connection state.
+ *
+ * sd -> socket, -1 while closed.
+ * state -> HTTP_CONNECTION_ state, see http_fetch.c.
+ * next_send -> next request to send on it.
+ * next_receive -> request whose response is being read.
+ * reconnects -> new connections left before giving up.
+ * started -> set once the response being read got a byte.
+ */
+typedef struct
+{
+    _i16 sd;
+    _u8 state;
+    _u16 next_send;
+    _u16 next_receive;
+    _u8 reconnects;
+    _u8 started;
+} HttpConnection_t;
+
+/**
+ * Fetch state.
+ *
+ * host, ip, port -> server, ip in host byte order.
+ * buffer -> receive buffer of size bytes, shared by the connections.
+ * requests -> count requests of the current run.
+ * connections -> sockets of the current run, count of them used.
+ * request -> request being sent.
+ * start -> getTick() at the start of the run.
+ * connects -> TCP connections made by the last run.
+ * total_ms -> duration of the last run.
+ */
+typedef struct
+{
+    const char *host;
+    _u32 ip;
+    _u16 port;
+    _u8 *buffer;
+    _u16 size;
+    HttpRequest_t *requests;
+    _u8 count;
+    HttpConnection_t connections[HTTP_FETCH_SOCKETS];
+    _u8 sockets;
+    char request[HTTP_REQUEST_SIZE];
+    _u32 start;
+    _u16 connects;
+    _u32 total_ms;
+} HttpFetch_t;
+
+/**
+ * Prepares requests to host at ip, without connecting.
+ */
+void HttpFetch_init(HttpFetch_t *fetch, const char *host, _u32 ip,
+                    _u16 port, _u8 *buffer, _u16 size);
+
+/**
+ * Makes count requests, returning once all are answered or failed, or
+ * after timeout_ms. Returns the number of requests answered, the result of
+ * each is in its HttpRequest_t, or a negative status code if sl_Select()
+ * failed. All the connections are closed on return.
+ */
+_i32 HttpFetch_run(HttpFetch_t *fetch, HttpRequest_t *requests, _u8 count,
+                   _u32 timeout_ms);
+
+#endif
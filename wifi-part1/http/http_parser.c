@@ -0,0 +1,338 @@
+/* Incremental parser of HTTP/1.1 responses, see http_parser.h. */
+#include "http_parser.h"
+
+/* Lower case of an ASCII letter. */
+#define HTTP_LOWER(c)   ((((c) >= 'A') && ((c) <= 'Z')) ? ((c) + 'a' - 'A') : (c))
+
+_u8 HttpParser_equals(const char *a, const char *b)
+{
+    while (*a && (HTTP_LOWER(*a) == HTTP_LOWER(*b)))
+    {
+        a++;
+        b++;
+    }
+    return (*a == '\0') && (*b == '\0');
+}
+
+/* Tells if a header value holds a token, ignoring case. */
+static _u8 HttpParser_contains(const char *value, const char *token)
+{
+    const char *v;
+    const char *t;
+
+    for (; *value; value++)
+    {
+        for (v = value, t = token; *t && (HTTP_LOWER(*v) == HTTP_LOWER(*t));
+                v++, t++);
+        if (*t == '\0')
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void HttpParser_init(HttpParser_t *parser, HttpHeaderCallback onHeader,
+                     HttpBodyCallback onBody, void *context)
+{
+    parser->state = HTTP_STATE_STATUS;
+    parser->flags = 0;
+    parser->status = 0;
+    parser->length = 0;
+    parser->remaining = 0;
+    parser->line_length = 0;
+    parser->onHeader = onHeader;
+    parser->onBody = onBody;
+    parser->context = context;
+}
+
+/**
+ * Adds a byte to the line being gathered. Returns 1 once the line feed
+ * arrives, with the line terminated and its carriage return removed.
+ */
+static _u8 HttpParser_line(HttpParser_t *parser, _u8 byte)
+{
+    if (byte == '\n')
+    {
+        if ((parser->line_length > 0) &&
+            (parser->line[parser->line_length - 1] == '\r'))
+        {
+            parser->line_length--;
+        }
+        parser->line[parser->line_length] = '\0';
+        parser->line_length = 0;
+        return 1;
+    }
+
+    /* Past the end of the buffer the line is cut. */
+    if (parser->line_length < HTTP_LINE_SIZE - 1)
+    {
+        parser->line[parser->line_length++] = byte;
+    }
+    return 0;
+}
+
+/* Reads "HTTP/1.x NNN reason". */
+static _u8 HttpParser_status(HttpParser_t *parser)
+{
+    const char *line = parser->line;
+    _u8 i;
+
+    if ((line[0] != 'H') || (line[1] != 'T') || (line[2] != 'T') ||
+        (line[3] != 'P') || (line[4] != '/') || (line[5] != '1') ||
+        (line[6] != '.') || (line[8] != ' '))
+    {
+        return 0;
+    }
+
+    parser->status = 0;
+    for (i = 9; i < 12; i++)
+    {
+        if ((line[i] < '0') || (line[i] > '9'))
+        {
+            return 0;
+        }
+        parser->status = parser->status * 10 + (line[i] - '0');
+    }
+    return 1;
+}
+
+/* Splits a header line, handles the headers framing the body. */
+static _u8 HttpParser_header(HttpParser_t *parser)
+{
+    char *name = parser->line;
+    char *value;
+    char *end;
+
+    for (value = name; *value && (*value != ':'); value++);
+    if (*value == '\0')
+    {
+        return 0;
+    }
+
+    /* Trim the name and the value. */
+    for (end = value; (end > name) && (end[-1] == ' '); end--);
+    *end = '\0';
+    for (value++; (*value == ' ') || (*value == '\t'); value++);
+    for (end = value; *end; end++);
+    for (; (end > value) && ((end[-1] == ' ') || (end[-1] == '\t')); end--);
+    *end = '\0';
+
+    if (HttpParser_equals(name, "Content-Length"))
+    {
+        parser->length = 0;
+        if (*value == '\0')
+        {
+            return 0;
+        }
+        for (; *value; value++)
+        {
+            if ((*value < '0') || (*value > '9') ||
+                (parser->length > 0x0FFFFFFF))
+            {
+                return 0;
+            }
+            parser->length = parser->length * 10 + (*value - '0');
+        }
+        parser->flags |= HTTP_FLAG_LENGTH;
+    }
+    else if (HttpParser_equals(name, "Transfer-Encoding") &&
+             HttpParser_contains(value, "chunked"))
+    {
+        parser->flags |= HTTP_FLAG_CHUNKED;
+    }
+    else if (HttpParser_equals(name, "Connection") &&
+             HttpParser_contains(value, "close"))
+    {
+        parser->flags |= HTTP_FLAG_CLOSE;
+    }
+
+    if (parser->onHeader)
+    {
+        parser->onHeader(parser, name, value);
+    }
+    return 1;
+}
+
+/* Picks how the body is framed once the headers are over. */
+static void HttpParser_body(HttpParser_t *parser)
+{
+    if ((parser->status >= 100) && (parser->status < 200))
+    {
+        /* Interim response, the real one follows. */
+        parser->state = HTTP_STATE_STATUS;
+        parser->flags = 0;
+    }
+    else if ((parser->status == 204) || (parser->status == 304))
+    {
+        parser->state = HTTP_STATE_DONE;
+    }
+    else if (parser->flags & HTTP_FLAG_CHUNKED)
+    {
+        parser->state = HTTP_STATE_CHUNK_SIZE;
+    }
+    else if (parser->flags & HTTP_FLAG_LENGTH)
+    {
+        parser->remaining = parser->length;
+        parser->state = parser->length ? HTTP_STATE_BODY : HTTP_STATE_DONE;
+    }
+    else
+    {
+        parser->state = HTTP_STATE_BODY_CLOSE;
+    }
+}
+
+/* Reads the hexadecimal size of a chunk, extensions after it are ignored. */
+static _u8 HttpParser_chunkSize(HttpParser_t *parser)
+{
+    const char *digit = parser->line;
+    _u32 size = 0;
+    _u8 value;
+
+    if (*digit == '\0')
+    {
+        return 0;
+    }
+    for (; *digit && (*digit != ';') && (*digit != ' '); digit++)
+    {
+        if ((*digit >= '0') && (*digit <= '9'))
+        {
+            value = *digit - '0';
+        }
+        else if ((HTTP_LOWER(*digit) >= 'a') && (HTTP_LOWER(*digit) <= 'f'))
+        {
+            value = HTTP_LOWER(*digit) - 'a' + 10;
+        }
+        else
+        {
+            return 0;
+        }
+        if (size > 0x0FFFFFFF)
+        {
+            return 0;
+        }
+        size = (size << 4) | value;
+    }
+
+    parser->remaining = size;
+    parser->state = size ? HTTP_STATE_CHUNK_DATA : HTTP_STATE_TRAILER;
+    return 1;
+}
+
+_i32 HttpParser_feed(HttpParser_t *parser, const _u8 *data, _u16 length)
+{
+    _u16 used = 0;
+    _u16 count;
+    _u8 ok;
+
+    while ((used < length) && (parser->state != HTTP_STATE_DONE))
+    {
+        switch (parser->state)
+        {
+        case HTTP_STATE_BODY:
+        case HTTP_STATE_BODY_CLOSE:
+        case HTTP_STATE_CHUNK_DATA:
+        {
+            /* Body bytes go to the callback without copying. */
+            count = length - used;
+            if ((parser->state != HTTP_STATE_BODY_CLOSE) &&
+                (count > parser->remaining))
+            {
+                count = parser->remaining;
+            }
+            if (parser->onBody)
+            {
+                parser->onBody(parser, data + used, count);
+            }
+            used += count;
+
+            if (parser->state != HTTP_STATE_BODY_CLOSE)
+            {
+                parser->remaining -= count;
+                if (parser->remaining == 0)
+                {
+                    parser->state = (parser->state == HTTP_STATE_BODY) ?
+                            HTTP_STATE_DONE : HTTP_STATE_CHUNK_END;
+                }
+            }
+            continue;
+        }
+
+        case HTTP_STATE_ERROR:
+            return HTTP_PARSER_ERROR;
+        }
+
+        /* Every other state works on whole lines. */
+        if (!HttpParser_line(parser, data[used++]))
+        {
+            continue;
+        }
+
+        ok = 1;
+        switch (parser->state)
+        {
+        case HTTP_STATE_STATUS:
+            ok = HttpParser_status(parser);
+            parser->state = HTTP_STATE_HEADER;
+            break;
+
+        case HTTP_STATE_HEADER:
+            if (parser->line[0] == '\0')
+            {
+                HttpParser_body(parser);
+            }
+            else
+            {
+                ok = HttpParser_header(parser);
+            }
+            break;
+
+        case HTTP_STATE_CHUNK_SIZE:
+            ok = HttpParser_chunkSize(parser);
+            break;
+
+        case HTTP_STATE_CHUNK_END:
+            ok = (parser->line[0] == '\0');
+            parser->state = HTTP_STATE_CHUNK_SIZE;
+            break;
+
+        case HTTP_STATE_TRAILER:
+            if (parser->line[0] == '\0')
+            {
+                parser->state = HTTP_STATE_DONE;
+            }
+            else
+            {
+                ok = HttpParser_header(parser);
+            }
+            break;
+        }
+
+        if (!ok)
+        {
+            parser->state = HTTP_STATE_ERROR;
+            return HTTP_PARSER_ERROR;
+        }
+    }
+
+    return used;
+}
+
+_i32 HttpParser_finish(HttpParser_t *parser)
+{
+    if (parser->state == HTTP_STATE_BODY_CLOSE)
+    {
+        parser->state = HTTP_STATE_DONE;
+    }
+    else if (parser->state != HTTP_STATE_DONE)
+    {
+        parser->state = HTTP_STATE_ERROR;
+        return HTTP_PARSER_ERROR;
+    }
+    return 0;
+}
+
+_u8 HttpParser_isDone(const HttpParser_t *parser)
+{
+    return parser->state == HTTP_STATE_DONE;
+}
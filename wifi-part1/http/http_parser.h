@@ -0,0 +1,122 @@
+/**
+ * Incremental parser of HTTP/1.1 responses.
+ *
+ * The response is fed in chunks of any size as they come out of sl_Recv(),
+ * the parser keeps its state between calls and never allocates. Header
+ * lines are gathered one at a time in a buffer of HTTP_LINE_SIZE bytes and
+ * passed to the header callback, the body is passed on to the body callback
+ * straight from the received data, whether its length is given by
+ * Content-Length, by chunked transfer encoding or by the server closing the
+ * connection.
+ */
+#ifndef __HTTP_PARSER_H__
+#define __HTTP_PARSER_H__
+
+#include "simplelink.h"
+
+/* Longest status or header line kept, longer ones are cut. */
+#define HTTP_LINE_SIZE      128
+
+/* Returned by HttpParser_feed() and HttpParser_finish() on a malformed
+ * response. */
+#define HTTP_PARSER_ERROR   (-1)
+
+/* Flags of the response, from its headers. */
+#define HTTP_FLAG_LENGTH    0x01    /* Content-Length given */
+#define HTTP_FLAG_CHUNKED   0x02    /* Transfer-Encoding: chunked */
+#define HTTP_FLAG_CLOSE     0x04    /* Connection: close */
+
+/**
+ * Defines the parser states.
+ *
+ * HTTP_STATE_STATUS -> reading the status line.
+ * HTTP_STATE_HEADER -> reading header lines until an empty one.
+ * HTTP_STATE_BODY -> body of Content-Length bytes.
+ * HTTP_STATE_BODY_CLOSE -> body ending when the connection closes.
+ * HTTP_STATE_CHUNK_SIZE -> size line of a chunk.
+ * HTTP_STATE_CHUNK_DATA -> data of a chunk.
+ * HTTP_STATE_CHUNK_END -> line ending the data of a chunk.
+ * HTTP_STATE_TRAILER -> trailer lines after the last chunk.
+ * HTTP_STATE_DONE -> complete response.
+ * HTTP_STATE_ERROR -> malformed response.
+ */
+typedef enum
+{
+    HTTP_STATE_STATUS,
+    HTTP_STATE_HEADER,
+    HTTP_STATE_BODY,
+    HTTP_STATE_BODY_CLOSE,
+    HTTP_STATE_CHUNK_SIZE,
+    HTTP_STATE_CHUNK_DATA,
+    HTTP_STATE_CHUNK_END,
+    HTTP_STATE_TRAILER,
+    HTTP_STATE_DONE,
+    HTTP_STATE_ERROR
+} HttpState_t;
+
+struct HttpParser;
+
+/* Called for every header line, name and value without spaces around. */
+typedef void (*HttpHeaderCallback)(struct HttpParser *parser,
+                                   const char *name, const char *value);
+
+/* Called for every piece of body, as many times as it takes. */
+typedef void (*HttpBodyCallback)(struct HttpParser *parser, const _u8 *data,
+                                 _u16 length);
+
+/**
+ * Parser state.
+ *
+ * state -> HttpState_t.
+ * flags -> HTTP_FLAG_ bits.
+ * status -> status code of the response.
+ * length -> Content-Length of the response.
+ * remaining -> body bytes left in the response or in the current chunk.
+ * line -> line being gathered, line_length bytes long.
+ * onHeader, onBody -> callbacks, may be NULL.
+ * context -> free for the owner of the parser.
+ */
+typedef struct HttpParser
+{
+    _u8 state;
+    _u8 flags;
+    _u16 status;
+    _u32 length;
+    _u32 remaining;
+    char line[HTTP_LINE_SIZE];
+    _u16 line_length;
+    HttpHeaderCallback onHeader;
+    HttpBodyCallback onBody;
+    void *context;
+} HttpParser_t;
+
+/**
+ * Prepares the parser for a new response.
+ */
+void HttpParser_init(HttpParser_t *parser, HttpHeaderCallback onHeader,
+                     HttpBodyCallback onBody, void *context);
+
+/**
+ * Parses the next length bytes of the response. Returns the number of bytes
+ * used, which is less than length only once the response is complete and the
+ * rest belongs to the next one, or HTTP_PARSER_ERROR.
+ */
+_i32 HttpParser_feed(HttpParser_t *parser, const _u8 *data, _u16 length);
+
+/**
+ * Tells the parser the server closed the connection. Completes a body that
+ * lasts until then, returns HTTP_PARSER_ERROR if the response was cut short.
+ */
+_i32 HttpParser_finish(HttpParser_t *parser);
+
+/**
+ * Tells if the response has been received in full.
+ */
+_u8 HttpParser_isDone(const HttpParser_t *parser);
+
+/**
+ * Tells if two header names are equal, ignoring case.
+ */
+_u8 HttpParser_equals(const char *a, const char *b);
+
+#endif
@@ -0,0 +1,476 @@
+/* Incremental SAX style JSON tokenizer, see json_parser.h. */
+#include "json_parser.h"
+
+/**
+ * Defines the tokenizer states.
+ *
+ * JSON_STATE_VALUE -> a value is expected.
+ * JSON_STATE_ARRAY_FIRST -> a value or the end of an empty array.
+ * JSON_STATE_OBJECT_FIRST -> a key or the end of an empty object.
+ * JSON_STATE_KEY -> the key of the next member.
+ * JSON_STATE_COLON -> the colon after a key.
+ * JSON_STATE_STRING -> characters of a string.
+ * JSON_STATE_ESCAPE -> character after a backslash.
+ * JSON_STATE_UNICODE -> hex digits of a \u escape.
+ * JSON_STATE_NUMBER -> characters of a number.
+ * JSON_STATE_LITERAL -> characters of true, false or null.
+ * JSON_STATE_AFTER -> a comma or the end of the container.
+ * JSON_STATE_DONE -> complete document.
+ * JSON_STATE_ERROR -> malformed document.
+ *
+ * The string states are or'ed with JSON_KEY_FLAG while reading a key.
+ */
+typedef enum
+{
+    JSON_STATE_VALUE,
+    JSON_STATE_ARRAY_FIRST,
+    JSON_STATE_OBJECT_FIRST,
+    JSON_STATE_KEY,
+    JSON_STATE_COLON,
+    JSON_STATE_STRING,
+    JSON_STATE_ESCAPE,
+    JSON_STATE_UNICODE,
+    JSON_STATE_NUMBER,
+    JSON_STATE_LITERAL,
+    JSON_STATE_AFTER,
+    JSON_STATE_DONE,
+    JSON_STATE_ERROR
+} JsonState_t;
+
+#define JSON_KEY_FLAG   0x80
+
+/* Results of JsonParser_byte(). */
+#define JSON_BYTE_USED      1
+#define JSON_BYTE_AGAIN     0
+#define JSON_BYTE_ERROR     (-1)
+
+#define JSON_IS_SPACE(c)    (((c) == ' ') || ((c) == '\t') || \
+                             ((c) == '\r') || ((c) == '\n'))
+#define JSON_IS_DIGIT(c)    (((c) >= '0') && ((c) <= '9'))
+
+static const char *const json_literals[] = { "true", "false", "null" };
+
+void JsonParser_init(JsonParser_t *parser, JsonCallback callback,
+                     void *context)
+{
+    parser->state = JSON_STATE_VALUE;
+    parser->depth = 0;
+    parser->containers = 0;
+    parser->token_length = 0;
+    parser->literal = 0;
+    parser->unicode_digits = 0;
+    parser->unicode = 0;
+    parser->callback = callback;
+    parser->context = context;
+}
+
+static void JsonParser_emit(JsonParser_t *parser, JsonEvent_t event)
+{
+    if (parser->callback)
+    {
+        parser->token[parser->token_length] = '\0';
+        parser->callback(parser, event, parser->token, parser->token_length);
+    }
+}
+
+/* Adds a character to a string, past the end of the buffer it is cut. */
+static void JsonParser_add(JsonParser_t *parser, char c)
+{
+    if (parser->token_length < JSON_TOKEN_SIZE - 1)
+    {
+        parser->token[parser->token_length++] = c;
+    }
+}
+
+/* Moves on after a complete value. */
+static void JsonParser_valueEnd(JsonParser_t *parser)
+{
+    parser->state = parser->depth ? JSON_STATE_AFTER : JSON_STATE_DONE;
+}
+
+static _u8 JsonParser_inObject(const JsonParser_t *parser)
+{
+    return (parser->containers >> (parser->depth - 1)) & 1;
+}
+
+static _u8 JsonParser_open(JsonParser_t *parser, _u8 object)
+{
+    if (parser->depth == JSON_MAX_DEPTH)
+    {
+        return 0;
+    }
+
+    parser->containers &= ~(1 << parser->depth);
+    parser->containers |= object << parser->depth;
+    parser->depth++;
+    parser->token_length = 0;
+    JsonParser_emit(parser, object ? JSON_OBJECT_START : JSON_ARRAY_START);
+    parser->state = object ? JSON_STATE_OBJECT_FIRST : JSON_STATE_ARRAY_FIRST;
+    return 1;
+}
+
+static void JsonParser_close(JsonParser_t *parser)
+{
+    parser->token_length = 0;
+    JsonParser_emit(parser,
+                    JsonParser_inObject(parser) ?
+                            JSON_OBJECT_END : JSON_ARRAY_END);
+    parser->depth--;
+    JsonParser_valueEnd(parser);
+}
+
+/* Checks a number against the JSON grammar: -?int(.digits)?([eE][+-]?digits)? */
+static _u8 JsonParser_number(const JsonParser_t *parser)
+{
+    const char *c = parser->token;
+    const char *end = parser->token + parser->token_length;
+
+    if ((c < end) && (*c == '-'))
+    {
+        c++;
+    }
+    if ((c == end) || !JSON_IS_DIGIT(*c))
+    {
+        return 0;
+    }
+    if (*c == '0')
+    {
+        c++;
+    }
+    else
+    {
+        for (; (c < end) && JSON_IS_DIGIT(*c); c++);
+    }
+
+    if ((c < end) && (*c == '.'))
+    {
+        c++;
+        if ((c == end) || !JSON_IS_DIGIT(*c))
+        {
+            return 0;
+        }
+        for (; (c < end) && JSON_IS_DIGIT(*c); c++);
+    }
+
+    if ((c < end) && ((*c == 'e') || (*c == 'E')))
+    {
+        c++;
+        if ((c < end) && ((*c == '+') || (*c == '-')))
+        {
+            c++;
+        }
+        if ((c == end) || !JSON_IS_DIGIT(*c))
+        {
+            return 0;
+        }
+        for (; (c < end) && JSON_IS_DIGIT(*c); c++);
+    }
+
+    return c == end;
+}
+
+static _u8 JsonParser_hex(_u8 c)
+{
+    if (JSON_IS_DIGIT(c))
+    {
+        return c - '0';
+    }
+    c |= 0x20;
+    if ((c >= 'a') && (c <= 'f'))
+    {
+        return c - 'a' + 10;
+    }
+    return 0xFF;
+}
+
+/* Starts the value beginning with c. */
+static _i8 JsonParser_value(JsonParser_t *parser, _u8 c)
+{
+    parser->token_length = 0;
+
+    switch (c)
+    {
+    case '{':
+        return JsonParser_open(parser, 1) ? JSON_BYTE_USED : JSON_BYTE_ERROR;
+    case '[':
+        return JsonParser_open(parser, 0) ? JSON_BYTE_USED : JSON_BYTE_ERROR;
+    case '"':
+        parser->state = JSON_STATE_STRING;
+        return JSON_BYTE_USED;
+    case 't':
+    case 'f':
+    case 'n':
+        parser->token[parser->token_length++] = c;
+        parser->literal = 1;
+        parser->state = JSON_STATE_LITERAL;
+        return JSON_BYTE_USED;
+    }
+
+    if ((c == '-') || JSON_IS_DIGIT(c))
+    {
+        parser->token[parser->token_length++] = c;
+        parser->state = JSON_STATE_NUMBER;
+        return JSON_BYTE_USED;
+    }
+    return JSON_BYTE_ERROR;
+}
+
+/* Parses one byte. */
+static _i8 JsonParser_byte(JsonParser_t *parser, _u8 c)
+{
+    _u8 key = parser->state & JSON_KEY_FLAG;
+    const char *literal;
+    _u8 digit;
+
+    switch (parser->state & ~JSON_KEY_FLAG)
+    {
+    case JSON_STATE_VALUE:
+    case JSON_STATE_ARRAY_FIRST:
+        if (JSON_IS_SPACE(c))
+        {
+            return JSON_BYTE_USED;
+        }
+        if ((c == ']') && (parser->state == JSON_STATE_ARRAY_FIRST))
+        {
+            JsonParser_close(parser);
+            return JSON_BYTE_USED;
+        }
+        return JsonParser_value(parser, c);
+
+    case JSON_STATE_OBJECT_FIRST:
+    case JSON_STATE_KEY:
+        if (JSON_IS_SPACE(c))
+        {
+            return JSON_BYTE_USED;
+        }
+        if ((c == '}') && (parser->state == JSON_STATE_OBJECT_FIRST))
+        {
+            JsonParser_close(parser);
+            return JSON_BYTE_USED;
+        }
+        if (c != '"')
+        {
+            return JSON_BYTE_ERROR;
+        }
+        parser->token_length = 0;
+        parser->state = JSON_STATE_STRING | JSON_KEY_FLAG;
+        return JSON_BYTE_USED;
+
+    case JSON_STATE_COLON:
+        if (JSON_IS_SPACE(c))
+        {
+            return JSON_BYTE_USED;
+        }
+        if (c != ':')
+        {
+            return JSON_BYTE_ERROR;
+        }
+        parser->state = JSON_STATE_VALUE;
+        return JSON_BYTE_USED;
+
+    case JSON_STATE_STRING:
+        if (c == '"')
+        {
+            JsonParser_emit(parser, key ? JSON_KEY : JSON_STRING);
+            if (key)
+            {
+                parser->state = JSON_STATE_COLON;
+            }
+            else
+            {
+                JsonParser_valueEnd(parser);
+            }
+        }
+        else if (c == '\\')
+        {
+            parser->state = JSON_STATE_ESCAPE | key;
+        }
+        else if (c < 0x20)
+        {
+            return JSON_BYTE_ERROR;
+        }
+        else
+        {
+            JsonParser_add(parser, c);
+        }
+        return JSON_BYTE_USED;
+
+    case JSON_STATE_ESCAPE:
+        switch (c)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            break;
+        case 'b':
+            c = '\b';
+            break;
+        case 'f':
+            c = '\f';
+            break;
+        case 'n':
+            c = '\n';
+            break;
+        case 'r':
+            c = '\r';
+            break;
+        case 't':
+            c = '\t';
+            break;
+        case 'u':
+            parser->unicode = 0;
+            parser->unicode_digits = 0;
+            parser->state = JSON_STATE_UNICODE | key;
+            return JSON_BYTE_USED;
+        default:
+            return JSON_BYTE_ERROR;
+        }
+        JsonParser_add(parser, c);
+        parser->state = JSON_STATE_STRING | key;
+        return JSON_BYTE_USED;
+
+    case JSON_STATE_UNICODE:
+        digit = JsonParser_hex(c);
+        if (digit == 0xFF)
+        {
+            return JSON_BYTE_ERROR;
+        }
+        parser->unicode = (parser->unicode << 4) | digit;
+        if (++parser->unicode_digits == 4)
+        {
+            /* The font only has ASCII, anything else becomes '?'. */
+            JsonParser_add(parser,
+                           (parser->unicode < 0x80) ? parser->unicode : '?');
+            parser->state = JSON_STATE_STRING | key;
+        }
+        return JSON_BYTE_USED;
+
+    case JSON_STATE_NUMBER:
+        if (JSON_IS_DIGIT(c) || (c == '-') || (c == '+') || (c == '.') ||
+            (c == 'e') || (c == 'E'))
+        {
+            if (parser->token_length == JSON_TOKEN_SIZE - 1)
+            {
+                return JSON_BYTE_ERROR;
+            }
+            parser->token[parser->token_length++] = c;
+            return JSON_BYTE_USED;
+        }
+        if (!JsonParser_number(parser))
+        {
+            return JSON_BYTE_ERROR;
+        }
+        JsonParser_emit(parser, JSON_NUMBER);
+        JsonParser_valueEnd(parser);
+        return JSON_BYTE_AGAIN;
+
+    case JSON_STATE_LITERAL:
+        literal = json_literals[(parser->token[0] == 't') ? 0 :
+                                (parser->token[0] == 'f') ? 1 : 2];
+        if (c != (_u8) literal[parser->literal])
+        {
+            return JSON_BYTE_ERROR;
+        }
+        if (literal[++parser->literal] == '\0')
+        {
+            parser->token_length = 0;
+            JsonParser_emit(parser,
+                            (literal == json_literals[0]) ? JSON_TRUE :
+                            (literal == json_literals[1]) ?
+                                    JSON_FALSE : JSON_NULL);
+            JsonParser_valueEnd(parser);
+        }
+        return JSON_BYTE_USED;
+
+    case JSON_STATE_AFTER:
+        if (JSON_IS_SPACE(c))
+        {
+            return JSON_BYTE_USED;
+        }
+        if (c == ',')
+        {
+            parser->state = JsonParser_inObject(parser) ?
+                    JSON_STATE_KEY : JSON_STATE_VALUE;
+            return JSON_BYTE_USED;
+        }
+        if (c == (JsonParser_inObject(parser) ? '}' : ']'))
+        {
+            JsonParser_close(parser);
+            return JSON_BYTE_USED;
+        }
+        return JSON_BYTE_ERROR;
+    }
+
+    return JSON_BYTE_ERROR;
+}
+
+_i32 JsonParser_feed(JsonParser_t *parser, const _u8 *data, _u16 length)
+{
+    _u16 used = 0;
+    _i8 result;
+    _u8 c;
+
+    if (parser->state == JSON_STATE_ERROR)
+    {
+        return JSON_PARSER_ERROR;
+    }
+
+    while ((used < length) && (parser->state != JSON_STATE_DONE))
+    {
+        /* Plain string characters make up most of a document, copy them
+         * without going through the state machine. */
+        if ((parser->state & ~JSON_KEY_FLAG) == JSON_STATE_STRING)
+        {
+            while (used < length)
+            {
+                c = data[used];
+                if ((c == '"') || (c == '\\') || (c < 0x20))
+                {
+                    break;
+                }
+                JsonParser_add(parser, c);
+                used++;
+            }
+            if (used == length)
+            {
+                break;
+            }
+        }
+
+        result = JsonParser_byte(parser, data[used]);
+        if (result == JSON_BYTE_ERROR)
+        {
+            parser->state = JSON_STATE_ERROR;
+            return JSON_PARSER_ERROR;
+        }
+        used += result;
+    }
+
+    return used;
+}
+
+_i32 JsonParser_finish(JsonParser_t *parser)
+{
+    if (parser->state == JSON_STATE_NUMBER)
+    {
+        if (!JsonParser_number(parser))
+        {
+            parser->state = JSON_STATE_ERROR;
+            return JSON_PARSER_ERROR;
+        }
+        JsonParser_emit(parser, JSON_NUMBER);
+        JsonParser_valueEnd(parser);
+    }
+
+    if (parser->state != JSON_STATE_DONE)
+    {
+        parser->state = JSON_STATE_ERROR;
+        return JSON_PARSER_ERROR;
+    }
+    return 0;
+}
+
+_u8 JsonParser_isDone(const JsonParser_t *parser)
+{
+    return parser->state == JSON_STATE_DONE;
+}
@@ -0,0 +1,109 @@
+/**
+ * Incremental SAX style JSON tokenizer.
+ *
+ * The document is fed in pieces of any size, such as the body pieces given
+ * by the HTTP parser, and every element found is reported to a callback as
+ * soon as it is complete. Nothing but the current string or number is kept:
+ * memory use is the JsonParser_t alone, whatever the size of the document.
+ */
+#ifndef __JSON_PARSER_H__
+#define __JSON_PARSER_H__
+
+#include "simplelink.h"
+
+/* Longest string or number kept, longer strings are cut, longer numbers
+ * are an error. */
+#define JSON_TOKEN_SIZE     32
+
+/* Deepest nesting of objects and arrays, bits of JsonParser_t.containers. */
+#define JSON_MAX_DEPTH      16
+
+/* Returned by JsonParser_feed() and JsonParser_finish() on malformed
+ * input. */
+#define JSON_PARSER_ERROR   (-1)
+
+/**
+ * Defines the elements reported to the callback.
+ *
+ * JSON_OBJECT_START, JSON_OBJECT_END -> '{' and '}'.
+ * JSON_ARRAY_START, JSON_ARRAY_END -> '[' and ']'.
+ * JSON_KEY -> name of the next member of an object.
+ * JSON_STRING -> string value, escapes decoded.
+ * JSON_NUMBER -> number value, as written.
+ * JSON_TRUE, JSON_FALSE, JSON_NULL -> literal values.
+ */
+typedef enum
+{
+    JSON_OBJECT_START,
+    JSON_OBJECT_END,
+    JSON_ARRAY_START,
+    JSON_ARRAY_END,
+    JSON_KEY,
+    JSON_STRING,
+    JSON_NUMBER,
+    JSON_TRUE,
+    JSON_FALSE,
+    JSON_NULL
+} JsonEvent_t;
+
+struct JsonParser;
+
+/**
+ * Called for every element. text is the terminated key, string or number,
+ * length bytes long, and is only valid during the call. parser->depth is
+ * the number of containers open, counting the one starting or ending.
+ */
+typedef void (*JsonCallback)(struct JsonParser *parser, JsonEvent_t event,
+                             const char *text, _u8 length);
+
+/**
+ * Tokenizer state.
+ *
+ * state -> position in the grammar, see json_parser.c.
+ * depth -> containers open.
+ * containers -> one bit per open container, set for objects.
+ * token -> string or number being gathered, token_length bytes long.
+ * literal -> characters of true, false or null matched so far.
+ * unicode -> \u escape being decoded, unicode_digits hex digits read.
+ * callback -> called for every element, may be NULL.
+ * context -> free for the owner of the tokenizer.
+ */
+typedef struct JsonParser
+{
+    _u8 state;
+    _u8 depth;
+    _u16 containers;
+    char token[JSON_TOKEN_SIZE];
+    _u8 token_length;
+    _u8 literal;
+    _u8 unicode_digits;
+    _u16 unicode;
+    JsonCallback callback;
+    void *context;
+} JsonParser_t;
+
+/**
+ * Prepares the tokenizer for a new document.
+ */
+void JsonParser_init(JsonParser_t *parser, JsonCallback callback,
+                     void *context);
+
+/**
+ * Parses the next length bytes of the document. Returns the number of bytes
+ * used, which is less than length only once the document is complete, or
+ * JSON_PARSER_ERROR.
+ */
+_i32 JsonParser_feed(JsonParser_t *parser, const _u8 *data, _u16 length);
+
+/**
+ * Tells the tokenizer the document ended. Reports a number still being
+ * read, returns JSON_PARSER_ERROR if the document is incomplete.
+ */
+_i32 JsonParser_finish(JsonParser_t *parser);
+
+/**
+ * Tells if a complete document has been parsed.
+ */
+_u8 JsonParser_isDone(const JsonParser_t *parser);
+
+#endif
@@ -0,0 +1,303 @@
+/* Extraction of the cities of the weather response, see weather_json.h. */
+#include "weather_json.h"
+#include "sl_common.h"
+#include <string.h>
+
+/* Members of a city, bits of WeatherRecord_t.fields. */
+#define WEATHER_FIELD_NAME          0x01
+#define WEATHER_FIELD_TEMPERATURE   0x02
+#define WEATHER_FIELD_HUMIDITY      0x04
+#define WEATHER_FIELD_WEATHER       0x08
+
+#define WEATHER_LOWER(c)    ((((c) >= 'A') && ((c) <= 'Z')) ? \
+                             ((c) + 'a' - 'A') : (c))
+
+typedef struct
+{
+    const char *text;
+    _u8 value;
+} WeatherName_t;
+
+/* Keys of the members read, compared ignoring case. */
+static const WeatherName_t weather_keys[] = {
+    { "name", WEATHER_FIELD_NAME },
+    { "city", WEATHER_FIELD_NAME },
+    { "temperature", WEATHER_FIELD_TEMPERATURE },
+    { "temp", WEATHER_FIELD_TEMPERATURE },
+    { "humidity", WEATHER_FIELD_HUMIDITY },
+    { "weather", WEATHER_FIELD_WEATHER },
+    { "condition", WEATHER_FIELD_WEATHER }
+};
+
+/* Beginnings of the condition texts, compared ignoring case. */
+static const WeatherName_t weather_conditions[] = {
+    { "partly", WEATHER_PARTLY_CLOUDY },
+    { "cloud", WEATHER_PARTLY_CLOUDY },
+    { "snow", WEATHER_SNOWY },
+    { "sun", WEATHER_SUNNY },
+    { "clear", WEATHER_SUNNY },
+    { "rain", WEATHER_RAINY }
+};
+
+#define WEATHER_COUNT(table)    (sizeof(table) / sizeof(table[0]))
+
+/* Tells if text starts with prefix, ignoring case. */
+static _u8 WeatherJson_startsWith(const char *text, const char *prefix)
+{
+    for (; *prefix; text++, prefix++)
+    {
+        if (WEATHER_LOWER(*text) != *prefix)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Looks text up in a table, returns 0xFF when missing. */
+static _u8 WeatherJson_lookup(const WeatherName_t *table, _u8 count,
+                              const char *text, _u8 whole)
+{
+    _u8 i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (WeatherJson_startsWith(text, table[i].text) &&
+            (!whole || (text[pal_Strlen(table[i].text)] == '\0')))
+        {
+            return table[i].value;
+        }
+    }
+    return 0xFF;
+}
+
+/**
+ * Reads a decimal number as tenths, rounded. Returns 0 if text is not a
+ * plain decimal number.
+ */
+static _u8 WeatherJson_tenths(const char *text, _i32 *tenths)
+{
+    _u8 negative = 0;
+    _u8 digits = 0;
+    _i32 value = 0;
+
+    if (*text == '-')
+    {
+        negative = 1;
+        text++;
+    }
+
+    for (; (*text >= '0') && (*text <= '9'); text++, digits++)
+    {
+        if (value < 100000)
+        {
+            value = value * 10 + (*text - '0');
+        }
+    }
+    value *= 10;
+
+    if (*text == '.')
+    {
+        text++;
+        if ((*text >= '0') && (*text <= '9'))
+        {
+            value += *text++ - '0';
+            digits++;
+            if ((*text >= '5') && (*text <= '9'))
+            {
+                value++;
+            }
+        }
+        for (; (*text >= '0') && (*text <= '9'); text++);
+    }
+
+    if ((digits == 0) || (*text != '\0'))
+    {
+        return 0;
+    }
+
+    *tenths = negative ? -value : value;
+    return 1;
+}
+
+/* Stores a member of the innermost object. */
+static void WeatherJson_value(WeatherJson_t *parser, JsonEvent_t event,
+                              const char *text, _u8 length)
+{
+    WeatherRecord_t *record = &parser->records[parser->objects - 1];
+    _i32 tenths;
+    _u8 weather;
+
+    switch (parser->field)
+    {
+    case WEATHER_FIELD_NAME:
+        if (event != JSON_STRING)
+        {
+            return;
+        }
+        if (length > NAME_LENGTH - 1)
+        {
+            length = NAME_LENGTH - 1;
+        }
+        pal_Memcpy(record->city.name, text, length);
+        record->city.name[length] = '\0';
+        break;
+
+    case WEATHER_FIELD_TEMPERATURE:
+    case WEATHER_FIELD_HUMIDITY:
+        if (((event != JSON_NUMBER) && (event != JSON_STRING)) ||
+            !WeatherJson_tenths(text, &tenths))
+        {
+            return;
+        }
+        if (parser->field == WEATHER_FIELD_TEMPERATURE)
+        {
+            record->city.temperature = (tenths > 32767) ? 32767 :
+                                       (tenths < -32767) ? -32767 : tenths;
+        }
+        else
+        {
+            tenths = (tenths + 5) / 10;
+            record->city.humidity = (tenths > 100) ? 100 :
+                                    (tenths < 0) ? 0 : tenths;
+        }
+        break;
+
+    case WEATHER_FIELD_WEATHER:
+        weather = (event == JSON_STRING) ?
+                WeatherJson_lookup(weather_conditions,
+                                   WEATHER_COUNT(weather_conditions), text, 0) :
+                0xFF;
+        if (weather == 0xFF)
+        {
+            return;
+        }
+        record->city.weather = weather;
+        break;
+
+    default:
+        return;
+    }
+
+    record->fields |= parser->field;
+}
+
+/* Completes the innermost object. */
+static void WeatherJson_close(WeatherJson_t *parser)
+{
+    WeatherRecord_t *record = &parser->records[parser->objects - 1];
+    WeatherRecord_t *outer;
+
+    if (record->fields & WEATHER_FIELD_NAME)
+    {
+        if (parser->count < parser->max_cities)
+        {
+            parser->cities[parser->count++] = record->city;
+        }
+        return;
+    }
+
+    /* Nameless objects hold members of the enclosing city. */
+    if (parser->objects < 2)
+    {
+        return;
+    }
+    outer = record - 1;
+    if (!(outer->fields & WEATHER_FIELD_TEMPERATURE) &&
+        (record->fields & WEATHER_FIELD_TEMPERATURE))
+    {
+        outer->city.temperature = record->city.temperature;
+    }
+    if (!(outer->fields & WEATHER_FIELD_HUMIDITY) &&
+        (record->fields & WEATHER_FIELD_HUMIDITY))
+    {
+        outer->city.humidity = record->city.humidity;
+    }
+    if (!(outer->fields & WEATHER_FIELD_WEATHER) &&
+        (record->fields & WEATHER_FIELD_WEATHER))
+    {
+        outer->city.weather = record->city.weather;
+    }
+    outer->fields |= record->fields;
+}
+
+static void WeatherJson_event(JsonParser_t *json, JsonEvent_t event,
+                              const char *text, _u8 length)
+{
+    WeatherJson_t *parser = (WeatherJson_t*) json->context;
+    _u8 field;
+
+    switch (event)
+    {
+    case JSON_OBJECT_START:
+        parser->objects++;
+        parser->field = 0;
+        if (parser->objects <= WEATHER_JSON_LEVELS)
+        {
+            pal_Memset(&parser->records[parser->objects - 1], 0,
+                       sizeof(WeatherRecord_t));
+        }
+        break;
+
+    case JSON_OBJECT_END:
+        if (parser->objects <= WEATHER_JSON_LEVELS)
+        {
+            WeatherJson_close(parser);
+        }
+        parser->objects--;
+        parser->field = 0;
+        break;
+
+    case JSON_KEY:
+        field = WeatherJson_lookup(weather_keys, WEATHER_COUNT(weather_keys),
+                                   text, 1);
+        parser->field = (field == 0xFF) ? 0 : field;
+        parser->key_depth = json->depth;
+        break;
+
+    case JSON_STRING:
+    case JSON_NUMBER:
+        /* Only values given right to the key, not inside arrays. */
+        if (parser->field && (json->depth == parser->key_depth) &&
+            (parser->objects <= WEATHER_JSON_LEVELS))
+        {
+            WeatherJson_value(parser, event, text, length);
+        }
+        parser->field = 0;
+        break;
+
+    default:
+        if (json->depth == parser->key_depth)
+        {
+            parser->field = 0;
+        }
+        break;
+    }
+}
+
+void WeatherJson_init(WeatherJson_t *parser, City_t *cities,
+                      _u16 max_cities)
+{
+    JsonParser_init(&parser->json, WeatherJson_event, parser);
+    parser->cities = cities;
+    parser->max_cities = max_cities;
+    parser->count = 0;
+    parser->objects = 0;
+    parser->field = 0;
+    parser->key_depth = 0;
+}
+
+_i32 WeatherJson_feed(WeatherJson_t *parser, const _u8 *data, _u16 length)
+{
+    return JsonParser_feed(&parser->json, data, length);
+}
+
+_i32 WeatherJson_finish(WeatherJson_t *parser)
+{
+    return JsonParser_finish(&parser->json);
+}
+
+_u16 WeatherJson_count(const WeatherJson_t *parser)
+{
+    return parser->count;
+}
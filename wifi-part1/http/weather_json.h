@@ -0,0 +1,111 @@
+/**
+ * Extracts the cities of the weather response while it is received.
+ *
+ * Runs on top of the JSON tokenizer, so the body is never held in full: each
+ * object with a "name" (or "city") member becomes a City_t as soon as the
+ * object closes. Its other members are read as:
+ *
+ * "temperature" or "temp" -> degrees Celsius, number or numeric string.
+ * "humidity" -> percent, number or numeric string.
+ * "weather" or "condition" -> text such as "Partly cloudy", "Snowy",
+ *                             "Sunny" or "Rainy".
+ *
+ * Members found in an inner object without a name, as in
+ * {"name": "ROME", "main": {"temp": 17.3, "humidity": 63}}, are given to the
+ * enclosing object. Cities can sit anywhere in the document, for example in
+ * an array at top level or under a "cities" member.
+ */
+#ifndef __WEATHER_JSON_H__
+#define __WEATHER_JSON_H__
+
+#include "json_parser.h"
+
+/* Same limits as lcd-part2/weather.h, terminator included. */
+#define NAME_LENGTH 16
+#define MAX_CITIES 256
+
+/* Objects nested deeper than this are skipped. */
+#define WEATHER_JSON_LEVELS 4
+
+/**
+ * Defines the weather conditions, in the order of lcd-part2/weather.h.
+ */
+typedef enum
+{
+    WEATHER_PARTLY_CLOUDY, WEATHER_SNOWY, WEATHER_SUNNY, WEATHER_RAINY,
+    WEATHER_NUM
+} Weather_t;
+
+/**
+ * Struct that holds information for a specific city, laid out as City_t of
+ * lcd-part2/weather.h so the records can be handed over as they are.
+ *
+ * name -> city name, at most NAME_LENGTH - 1 characters.
+ * temperature -> tenths of degree Celsius.
+ * humidity -> relative humidity in percent.
+ * weather -> Weather_t condition.
+ */
+typedef struct
+{
+    char name[NAME_LENGTH];
+    _i16 temperature;
+    _u8 humidity;
+    _u8 weather;
+} City_t;
+
+/**
+ * City being read at one level of objects.
+ *
+ * city -> members found so far, zero when missing.
+ * fields -> WEATHER_FIELD_ bits of the members found.
+ */
+typedef struct
+{
+    City_t city;
+    _u8 fields;
+} WeatherRecord_t;
+
+/**
+ * Extractor state.
+ *
+ * json -> tokenizer of the body.
+ * cities -> where the cities go, up to max_cities of them.
+ * count -> cities found so far.
+ * objects -> objects open.
+ * field -> WEATHER_FIELD_ bit of the last key, key_depth its nesting.
+ * records -> city being read at each of the outer levels of objects.
+ */
+typedef struct
+{
+    JsonParser_t json;
+    City_t *cities;
+    _u16 max_cities;
+    _u16 count;
+    _u8 objects;
+    _u8 field;
+    _u8 key_depth;
+    WeatherRecord_t records[WEATHER_JSON_LEVELS];
+} WeatherJson_t;
+
+/**
+ * Prepares the extractor to fill cities with a new document.
+ */
+void WeatherJson_init(WeatherJson_t *parser, City_t *cities,
+                      _u16 max_cities);
+
+/**
+ * Parses the next length bytes of the body, see JsonParser_feed().
+ */
+_i32 WeatherJson_feed(WeatherJson_t *parser, const _u8 *data, _u16 length);
+
+/**
+ * Tells the extractor the body ended, see JsonParser_finish().
+ */
+_i32 WeatherJson_finish(WeatherJson_t *parser);
+
+/**
+ * Number of cities filled in so far.
+ */
+_u16 WeatherJson_count(const WeatherJson_t *parser);
+
+#endif
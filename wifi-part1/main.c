@@ -1,5 +1,10 @@
 #include "simplelink.h"
 #include "sl_common.h"
+#include "http_parser.h"
+#include "weather_json.h"
+#include "http_fetch.h"
+#include "dns_cache.h"
+#include "http_cache.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -12,19 +17,33 @@
 #define PASSKEY         ""   /* Password in case of secure AP */
 #define PASSKEY_LEN     pal_Strlen(PASSKEY)      /* Password length in case of secure AP */
 
+/* 1 to connect with the profile and policy kept by the device from the last
+ * boot, 0 to always reset it to its default state first. */
+#define FAST_BOOT               1
+
+/* Longest wait for the connection made with the kept profile, in ms. */
+#define FAST_CONNECT_TIMEOUT    5000
+
 /* Http request variables. */
 #define SL_STOP_TIMEOUT        0xFF
 
 #define MOCK_SERVER  "cctest.free.beeceptor.com"
 
-#define PREFIX_BUFFER   "GET /my/api"
-#define POST_BUFFER     " HTTP/1.1\r\nHost:cctest.free.beeceptor.com\r\nAccept: */"
-#define POST_BUFFER2    "*\r\n\r\n"
+#define MOCK_PORT    80
 
 #define SMALL_BUF           32
-#define MAX_SEND_BUF_SIZE   512
 #define MAX_SEND_RCV_SIZE   300
 
+/* Resources fetched together, their cities are appended in this order. */
+static const char *const requestPaths[] = { "/my/api" };
+#define REQUEST_COUNT   (sizeof(requestPaths) / sizeof(requestPaths[0]))
+
+/* Cities kept for each response while they are all received. */
+#define CITIES_PER_REQUEST  (MAX_CITIES / REQUEST_COUNT)
+
+/* Longest wait for all the responses, in ms. */
+#define FETCH_TIMEOUT       10000
+
 /* Application specific status/error codes. */
 typedef enum
 {
@@ -32,34 +51,98 @@ typedef enum
     HTTP_SEND_ERROR = DEVICE_NOT_IN_STATION_MODE - 1,
     HTTP_RECV_ERROR = HTTP_SEND_ERROR - 1,
     HTTP_INVALID_RESPONSE = HTTP_RECV_ERROR - 1,
+    WLAN_CONNECT_TIMEOUT = HTTP_INVALID_RESPONSE - 1,
     STATUS_CODE_MAX = -0xBB8
 } e_AppStatusCodes;
 
+/* Boot phases, timed in g_BootTimes. */
+typedef enum
+{
+    BOOT_PHASE_START,       /* first sl_Start() */
+    BOOT_PHASE_CONFIGURE,   /* reset to the default state and restart */
+    BOOT_PHASE_CONNECT,     /* until connected to the AP */
+    BOOT_PHASE_IP,          /* until the IP address is acquired */
+    BOOT_PHASE_DATA,        /* until the weather data is received */
+    BOOT_PHASES
+} e_BootPhases;
+
+/* A response being received, the parser context points to it. */
+typedef struct
+{
+    HttpParser_t Parser;
+    WeatherJson_t Json;
+    _i32 JsonStatus;
+    _u32 BodyLength;
+
+    /* Validators sent with the request and received with the response. */
+    char Conditions[HTTP_CONDITIONS_SIZE];
+    HttpValidators_t Validators;
+} Response_t;
+
 /* GLOBAL VARIABLES. */
 
 _u32 g_Status = 0;
 
+/* Time spent in each boot phase and in total, in ms. Fast is set when the
+ * reset to the default state was skipped. Slept is the part of each phase
+ * the MCU spent in LPM0, ConnectDuty the percentage of the connection to
+ * the AP it was awake. */
+struct
+{
+    _u32 Phase[BOOT_PHASES];
+    _u32 Slept[BOOT_PHASES];
+    _u32 Total;
+    _u32 Mark;
+    _u32 SleepMark;
+    _u8 Fast;
+    _u8 ConnectDuty;
+} g_BootTimes;
+
 /* Request buffer to send/receive data from server. */
 struct
 {
     _u8 Recvbuff[MAX_SEND_RCV_SIZE];
-    _u8 SendBuff[MAX_SEND_BUF_SIZE];
 
     _u8 HostName[SMALL_BUF];
 
     _u32 DestinationIP;
-    _i16 SockID;
+
+    HttpFetch_t Fetch;
+    HttpRequest_t Requests[REQUEST_COUNT];
+    Response_t Responses[REQUEST_COUNT];
+    _u32 BodyLength;
+
+    /* Cities of the responses, filled in while the bodies are received,
+     * each response in its own CITIES_PER_REQUEST slice. */
+    City_t Cities[MAX_CITIES];
+    _u16 CityCount;
+
+    /* Cleared when all the responses were 304 and the cities come from
+     * the cache, so there is nothing to redraw. */
+    _u8 Changed;
+
+    /* MCU cycles spent extracting the cities, ParseCycles / BodyLength
+     * gives the cycles per byte. */
+    _u32 ParseCycles;
 } g_AppData;
 
 /* Static functions definition. */
+static _i32 startSimpleLink();
+static _u8 isConfigured();
 static _i32 establishConnectionWithAP();
+static _i32 waitForIP(_u32 timeout);
+static _i32 waitForStatus(e_StatusBits bit, _u8 value, _u32 start,
+                          _u32 timeout);
 static _i32 disconnectFromAP();
 static _i32 configureSimpleLinkToDefaultState();
+static void markBootPhase(e_BootPhases phase);
 static _i32 initializeAppVariables();
 static _i32 getHostIP();
-static _i32 createConnection();
 static _i32 getResponse();
 static _i32 getData();
+static void onHeader(HttpParser_t *parser, const char *name,
+                     const char *value);
+static void onBody(HttpParser_t *parser, const _u8 *data, _u16 length);
 
 /* ASYNCHRONOUS EVENT HANDLERS. */
 
@@ -159,27 +242,17 @@ int main(int argc, char **argv)
     /* Stop WDT and initialize the system-clock of the MCU. */
     stopWDT();
     initClk();
-
-    retVal = configureSimpleLinkToDefaultState();
+    initTick();
+    g_BootTimes.Mark = getTick();
+    g_BootTimes.SleepMark = getSleepTime();
+    DnsCache_init();
+    HttpCache_init();
+
+    /* Starts the device and connects to the WLAN AP. */
+    retVal = startSimpleLink();
     if (retVal < 0)
     {
-        if (DEVICE_NOT_IN_STATION_MODE == retVal)
-            //Failed to configure the device in its default state.
-            LOOP_FOREVER();
-    }
-
-    retVal = sl_Start(0, 0, 0);
-    if ((retVal < 0) || (ROLE_STA != retVal))
-    {
-        //" Failed to start the device.
-        LOOP_FOREVER();
-    }
-
-    /* Connecting to WLAN AP. */
-    retVal = establishConnectionWithAP();
-    if (retVal < 0)
-    {
-        //Failed to establish connection with an AP.
+        //Failed to start the device or to connect to the AP.
         LOOP_FOREVER();
     }
 
@@ -190,6 +263,7 @@ int main(int argc, char **argv)
         //Failed to get weather information.
         LOOP_FOREVER();
     }
+    markBootPhase(BOOT_PHASE_DATA);
 
     /* Disconnects from the AP. */
     retVal = disconnectFromAP();
@@ -207,9 +281,9 @@ static _i32 getHostIP()
 {
     _i32 status = 0;
 
-    status = sl_NetAppDnsGetHostByName((_i8*) g_AppData.HostName,
-                                       pal_Strlen(g_AppData.HostName),
-                                       &g_AppData.DestinationIP, SL_AF_INET);
+    /* Asks the network processor only when the cached address expired. */
+    status = DnsCache_resolve((const char*) g_AppData.HostName,
+                              &g_AppData.DestinationIP);
     ASSERT_ON_ERROR(status);
 
     return SUCCESS;
@@ -228,86 +302,223 @@ static _i32 getResponse()
         ASSERT_ON_ERROR(retVal);
     }
 
-    g_AppData.SockID = createConnection();
-    ASSERT_ON_ERROR(g_AppData.SockID);
+    HttpFetch_init(&g_AppData.Fetch, MOCK_SERVER, g_AppData.DestinationIP,
+                   MOCK_PORT, g_AppData.Recvbuff, MAX_SEND_RCV_SIZE);
 
     retVal = getData();
-    ASSERT_ON_ERROR(retVal);
+    if (retVal < 0)
+    {
+        /* The address may be the cause, it is looked up next time. */
+        DnsCache_invalidate((const char*) g_AppData.HostName);
+        ASSERT_ON_ERROR(retVal);
+    }
 
-    retVal = sl_Close(g_AppData.SockID);
-    ASSERT_ON_ERROR(retVal);
+    /* Refreshes a stale address now that the network is free. */
+    DnsCache_revalidate();
 
     return 0;
 }
-/* Creates UDP socket to communicate with server. */
-static _i32 createConnection()
+/* This function Obtains the required data from the server. */
+static _i32 getData()
 {
-    SlSockAddrIn_t Addr;
+    Response_t *response;
+    _u16 count;
+    _u8 i;
+    _i32 retVal = -1;
 
-    _i16 sd = 0;
-    _i16 AddrSize = 0;
-    _i32 ret_val = 0;
+    g_AppData.CityCount = 0;
+    g_AppData.BodyLength = 0;
+    g_AppData.ParseCycles = 0;
+    g_AppData.Changed = 0;
 
-    Addr.sin_family = SL_AF_INET;
-    Addr.sin_port = sl_Htons(80);
+    /* Starts the cycle counter of the core. */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
-    /* Change the DestinationIP endianity, to big endian */
-    Addr.sin_addr.s_addr = sl_Htonl(g_AppData.DestinationIP);
+    for (i = 0; i < REQUEST_COUNT; i++)
+    {
+        response = &g_AppData.Responses[i];
+        HttpParser_init(&response->Parser, onHeader, onBody, response);
+        WeatherJson_init(&response->Json,
+                         &g_AppData.Cities[i * CITIES_PER_REQUEST],
+                         CITIES_PER_REQUEST);
+        response->JsonStatus = 0;
+        response->BodyLength = 0;
+        pal_Memset(&response->Validators, 0, sizeof(HttpValidators_t));
+
+        /* Asks for the body only if it changed since it was cached. */
+        HttpCache_conditions(requestPaths[i], response->Conditions);
+
+        g_AppData.Requests[i].path = requestPaths[i];
+        g_AppData.Requests[i].headers = response->Conditions;
+        g_AppData.Requests[i].parser = &response->Parser;
+    }
 
-    AddrSize = sizeof(SlSockAddrIn_t);
+    /* All the requests are in flight at once, each response is parsed as
+     * it comes in. */
+    retVal = HttpFetch_run(&g_AppData.Fetch, g_AppData.Requests,
+                           REQUEST_COUNT, FETCH_TIMEOUT);
+    if (retVal < 0)
+    {
+        ASSERT_ON_ERROR(HTTP_RECV_ERROR);
+    }
 
-    sd = sl_Socket(SL_AF_INET, SL_SOCK_STREAM, 0);
-    if (sd < 0)
+    for (i = 0; i < REQUEST_COUNT; i++)
     {
-        //Error creating socket.
-        ASSERT_ON_ERROR(sd);
+        response = &g_AppData.Responses[i];
+        retVal = g_AppData.Requests[i].result;
+        if ((retVal == HTTP_FETCH_INVALID) || (retVal == HTTP_FETCH_CLOSED))
+        {
+            ASSERT_ON_ERROR(HTTP_INVALID_RESPONSE);
+        }
+        if (retVal < 0)
+        {
+            ASSERT_ON_ERROR(HTTP_RECV_ERROR);
+        }
+
+        if (retVal == 304)
+        {
+            /* Unchanged, the cities kept from the last body are used. */
+            retVal = HttpCache_load(requestPaths[i],
+                                    &g_AppData.Cities[i * CITIES_PER_REQUEST],
+                                    CITIES_PER_REQUEST * sizeof(City_t));
+            if (retVal < 0)
+            {
+                HttpCache_invalidate(requestPaths[i]);
+                ASSERT_ON_ERROR(HTTP_INVALID_RESPONSE);
+            }
+            count = retVal / sizeof(City_t);
+        }
+        else
+        {
+            /* The body must hold the cities in a complete JSON document. */
+            if ((retVal != 200) || (response->JsonStatus < 0) ||
+                (WeatherJson_finish(&response->Json) < 0))
+            {
+                ASSERT_ON_ERROR(HTTP_INVALID_RESPONSE);
+            }
+            count = WeatherJson_count(&response->Json);
+
+            /* Kept for the next refresh, unless too large for the cache. */
+            HttpCache_store(requestPaths[i], &response->Validators,
+                            &g_AppData.Cities[i * CITIES_PER_REQUEST],
+                            count * sizeof(City_t), response->BodyLength);
+            g_AppData.Changed = 1;
+        }
+
+        /* Closes up the slices, in the order of requestPaths. */
+        memmove(&g_AppData.Cities[g_AppData.CityCount],
+                &g_AppData.Cities[i * CITIES_PER_REQUEST],
+                count * sizeof(City_t));
+        g_AppData.CityCount += count;
     }
 
-    ret_val = sl_Connect(sd, (SlSockAddr_t*) &Addr, AddrSize);
-    if (ret_val < 0)
+    return SUCCESS;
+}
+
+/* Receives the headers of the response, one at a time. */
+static void onHeader(HttpParser_t *parser, const char *name,
+                     const char *value)
+{
+    Response_t *response = (Response_t*) parser->context;
+
+    HttpCache_header(&response->Validators, name, value);
+}
+
+/* Receives the body of the response, a piece at a time. */
+static void onBody(HttpParser_t *parser, const _u8 *data, _u16 length)
+{
+    Response_t *response = (Response_t*) parser->context;
+    _u32 start;
+
+    g_AppData.BodyLength += length;
+    response->BodyLength += length;
+    if ((parser->status != 200) || (response->JsonStatus < 0))
     {
-        //Error connecting to server.
-        ASSERT_ON_ERROR(ret_val);
+        return;
     }
 
-    return sd;
+    start = DWT->CYCCNT;
+    response->JsonStatus = WeatherJson_feed(&response->Json, data, length);
+    g_AppData.ParseCycles += DWT->CYCCNT - start;
 }
-/* This function Obtains the required data from the server. */
-static _i32 getData()
+
+/**
+ * Starts the device connected to the AP with an IP address.
+ * When the device kept the profile of SSID_NAME and the fast connect policy
+ * from the last boot, it connects by itself as soon as it starts, so the
+ * reset to the default state and the restart are skipped. Otherwise, or if
+ * that connection does not come within FAST_CONNECT_TIMEOUT, the device is
+ * configured from scratch.
+ */
+static _i32 startSimpleLink()
 {
-    _u8 *p_bufLocation = NULL;
     _i32 retVal = -1;
 
-    pal_Memset(g_AppData.Recvbuff, 0, sizeof(g_AppData.Recvbuff));
-
-    /* Puts together the HTTP GET string. */
-    p_bufLocation = g_AppData.SendBuff;
-    pal_Strcpy(p_bufLocation, PREFIX_BUFFER);
+#if FAST_BOOT
+    retVal = sl_Start(0, 0, 0);
+    markBootPhase(BOOT_PHASE_START);
 
-    p_bufLocation += pal_Strlen(PREFIX_BUFFER);
-    pal_Strcpy(p_bufLocation, POST_BUFFER);
+    if ((ROLE_STA == retVal) && isConfigured())
+    {
+        g_BootTimes.Fast = 1;
+        if (waitForIP(FAST_CONNECT_TIMEOUT) == SUCCESS)
+        {
+            return SUCCESS;
+        }
+        g_BootTimes.Fast = 0;
+    }
 
-    p_bufLocation += pal_Strlen(POST_BUFFER);
-    pal_Strcpy(p_bufLocation, POST_BUFFER2);
+    if (retVal >= 0)
+    {
+        sl_Stop(SL_STOP_TIMEOUT);
+    }
+#endif
 
-    /* Send the HTTP GET string to the open TCP/IP socket. */
-    retVal = sl_Send(g_AppData.SockID, g_AppData.SendBuff,
-                     pal_Strlen(g_AppData.SendBuff), 0);
-    if (retVal != pal_Strlen(g_AppData.SendBuff))
-        ASSERT_ON_ERROR(HTTP_SEND_ERROR);
+    retVal = configureSimpleLinkToDefaultState();
+    if (DEVICE_NOT_IN_STATION_MODE == retVal)
+    {
+        //Failed to configure the device in its default state.
+        ASSERT_ON_ERROR(retVal);
+    }
 
-    /* Receive response. */
-    retVal = sl_Recv(g_AppData.SockID, &g_AppData.Recvbuff[0],
-    MAX_SEND_RCV_SIZE,
-                     0);
-    if (retVal <= 0)
+    retVal = sl_Start(0, 0, 0);
+    if ((retVal < 0) || (ROLE_STA != retVal))
     {
-        ASSERT_ON_ERROR(HTTP_RECV_ERROR);
+        //" Failed to start the device.
+        ASSERT_ON_ERROR(DEVICE_NOT_IN_STATION_MODE);
     }
+    markBootPhase(BOOT_PHASE_CONFIGURE);
 
-    g_AppData.Recvbuff[pal_Strlen(g_AppData.Recvbuff)] = '\0';
+    /* Connecting to WLAN AP. */
+    return establishConnectionWithAP();
+}
 
-    return SUCCESS;
+/* Tells if the device kept what configureSimpleLinkToDefaultState() stores
+ * for a fast boot: the fast connect policy and the profile of SSID_NAME. */
+static _u8 isConfigured()
+{
+    SlSecParams_t secParams = { 0 };
+    SlGetSecParamsExt_t secExtParams = { 0 };
+    _i8 name[MAXIMAL_SSID_LENGTH];
+    _u8 mac[6];
+    _u32 priority = 0;
+    _i16 nameLen = 0;
+    _u8 policy = 0;
+    _u8 policyLen = sizeof(policy);
+    _i32 retVal = -1;
+
+    retVal = sl_WlanPolicyGet(SL_POLICY_CONNECTION, 0, &policy, &policyLen);
+    if ((retVal < 0) || (policy != SL_CONNECTION_POLICY(1, 1, 0, 0, 0)))
+    {
+        return 0;
+    }
+
+    /* Returns the security type of the profile. */
+    retVal = sl_WlanProfileGet(0, name, &nameLen, mac, &secParams,
+                               &secExtParams, &priority);
+    return (SEC_TYPE == retVal) && (nameLen == pal_Strlen(SSID_NAME)) &&
+           (pal_Memcmp(name, SSID_NAME, nameLen) == 0);
 }
 
 /** This function configure the SimpleLink device in its default state. It:
@@ -319,12 +530,16 @@ static _i32 getData()
  * - Sets Tx power to maximum;
  * - Sets power policy to normal;
  * - Unregisters mDNS services;
- * - Remove all filters.
+ * - Remove all filters;
+ * - With FAST_BOOT, stores the AP profile and sets Auto and Fast connect.
  */
 static _i32 configureSimpleLinkToDefaultState()
 {
     SlVersionFull ver = { 0 };
     _WlanRxFilterOperationCommandBuff_t RxFilterIdMask = { 0 };
+#if FAST_BOOT
+    SlSecParams_t secParams = { 0 };
+#endif
 
     _u8 val = 1;
     _u8 configOpt = 0;
@@ -343,10 +558,7 @@ static _i32 configureSimpleLinkToDefaultState()
         if (ROLE_AP == mode)
         {
             /* If the device is in AP mode, we need to wait for this event before doing anything. */
-            while (!IS_IP_ACQUIRED(g_Status))
-            {
-                _SlNonOsMainLoopTask();
-            }
+            waitForStatus(STATUS_BIT_IP_ACQUIRED, 1, 0, 0);
         }
 
         /* Switch to STA role and restart. */
@@ -387,11 +599,8 @@ static _i32 configureSimpleLinkToDefaultState()
     retVal = sl_WlanDisconnect();
     if (0 == retVal)
     {
-        /* Wait until the device is connected. */
-        while (IS_CONNECTED(g_Status))
-        {
-            _SlNonOsMainLoopTask();
-        }
+        /* Wait until the device is disconnected. */
+        waitForStatus(STATUS_BIT_CONNECTION, 0, 0, 0);
     }
 
     /* Enable DHCP client. */
@@ -424,6 +633,21 @@ static _i32 configureSimpleLinkToDefaultState()
                                 sizeof(_WlanRxFilterOperationCommandBuff_t));
     ASSERT_ON_ERROR(retVal);
 
+#if FAST_BOOT
+    /* The device connects by itself from the next start on, see
+     * startSimpleLink(). */
+    secParams.Key = PASSKEY;
+    secParams.KeyLen = PASSKEY_LEN;
+    secParams.Type = SEC_TYPE;
+    retVal = sl_WlanProfileAdd(SSID_NAME, pal_Strlen(SSID_NAME), 0,
+                               &secParams, 0, 0, 0);
+    ASSERT_ON_ERROR(retVal);
+
+    retVal = sl_WlanPolicySet(SL_POLICY_CONNECTION,
+                              SL_CONNECTION_POLICY(1, 1, 0, 0, 0), NULL, 0);
+    ASSERT_ON_ERROR(retVal);
+#endif
+
     retVal = sl_Stop(SL_STOP_TIMEOUT);
     ASSERT_ON_ERROR(retVal);
 
@@ -453,12 +677,72 @@ static _i32 establishConnectionWithAP()
     retVal = sl_WlanConnect(SSID_NAME, pal_Strlen(SSID_NAME), 0, &secParams, 0);
     ASSERT_ON_ERROR(retVal);
 
-    while ((!IS_CONNECTED(g_Status)) || (!IS_IP_ACQUIRED(g_Status)))
+    return waitForIP(0);
+}
+
+/**
+ * Waits until the device is connected and has acquired an IP address, for
+ * timeout ms at most or forever if zero.
+ */
+static _i32 waitForIP(_u32 timeout)
+{
+    _u32 start = getTick();
+    _u32 connect;
+    _u32 slept;
+    _i32 retVal = -1;
+
+    retVal = waitForStatus(STATUS_BIT_CONNECTION, 1, start, timeout);
+    ASSERT_ON_ERROR(retVal);
+    markBootPhase(BOOT_PHASE_CONNECT);
+
+    retVal = waitForStatus(STATUS_BIT_IP_ACQUIRED, 1, start, timeout);
+    ASSERT_ON_ERROR(retVal);
+    markBootPhase(BOOT_PHASE_IP);
+
+    connect = g_BootTimes.Phase[BOOT_PHASE_CONNECT] +
+              g_BootTimes.Phase[BOOT_PHASE_IP];
+    slept = g_BootTimes.Slept[BOOT_PHASE_CONNECT] +
+            g_BootTimes.Slept[BOOT_PHASE_IP];
+    g_BootTimes.ConnectDuty = (connect > slept) ?
+            (_u8) ((connect - slept) * 100 / connect) : 0;
+
+    return SUCCESS;
+}
+
+/**
+ * Runs the SimpleLink events until the status bit has the value, for
+ * timeout ms from start at most or forever if zero. In between the MCU
+ * sleeps until the CC3100 interrupts.
+ */
+static _i32 waitForStatus(e_StatusBits bit, _u8 value, _u32 start,
+                          _u32 timeout)
+{
+    _u32 elapsed;
+    _u32 wait;
+
+    for (;;)
     {
         _SlNonOsMainLoopTask();
-    }
+        if (GET_STATUS_BIT(g_Status, bit) == value)
+        {
+            return SUCCESS;
+        }
 
-    return SUCCESS;
+        wait = EVENT_WAIT_MS;
+        if (timeout)
+        {
+            elapsed = getTick() - start;
+            if (elapsed >= timeout)
+            {
+                return WLAN_CONNECT_TIMEOUT;
+            }
+            if (timeout - elapsed < wait)
+            {
+                wait = timeout - elapsed;
+            }
+        }
+        waitForEvent(wait);
+    }
 }
 
 /**
@@ -473,15 +757,27 @@ static _i32 disconnectFromAP()
     if (0 == retVal)
     {
         /* Wait */
-        while (IS_CONNECTED(g_Status))
-        {
-            _SlNonOsMainLoopTask();
-        }
+        waitForStatus(STATUS_BIT_CONNECTION, 0, 0, 0);
     }
 
     return SUCCESS;
 }
 
+/* Adds the time since the last mark to the boot phase. A fast boot that
+ * timed out is counted in the configuration that follows. */
+static void markBootPhase(e_BootPhases phase)
+{
+    _u32 now = getTick();
+    _u32 slept = getSleepTime();
+
+    g_BootTimes.Phase[phase] += now - g_BootTimes.Mark;
+    g_BootTimes.Total += now - g_BootTimes.Mark;
+    g_BootTimes.Mark = now;
+
+    g_BootTimes.Slept[phase] += slept - g_BootTimes.SleepMark;
+    g_BootTimes.SleepMark = slept;
+}
+
 /* This function initializes the application variables. */
 static _i32 initializeAppVariables()
 {
@@ -123,6 +123,7 @@ SECTIONS
     .vtable :   > 0x20000000
     .data   :   > SRAM_DATA
     .bss    :   > SRAM_DATA
+    .TI.noinit : > SRAM_DATA     /* not cleared at startup, see http/dns_cache.c, http_cache.c */
     .sysmem :   > SRAM_DATA
     .stack  :   > SRAM_DATA (HIGH)
 
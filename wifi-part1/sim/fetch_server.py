@@ -0,0 +1,104 @@
+"""Stand-in weather server for sim/http_fetch_test.c.
+
+Usage: python3 sim/fetch_server.py [port]
+
+Answers GET /<mode>/<city> with a weather document for the city, upper
+case, in JSON. The mode tells how the connection is treated:
+
+  keep    kept alive for as long as the client wants.
+  close2  every second response on a connection says "Connection: close".
+  idle2   closed without a word after every second response, the way a
+          server times out an idle connection while requests are on the way.
+  drop    closed without answering.
+  retry   closed without answering the first time a city is asked, then
+          answered with "Connection: close".
+
+GET /stats answers with the number of TCP connections accepted since the
+previous /stats, its own left out, and forgets the cities asked in retry.
+
+Connections are closed the way HTTP servers do, sending FIN and reading
+what the client still sends until it closes, so that requests it pipelined
+do not turn the close into a reset that would lose the last responses.
+"""
+
+import http.server
+import json
+import socket
+import socketserver
+import sys
+
+
+class WeatherHandler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def setup(self):
+        super().setup()
+        self.served = 0
+
+    def log_message(self, *args):
+        pass
+
+    def send_body(self, body, close=False):
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        if close:
+            self.send_header("Connection", "close")
+            self.close_connection = True
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_GET(self):
+        if self.path == "/stats":
+            connections = self.server.connections - 1
+            self.server.connections = 0
+            self.server.asked.clear()
+            self.send_body(str(connections).encode())
+            return
+
+        parts = self.path.strip("/").split("/")
+        mode, city = (parts[0], parts[-1]) if len(parts) == 2 else ("", "")
+        if mode not in ("keep", "close2", "idle2", "drop", "retry"):
+            self.send_error(404)
+            return
+        if mode == "drop" or (mode == "retry" and
+                              city not in self.server.asked):
+            self.server.asked.add(city)
+            self.close_connection = True
+            return
+
+        self.served += 1
+        body = json.dumps([{"name": city.upper(), "temperature": 17.3,
+                            "humidity": 63, "weather": "Sunny"}]).encode()
+        self.send_body(body, mode == "retry" or
+                       (mode == "close2" and self.served % 2 == 0))
+        if mode == "idle2" and self.served % 2 == 0:
+            self.close_connection = True
+
+    def finish(self):
+        super().finish()
+        try:
+            self.connection.shutdown(socket.SHUT_WR)
+            self.connection.settimeout(1)
+            while self.connection.recv(4096):
+                pass
+        except OSError:
+            pass
+
+
+class WeatherServer(socketserver.ThreadingTCPServer):
+    allow_reuse_address = True
+    daemon_threads = True
+    connections = 0
+    asked = set()
+
+    def process_request(self, request, client_address):
+        # Counted as they are accepted, in order, so /stats sees all the
+        # connections made before it.
+        self.connections += 1
+        super().process_request(request, client_address)
+
+
+if __name__ == "__main__":
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 8080
+    WeatherServer(("127.0.0.1", port), WeatherHandler).serve_forever()
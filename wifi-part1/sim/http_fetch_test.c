@@ -0,0 +1,176 @@
+/**
+ * Checks the connections http_fetch.c makes, on the host.
+ *
+ * HttpFetch_run() talks to sim/fetch_server.py through sim/sl_socket_sim.c,
+ * which puts the sl_ socket calls on the sockets of the host. Each run asks
+ * for TEST_REQUESTS cities, spread over the HTTP_FETCH_SOCKETS connections,
+ * and checks that every city comes back and how many TCP connections, so
+ * handshakes, it took, as counted by HttpFetch_t.connects and by the server:
+ *
+ * - kept alive, one per socket,
+ * - closed with "Connection: close" every second response, the requests
+ *   pipelined behind go on a new connection,
+ * - closed silently by the server every second response, as after an idle
+ *   timeout, the requests lost are sent again on a new connection,
+ * - closed without any answer, each socket tries HTTP_RECONNECTS new
+ *   connections and its requests fail with HTTP_FETCH_CLOSED,
+ * - closed without an answer the first time a city is asked, then answered
+ *   with "Connection: close", two connections per request: the announced
+ *   close must not use up the new connections allowed after a silent one.
+ *
+ * Build from wifi-part1 with:
+ *
+ *   gcc -DWIFI_SIM -Isim/include -I. -Isimplelink/include -Iboard -Icli_uart
+ *       -Ispi_cc3100 -Iuart_cc3100 -Ihttp -o http_fetch_test
+ *       sim/http_fetch_test.c sim/sl_socket_sim.c http/http_fetch.c
+ *       http/http_parser.c http/json_parser.c http/weather_json.c
+ *
+ * and run with the server listening on TEST_PORT:
+ *
+ *   python3 sim/fetch_server.py 8080 & ./http_fetch_test; kill %1
+ */
+#ifdef WIFI_SIM
+
+#include <stdio.h>
+#include <string.h>
+#include "sim_test.h"
+#include "http_fetch.h"
+#include "weather_json.h"
+
+/* Port of sim/fetch_server.py on 127.0.0.1. */
+#define TEST_PORT           8080
+#define TEST_IP             0x7F000001
+
+/* Requests of a run, four on each connection. */
+#define TEST_REQUESTS       (4 * HTTP_FETCH_SOCKETS)
+
+/* Longest run, in ms. */
+#define TEST_TIMEOUT_MS     5000
+
+static const char *const Test_cities[TEST_REQUESTS] = {
+    "rome", "moscow", "tokyo", "paris", "berlin", "madrid", "oslo", "lima",
+    "cairo", "delhi", "seoul", "dublin", "vienna", "prague", "sofia", "riga"
+};
+
+/* A response and the city extracted from it. */
+typedef struct
+{
+    HttpParser_t parser;
+    WeatherJson_t json;
+    City_t cities[2];
+} Test_Response_t;
+
+static Test_Response_t Test_responses[TEST_REQUESTS];
+static char Test_paths[TEST_REQUESTS][32];
+static HttpRequest_t Test_requests[TEST_REQUESTS];
+static _u8 Test_buffer[300];
+static _u32 Test_stats;
+
+static void Test_onBody(HttpParser_t *parser, const _u8 *data, _u16 length)
+{
+    Test_Response_t *response = parser->context;
+
+    WeatherJson_feed(&response->json, data, length);
+}
+
+static void Test_onStats(HttpParser_t *parser, const _u8 *data, _u16 length)
+{
+    (void)parser;
+
+    while (length--)
+    {
+        Test_stats = Test_stats * 10 + (*data++ - '0');
+    }
+}
+
+/* Connections the server accepted since it was last asked. */
+static _u32 Test_serverConnections(void)
+{
+    HttpParser_t parser;
+    HttpRequest_t request;
+    HttpFetch_t fetch;
+
+    Test_stats = 0;
+    HttpParser_init(&parser, NULL, Test_onStats, NULL);
+    request.path = "/stats";
+    request.headers = NULL;
+    request.parser = &parser;
+
+    HttpFetch_init(&fetch, "localhost", TEST_IP, TEST_PORT, Test_buffer,
+                   sizeof(Test_buffer));
+    SIM_TEST_EQUAL(HttpFetch_run(&fetch, &request, 1, TEST_TIMEOUT_MS), 1);
+    SIM_TEST_EQUAL(request.result, 200);
+    return Test_stats;
+}
+
+/* Asks for count cities in mode, checks each result is result and the
+ * connections made. */
+static void Test_run(const char *mode, _u8 count, _i32 result,
+                     _u16 connects)
+{
+    Test_Response_t *response;
+    HttpFetch_t fetch;
+    char name[NAME_LENGTH];
+    _i32 answered;
+    _u8 i, j;
+
+    for (i = 0; i < count; i++)
+    {
+        response = &Test_responses[i];
+        HttpParser_init(&response->parser, NULL, Test_onBody, response);
+        WeatherJson_init(&response->json, response->cities, 2);
+        sprintf(Test_paths[i], "/%s/%s", mode, Test_cities[i]);
+        Test_requests[i].path = Test_paths[i];
+        Test_requests[i].headers = NULL;
+        Test_requests[i].parser = &response->parser;
+    }
+
+    HttpFetch_init(&fetch, "localhost", TEST_IP, TEST_PORT, Test_buffer,
+                   sizeof(Test_buffer));
+    answered = HttpFetch_run(&fetch, Test_requests, count, TEST_TIMEOUT_MS);
+
+    SIM_TEST_EQUAL(answered, (result == 200) ? count : 0);
+    for (i = 0; i < count; i++)
+    {
+        SIM_TEST_EQUAL(Test_requests[i].result, result);
+        if (result != 200)
+        {
+            continue;
+        }
+
+        response = &Test_responses[i];
+        for (j = 0; Test_cities[i][j]; j++)
+        {
+            name[j] = Test_cities[i][j] - 'a' + 'A';
+        }
+        name[j] = '\0';
+        SIM_TEST_EQUAL(WeatherJson_finish(&response->json), 0);
+        SIM_TEST_EQUAL(WeatherJson_count(&response->json), 1);
+        SIM_TEST_CHECK(strcmp(response->cities[0].name, name) == 0);
+    }
+
+    SIM_TEST_EQUAL(fetch.connects, connects);
+    SIM_TEST_EQUAL(Test_serverConnections(), connects);
+    printf("%s: %u requests, %u connections in %lu ms\n", mode, count,
+           fetch.connects, fetch.total_ms);
+}
+
+int main(void)
+{
+    /*
+     * Clears what the server counted before.
+     */
+    Test_serverConnections();
+
+    Test_run("keep", 1, 200, 1);
+    Test_run("keep", TEST_REQUESTS, 200, HTTP_FETCH_SOCKETS);
+    Test_run("close2", TEST_REQUESTS, 200, 2 * HTTP_FETCH_SOCKETS);
+    Test_run("idle2", TEST_REQUESTS, 200, 2 * HTTP_FETCH_SOCKETS);
+    Test_run("retry", TEST_REQUESTS, 200, 2 * TEST_REQUESTS);
+    Test_run("drop", TEST_REQUESTS, HTTP_FETCH_CLOSED,
+             (1 + HTTP_RECONNECTS) * HTTP_FETCH_SOCKETS);
+
+    return Sim_Test_report("http_fetch_test");
+}
+
+#endif
@@ -0,0 +1,401 @@
+/**
+ * Checks http_parser.c on the host.
+ *
+ * Streams of responses are fed to HttpParser_feed() in pieces of random
+ * size, from one byte to a full TCP segment, the way sl_Recv() may cut them.
+ * Whenever a response completes, its status, body and one of its headers are
+ * compared with the expected ones and a fresh parser takes the bytes that
+ * follow, as http_fetch.c does on a kept alive connection. The streams hold:
+ *
+ * - a body framed by Content-Length,
+ * - a chunked body with chunk extensions and trailers,
+ * - a body lasting until the server closes the connection,
+ * - interim 1xx responses before the final one,
+ * - pipelined responses, with and without a body, and a header longer
+ *   than HTTP_LINE_SIZE.
+ *
+ * Malformed and truncated responses must be reported as errors.
+ *
+ * Build and run from wifi-part1:
+ *
+ *   gcc -DWIFI_SIM -Isim/include -I. -Isimplelink/include -Iboard -Icli_uart
+ *       -Ispi_cc3100 -Iuart_cc3100 -Ihttp -o http_parser_test
+ *       sim/http_parser_test.c http/http_parser.c && ./http_parser_test
+ */
+#ifdef WIFI_SIM
+
+#include <string.h>
+#include "sim_test.h"
+#include "http_parser.h"
+
+/* Seeds of the random splits tried on every stream. */
+#define TEST_SEEDS          500
+
+/* Largest piece fed at once, a TCP segment. */
+#define TEST_SEGMENT        1460
+
+/* Largest body and stream built by the test. */
+#define TEST_BODY_SIZE      5000
+#define TEST_STREAM_SIZE    12000
+
+/* A response expected out of a stream. */
+typedef struct
+{
+    _u16 status;
+    const char *body;
+    _u16 bodyLength;
+    const char *header;     /* Header that must be seen, NULL if none */
+    const char *value;      /* and its value */
+} Test_Response_t;
+
+/* What the callbacks collected of the response being parsed. */
+static char Test_body[TEST_BODY_SIZE];
+static _u16 Test_bodyLength;
+static _u8 Test_headerSeen;
+
+static char Test_stream[TEST_STREAM_SIZE];
+static char Test_text[TEST_BODY_SIZE];
+
+/* State of the random splits, stdlib.h clashes with the FD_ macros of
+ * socket.h. */
+static _u32 Test_seed;
+
+/* Next number of a xorshift sequence, never 0. */
+static _u32 Test_random(void)
+{
+    Test_seed ^= (Test_seed << 13) & 0xFFFFFFFF;
+    Test_seed ^= Test_seed >> 17;
+    Test_seed ^= (Test_seed << 5) & 0xFFFFFFFF;
+    return Test_seed;
+}
+
+static void Test_onHeader(HttpParser_t *parser, const char *name,
+                          const char *value)
+{
+    const Test_Response_t *expected = parser->context;
+
+    if (expected->header && HttpParser_equals(name, expected->header) &&
+        (strcmp(value, expected->value) == 0))
+    {
+        Test_headerSeen = 1;
+    }
+}
+
+static void Test_onBody(HttpParser_t *parser, const _u8 *data, _u16 length)
+{
+    (void)parser;
+
+    if (Test_bodyLength + length <= TEST_BODY_SIZE)
+    {
+        memcpy(Test_body + Test_bodyLength, data, length);
+    }
+    Test_bodyLength += length;
+}
+
+static void Test_start(HttpParser_t *parser, const Test_Response_t *expected)
+{
+    HttpParser_init(parser, Test_onHeader, Test_onBody, (void*)expected);
+    Test_bodyLength = 0;
+    Test_headerSeen = 0;
+}
+
+static void Test_check(const HttpParser_t *parser,
+                       const Test_Response_t *expected)
+{
+    SIM_TEST_EQUAL(parser->status, expected->status);
+    SIM_TEST_EQUAL(Test_bodyLength, expected->bodyLength);
+    SIM_TEST_CHECK((Test_bodyLength == expected->bodyLength) &&
+                   (memcmp(Test_body, expected->body, Test_bodyLength) == 0));
+    SIM_TEST_EQUAL(Test_headerSeen, expected->header != NULL);
+}
+
+/**
+ * Feeds a stream in random pieces and checks the count responses coming out
+ * of it, the last one ended by the server closing the connection when close
+ * is set.
+ */
+static void Test_parse(const char *stream, _u16 length,
+                       const Test_Response_t *expected, _u8 count,
+                       _u8 close, unsigned seed)
+{
+    HttpParser_t parser;
+    _u16 segment = (seed % 4 == 0) ? 1 : (seed % 4 == 1) ? 7 : TEST_SEGMENT;
+    _u16 position = 0;
+    _u16 piece;
+    _i32 used;
+    _u8 done = 0;
+
+    Test_seed = seed;
+    Test_start(&parser, &expected[0]);
+
+    while ((position < length) && (done < count))
+    {
+        piece = 1 + Test_random() % segment;
+        if (piece > length - position)
+        {
+            piece = length - position;
+        }
+
+        /* The rest of a piece goes to the next response. */
+        while ((piece > 0) && (done < count))
+        {
+            used = HttpParser_feed(&parser, (const _u8*)stream + position,
+                                   piece);
+            SIM_TEST_CHECK((used >= 0) && (used <= piece));
+            if ((used < 0) || (used > piece))
+            {
+                return;
+            }
+            SIM_TEST_CHECK((used == piece) || HttpParser_isDone(&parser));
+            position += used;
+            piece -= used;
+
+            if (HttpParser_isDone(&parser))
+            {
+                Test_check(&parser, &expected[done]);
+                if (++done < count)
+                {
+                    Test_start(&parser, &expected[done]);
+                }
+            }
+        }
+    }
+
+    if (close && (done < count))
+    {
+        SIM_TEST_EQUAL(HttpParser_finish(&parser), 0);
+        SIM_TEST_CHECK(HttpParser_isDone(&parser));
+        Test_check(&parser, &expected[done]);
+        done++;
+    }
+
+    SIM_TEST_EQUAL(done, count);
+    SIM_TEST_EQUAL(position, length);
+}
+
+/* Runs a stream through every seed. */
+static void Test_seeds(const char *stream, _u16 length,
+                       const Test_Response_t *expected, _u8 count, _u8 close)
+{
+    unsigned seed;
+
+    for (seed = 1; seed <= TEST_SEEDS; seed++)
+    {
+        Test_parse(stream, length, expected, count, close, seed);
+    }
+}
+
+/* Appends to the stream being built, returns its new length. */
+static _u16 Test_append(_u16 length, const char *data, _u16 size)
+{
+    memcpy(Test_stream + length, data, size);
+    return length + size;
+}
+
+static void Test_contentLength(void)
+{
+    Test_Response_t expected = { 200, Test_text, 4999, "ETag", "\"x1\"" };
+    _u16 length;
+
+    length = sprintf(Test_stream, "HTTP/1.1 200 OK\r\n"
+                                  "Content-Length: 4999\r\n"
+                                  "etag:   \"x1\"  \r\n"
+                                  "\r\n");
+    length = Test_append(length, Test_text, 4999);
+    Test_seeds(Test_stream, length, &expected, 1, 0);
+}
+
+static void Test_chunked(void)
+{
+    Test_Response_t expected = { 200, Test_text, 4999, "X-Checksum", "1" };
+    _u16 length, offset, size;
+    _u8 i;
+
+    length = sprintf(Test_stream, "HTTP/1.1 200 OK\r\n"
+                                  "Transfer-Encoding: gzip, Chunked\r\n"
+                                  "Trailer: X-Checksum\r\n"
+                                  "\r\n");
+    for (offset = 0, i = 0; offset < 4999; offset += size, i++)
+    {
+        size = 1 + (offset * 7) % 700;
+        if (size > 4999 - offset)
+        {
+            size = 4999 - offset;
+        }
+
+        /* Sizes in either case, with and without extensions. */
+        switch (i % 3)
+        {
+        case 0:
+            length += sprintf(Test_stream + length, "%x\r\n", size);
+            break;
+        case 1:
+            length += sprintf(Test_stream + length, "%X;ext=1\r\n", size);
+            break;
+        default:
+            length += sprintf(Test_stream + length,
+                              "%x;name=\"quoted; value\"\r\n", size);
+            break;
+        }
+        length = Test_append(length, Test_text + offset, size);
+        length = Test_append(length, "\r\n", 2);
+    }
+    length += sprintf(Test_stream + length, "0;last\r\n"
+                                            "X-Checksum: 1\r\n"
+                                            "\r\n");
+    Test_seeds(Test_stream, length, &expected, 1, 0);
+}
+
+static void Test_close(void)
+{
+    static const char stream[] = "HTTP/1.0 200 OK\n"
+                                 "Content-Type: text/plain\n"
+                                 "\n"
+                                 "hello\r\nworld";
+    Test_Response_t expected = { 200, "hello\r\nworld", 12, "Content-Type",
+                                 "text/plain" };
+
+    Test_seeds(stream, sizeof(stream) - 1, &expected, 1, 1);
+}
+
+static void Test_interim(void)
+{
+    static const char stream[] = "HTTP/1.1 100 Continue\r\n"
+                                 "\r\n"
+                                 "HTTP/1.1 103 Early Hints\r\n"
+                                 "Link: </style.css>; rel=preload\r\n"
+                                 "Content-Length: 99\r\n"
+                                 "\r\n"
+                                 "HTTP/1.1 200 OK\r\n"
+                                 "Connection: keep-alive\r\n"
+                                 "Transfer-Encoding: chunked\r\n"
+                                 "\r\n"
+                                 "5\r\nhello\r\n0\r\n\r\n";
+    Test_Response_t expected = { 200, "hello", 5, "Connection", "keep-alive" };
+
+    Test_seeds(stream, sizeof(stream) - 1, &expected, 1, 0);
+}
+
+static void Test_pipelined(void)
+{
+    static const Test_Response_t expected[] =
+    {
+        { 200, "first", 5, "Cache-Control", "max-age=600" },
+        { 304, "", 0, "ETag", "\"x2\"" },
+        { 200, "second", 6, NULL, NULL },
+        { 204, "", 0, NULL, NULL },
+        { 200, "", 0, NULL, NULL },
+        { 404, "missing", 7, "Connection", "close" }
+    };
+    _u16 length;
+
+    length = sprintf(Test_stream, "HTTP/1.1 200 OK\r\n"
+                                  "Set-Cookie: ");
+    memset(Test_stream + length, 'c', 3 * HTTP_LINE_SIZE);
+    length += 3 * HTTP_LINE_SIZE;
+    length += sprintf(Test_stream + length,
+                      "\r\n"
+                      "Content-Length: 5\r\n"
+                      "Cache-Control: max-age=600\r\n"
+                      "\r\n"
+                      "first"
+                      "HTTP/1.1 304 Not Modified\r\n"
+                      "ETag: \"x2\"\r\n"
+                      "Content-Length: 1000\r\n"
+                      "\r\n"
+                      "HTTP/1.1 200 OK\r\n"
+                      "Transfer-Encoding: chunked\r\n"
+                      "\r\n"
+                      "3\r\nsec\r\n3\r\nond\r\n0\r\n\r\n"
+                      "HTTP/1.1 204 No Content\r\n"
+                      "\r\n"
+                      "HTTP/1.1 200 OK\r\n"
+                      "Content-Length: 0\r\n"
+                      "\r\n"
+                      "HTTP/1.1 404 Not Found\r\n"
+                      "Connection: close\r\n"
+                      "\r\n"
+                      "missing");
+    Test_seeds(Test_stream, length, expected,
+               sizeof(expected) / sizeof(expected[0]), 1);
+}
+
+/* Feeds a whole stream, then closes when close is set. */
+static _i32 Test_malformed(const char *stream, _u8 close)
+{
+    HttpParser_t parser;
+    _i32 result;
+
+    HttpParser_init(&parser, NULL, NULL, NULL);
+    result = HttpParser_feed(&parser, (const _u8*)stream, strlen(stream));
+    if ((result >= 0) && close)
+    {
+        result = HttpParser_finish(&parser);
+    }
+
+    /* An error sticks. */
+    if (result < 0)
+    {
+        SIM_TEST_EQUAL(HttpParser_feed(&parser, (const _u8*)"\r\n", 2),
+                       HTTP_PARSER_ERROR);
+        SIM_TEST_CHECK(!HttpParser_isDone(&parser));
+    }
+    return result;
+}
+
+static void Test_errors(void)
+{
+    SIM_TEST_EQUAL(Test_malformed("FOO 200 OK\r\n", 0), HTTP_PARSER_ERROR);
+    SIM_TEST_EQUAL(Test_malformed("HTTP/1.1 2x0 OK\r\n", 0),
+                   HTTP_PARSER_ERROR);
+    SIM_TEST_EQUAL(Test_malformed("HTTP/1.1 200 OK\r\n"
+                                  "No colon\r\n", 0), HTTP_PARSER_ERROR);
+    SIM_TEST_EQUAL(Test_malformed("HTTP/1.1 200 OK\r\n"
+                                  "Content-Length: 12a\r\n", 0),
+                   HTTP_PARSER_ERROR);
+    SIM_TEST_EQUAL(Test_malformed("HTTP/1.1 200 OK\r\n"
+                                  "Content-Length:\r\n", 0),
+                   HTTP_PARSER_ERROR);
+    SIM_TEST_EQUAL(Test_malformed("HTTP/1.1 200 OK\r\n"
+                                  "Transfer-Encoding: chunked\r\n"
+                                  "\r\n"
+                                  "zz\r\n", 0), HTTP_PARSER_ERROR);
+    SIM_TEST_EQUAL(Test_malformed("HTTP/1.1 200 OK\r\n"
+                                  "Transfer-Encoding: chunked\r\n"
+                                  "\r\n"
+                                  "3\r\nabcd\r\n", 0), HTTP_PARSER_ERROR);
+
+    /* Cut short by the server. */
+    SIM_TEST_EQUAL(Test_malformed("HTTP/1.1 200 OK\r\n"
+                                  "Content-Length: 10\r\n"
+                                  "\r\n"
+                                  "abc", 1), HTTP_PARSER_ERROR);
+    SIM_TEST_EQUAL(Test_malformed("HTTP/1.1 200 OK\r\n"
+                                  "Transfer-Encoding: chunked\r\n"
+                                  "\r\n"
+                                  "3\r\nabc\r\n", 1), HTTP_PARSER_ERROR);
+    SIM_TEST_EQUAL(Test_malformed("HTTP/1.1 200 OK\r\n"
+                                  "Content-Length: 0\r\n", 1),
+                   HTTP_PARSER_ERROR);
+}
+
+int main(void)
+{
+    _u16 i;
+
+    for (i = 0; i < TEST_BODY_SIZE; i++)
+    {
+        Test_text[i] = 'a' + i % 26;
+    }
+
+    Test_contentLength();
+    Test_chunked();
+    Test_close();
+    Test_interim();
+    Test_pipelined();
+    Test_errors();
+
+    return Sim_Test_report("http_parser_test");
+}
+
+#endif
@@ -0,0 +1,13 @@
+/**
+ * Host stand-in for the MSP432 register header.
+ *
+ * Only used by the host tests in sim/. The modules under http/ do not touch
+ * the hardware, they only include msp432.h through simplelink.h and board.h,
+ * which need nothing from it but the standard integer types.
+ */
+#ifndef __SIM_MSP432_H__
+#define __SIM_MSP432_H__
+
+#include <stdint.h>
+
+#endif
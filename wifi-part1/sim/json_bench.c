@@ -0,0 +1,134 @@
+/**
+ * Throughput of the weather extractor on the host.
+ *
+ * Usage: json_bench
+ *
+ * Writes a weather document of MAX_CITIES cities, members in inner objects
+ * as in {"name": "ROME", "main": {"temp": 17.3, "humidity": 63}}, and times
+ * WeatherJson_feed() over it whole, in pieces of a TCP segment and in pieces
+ * of 64 bytes, as sl_Recv() could hand them over. Prints the throughput of
+ * each, the size of the state the parsers keep and fails if a run does not
+ * find every city.
+ *
+ * Build from wifi-part1 with:
+ *
+ *   gcc -DWIFI_SIM -Isim/include -I. -Isimplelink/include -Iboard -Icli_uart
+ *       -Ispi_cc3100 -Iuart_cc3100 -Ihttp -O2 -o json_bench sim/json_bench.c
+ *       http/json_parser.c http/weather_json.c
+ */
+#ifdef WIFI_SIM
+
+#include <stdio.h>
+#include <time.h>
+#include "weather_json.h"
+
+/* Times each document is parsed per run. */
+#define BENCH_REPEAT        2000
+
+/* Largest document written. */
+#define BENCH_DOCUMENT_SIZE 65536
+
+static const char *const bench_conditions[] = {
+    "Partly cloudy", "Snowy", "Sunny", "Rainy"
+};
+
+static char Bench_document[BENCH_DOCUMENT_SIZE];
+static City_t Bench_cities[MAX_CITIES];
+
+static _u16 Bench_write(void)
+{
+    int length;
+    _u16 i;
+
+    length = sprintf(Bench_document, "{\"cod\":\"200\",\"cnt\":%d,\"list\":[",
+                     MAX_CITIES);
+    for (i = 0; i < MAX_CITIES; i++)
+    {
+        length += sprintf(Bench_document + length,
+                          "%s{\"name\":\"CITY %04d\","
+                          "\"coord\":{\"lat\":41.89,\"lon\":12.48},"
+                          "\"main\":{\"temp\":%d.%d7,\"pressure\":1012,"
+                          "\"humidity\":%d},"
+                          "\"weather\":\"%s\",\"wind\":{\"speed\":4.1}}",
+                          i ? "," : "", i, i % 40, i % 10, i % 101,
+                          bench_conditions[i % WEATHER_NUM]);
+    }
+    length += sprintf(Bench_document + length, "]}");
+    return length;
+}
+
+static double Bench_seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* Parses the document BENCH_REPEAT times in pieces of at most segment
+ * bytes, returns MB/s or 0 if a run missed cities. */
+static double Bench_run(_u16 length, _u16 segment)
+{
+    WeatherJson_t parser;
+    double start;
+    _u16 position, piece;
+    _i32 used;
+    int i;
+
+    start = Bench_seconds();
+    for (i = 0; i < BENCH_REPEAT; i++)
+    {
+        WeatherJson_init(&parser, Bench_cities, MAX_CITIES);
+        for (position = 0; position < length; position += piece)
+        {
+            piece = (length - position < segment) ? length - position :
+                                                    segment;
+            used = WeatherJson_feed(&parser,
+                                    (const _u8*)Bench_document + position,
+                                    piece);
+            if (used != piece)
+            {
+                return 0;
+            }
+        }
+        if ((WeatherJson_finish(&parser) < 0) ||
+            (WeatherJson_count(&parser) != MAX_CITIES))
+        {
+            return 0;
+        }
+    }
+
+    return (double)length * BENCH_REPEAT / (Bench_seconds() - start) / 1e6;
+}
+
+int main(void)
+{
+    static const _u16 segments[] = { BENCH_DOCUMENT_SIZE - 1, 1460, 64 };
+    static const char *const names[] = { "whole", "1460 byte pieces",
+                                         "64 byte pieces" };
+    _u16 length = Bench_write();
+    double throughput;
+    int failed = 0;
+    _u8 i;
+
+    printf("document of %u bytes, %d cities\n", length, MAX_CITIES);
+    for (i = 0; i < sizeof(segments) / sizeof(segments[0]); i++)
+    {
+        throughput = Bench_run(length, segments[i]);
+        if (throughput == 0)
+        {
+            printf("%s: FAILED, cities missing\n", names[i]);
+            failed = 1;
+            continue;
+        }
+        printf("%s: %.1f MB/s\n", names[i], throughput);
+    }
+
+    printf("state on the host: JsonParser_t %u bytes, "
+           "WeatherJson_t %u bytes\n", (unsigned)sizeof(JsonParser_t),
+           (unsigned)sizeof(WeatherJson_t));
+
+    return failed;
+}
+
+#endif
@@ -0,0 +1,460 @@
+/**
+ * Checks json_parser.c and weather_json.c on the host.
+ *
+ * Weather documents written in the shapes the extractor accepts are fed in
+ * random pieces, and every city must come out with its name, temperature,
+ * humidity and condition. Then valid documents are mutated, bytes replaced,
+ * removed or inserted, and random strings of JSON characters are made up.
+ * Whatever the input, the tokenizer must report the same elements, in the
+ * same order, and the same result, whether the input is fed whole or cut at
+ * random, and the extractor must fill the same cities without going past
+ * the array it was given. Nesting deeper than JSON_MAX_DEPTH is an error.
+ *
+ * Build and run from wifi-part1, with -fsanitize=address,undefined to have
+ * out of bounds accesses caught as well:
+ *
+ *   gcc -DWIFI_SIM -Isim/include -I. -Isimplelink/include -Iboard -Icli_uart
+ *       -Ispi_cc3100 -Iuart_cc3100 -Ihttp -o json_fuzz_test
+ *       sim/json_fuzz_test.c http/json_parser.c http/weather_json.c
+ *       && ./json_fuzz_test
+ */
+#ifdef WIFI_SIM
+
+#include <string.h>
+#include "sim_test.h"
+#include "weather_json.h"
+
+/* Documents tried on every shape, and mutations and made up strings. */
+#define TEST_SEEDS          200
+#define TEST_MUTATIONS      100000
+#define TEST_STRINGS        50000
+
+/* Cities of the documents fed in pieces. */
+#define TEST_CITIES         200
+
+/* Room for the cities written, a smaller array for the mutated documents
+ * and a guard city after it. */
+#define TEST_SMALL          8
+#define TEST_DOCUMENT_SIZE  40000
+
+/* Characters inserted by mutations and making up random strings. */
+static const char test_grammar[] = "{}[],:\"\\/0123456789-+.eEtrufalsn \n";
+
+static const char *const test_conditions[] = {
+    "Partly cloudy", "Snowy", "Sunny", "Rainy"
+};
+
+static char Test_document[TEST_DOCUMENT_SIZE];
+static char Test_base[2][TEST_DOCUMENT_SIZE];
+static City_t Test_cities[MAX_CITIES + 1];
+static City_t Test_whole[MAX_CITIES + 1];
+
+/* State of the random numbers, stdlib.h clashes with the FD_ macros of
+ * socket.h. */
+static _u32 Test_seed;
+
+/* Next number of a xorshift sequence, never 0. */
+static _u32 Test_random(void)
+{
+    Test_seed ^= (Test_seed << 13) & 0xFFFFFFFF;
+    Test_seed ^= Test_seed >> 17;
+    Test_seed ^= (Test_seed << 5) & 0xFFFFFFFF;
+    return Test_seed;
+}
+
+/* Random character out of test_grammar. */
+static char Test_grammar(void)
+{
+    return test_grammar[Test_random() % (sizeof(test_grammar) - 1)];
+}
+
+/* Values of city i of the documents. */
+static _i16 Test_temperature(_u16 i)
+{
+    return (i * 37) % 600 - 200;
+}
+
+static _u8 Test_humidity(_u16 i)
+{
+    return (i * 13) % 101;
+}
+
+/* Writes tenths as a decimal number, "-0.5" included. */
+static int Test_tenths(char *out, _i16 tenths)
+{
+    _i16 magnitude = (tenths < 0) ? -tenths : tenths;
+
+    return sprintf(out, "%s%d.%d", (tenths < 0) ? "-" : "", magnitude / 10,
+                   magnitude % 10);
+}
+
+/**
+ * Writes a document of count cities in one of three shapes:
+ *
+ * 0 -> top level array, numbers in strings, an extra member.
+ * 1 -> object with a "cities" member, "city" and "condition" keys.
+ * 2 -> members in an inner object, escapes, arrays and literals in between.
+ */
+static _u16 Test_write(_u8 shape, _u16 count)
+{
+    char temperature[16];
+    int length = 0;
+    _u16 i;
+
+    length += sprintf(Test_document, shape ? "{\"status\": \"ok\", "
+                                             "\"count\": %d, \"cities\": [" :
+                                             "[", count);
+    for (i = 0; i < count; i++)
+    {
+        Test_tenths(temperature, Test_temperature(i));
+        length += sprintf(Test_document + length, i ? ",\n" : "\n");
+        switch (shape)
+        {
+        case 0:
+            length += sprintf(Test_document + length,
+                              "  {\"name\": \"CITY A%04d\", "
+                              "\"temperature\": \"%s\", "
+                              "\"humidity\": \"%d\", \"weather\": \"%s\", "
+                              "\"extra\": false}",
+                              i, temperature, Test_humidity(i),
+                              test_conditions[i % WEATHER_NUM]);
+            break;
+        case 1:
+            length += sprintf(Test_document + length,
+                              "{\"City\":\"CITY A%04d\",\"Condition\":\"%s\","
+                              "\"humidity\":%d,\"temp\":%s}",
+                              i, test_conditions[i % WEATHER_NUM],
+                              Test_humidity(i), temperature);
+            break;
+        default:
+            length += sprintf(Test_document + length,
+                              "{\"name\":\"CITY \\u0041%04d\","
+                              "\"coord\":{\"lat\":41.9,\"lon\":-1.25e1},"
+                              "\"main\":{\"temp\":%s4,\"humidity\":%d.0},"
+                              "\"weather\":\"%s\","
+                              "\"tags\":[\"a\\\"\\n\",1,true,null,{}]}",
+                              i, temperature, Test_humidity(i),
+                              test_conditions[i % WEATHER_NUM]);
+            break;
+        }
+    }
+    length += sprintf(Test_document + length, shape ? "]}" : "]");
+    return length;
+}
+
+/* Feeds a document to the extractor in pieces of at most segment bytes,
+ * whole if 0. Returns the bytes used, or JSON_PARSER_ERROR. */
+static _i32 Test_extract(const char *document, _u16 length, _u16 segment,
+                         City_t *cities, _u16 max_cities, _u16 *count)
+{
+    WeatherJson_t parser;
+    _u16 position = 0;
+    _u16 piece;
+    _i32 used;
+
+    WeatherJson_init(&parser, cities, max_cities);
+    while (position < length)
+    {
+        piece = segment ? 1 + Test_random() % segment : length - position;
+        if (piece > length - position)
+        {
+            piece = length - position;
+        }
+        used = WeatherJson_feed(&parser, (const _u8*)document + position,
+                                piece);
+        SIM_TEST_CHECK(used <= piece);
+        if (used < 0)
+        {
+            *count = WeatherJson_count(&parser);
+            return JSON_PARSER_ERROR;
+        }
+        position += used;
+        if (used < piece)
+        {
+            break;
+        }
+    }
+
+    *count = WeatherJson_count(&parser);
+    if (WeatherJson_finish(&parser) < 0)
+    {
+        return JSON_PARSER_ERROR;
+    }
+    return position;
+}
+
+static void Test_shapes(void)
+{
+    char name[NAME_LENGTH];
+    unsigned seed;
+    _u16 length, count, i;
+    _u8 shape;
+
+    for (shape = 0; shape < 3; shape++)
+    {
+        length = Test_write(shape, TEST_CITIES);
+        for (seed = 1; seed <= TEST_SEEDS; seed++)
+        {
+            Test_seed = seed;
+            memset(Test_cities, 0, sizeof(Test_cities));
+            SIM_TEST_EQUAL(Test_extract(Test_document, length,
+                                        (seed & 1) ? 7 : 1460, Test_cities,
+                                        MAX_CITIES, &count), length);
+            SIM_TEST_EQUAL(count, TEST_CITIES);
+
+            for (i = 0; i < TEST_CITIES; i++)
+            {
+                sprintf(name, "CITY A%04d", i);
+                SIM_TEST_CHECK(strcmp(Test_cities[i].name, name) == 0);
+                SIM_TEST_EQUAL(Test_cities[i].temperature,
+                               Test_temperature(i));
+                SIM_TEST_EQUAL(Test_cities[i].humidity, Test_humidity(i));
+                SIM_TEST_EQUAL(Test_cities[i].weather, i % WEATHER_NUM);
+            }
+        }
+    }
+}
+
+static void Test_limits(void)
+{
+    static const char document[] =
+            "[{\"name\":\"A NAME LONGER THAN THE FIELD\",\"temp\":1e3,"
+            "\"humidity\":150,\"weather\":\"Clear sky\"},"
+            "{\"name\":\"COLD\",\"temp\":-99999,\"humidity\":-3,"
+            "\"weather\":\"hail\"},"
+            "{\"temp\":20,\"name\":\"LAST\",\"temp\":21.05}] trailing";
+    _u16 count;
+
+    memset(Test_cities, 0, sizeof(Test_cities));
+    Test_seed = 1;
+    SIM_TEST_EQUAL(Test_extract(document, sizeof(document) - 1, 0,
+                                Test_cities, MAX_CITIES, &count),
+                   sizeof(document) - 1 - 9);
+    SIM_TEST_EQUAL(count, 3);
+
+    /* Cut name, exponent not taken, humidity clamped, "clear" is sunny. */
+    SIM_TEST_CHECK(strcmp(Test_cities[0].name, "A NAME LONGER T") == 0);
+    SIM_TEST_EQUAL(Test_cities[0].temperature, 0);
+    SIM_TEST_EQUAL(Test_cities[0].humidity, 100);
+    SIM_TEST_EQUAL(Test_cities[0].weather, WEATHER_SUNNY);
+
+    /* Clamped, unknown condition left as is. */
+    SIM_TEST_EQUAL(Test_cities[1].temperature, -32767);
+    SIM_TEST_EQUAL(Test_cities[1].humidity, 0);
+    SIM_TEST_EQUAL(Test_cities[1].weather, WEATHER_PARTLY_CLOUDY);
+
+    /* The last value of a member wins, rounded to tenths. */
+    SIM_TEST_EQUAL(Test_cities[2].temperature, 211);
+
+    /* More cities than room, the rest are dropped. */
+    Test_write(0, TEST_SMALL + 5);
+    memset(Test_cities, 0x5A, sizeof(Test_cities));
+    SIM_TEST_CHECK(Test_extract(Test_document, strlen(Test_document), 3,
+                                Test_cities, TEST_SMALL, &count) > 0);
+    SIM_TEST_EQUAL(count, TEST_SMALL);
+    SIM_TEST_EQUAL(Test_cities[TEST_SMALL].temperature, 0x5A5A);
+}
+
+/* Digest of the elements reported by the tokenizer. */
+typedef struct
+{
+    _u32 hash;
+    _u32 events;
+} Test_Digest_t;
+
+static void Test_digest(JsonParser_t *parser, JsonEvent_t event,
+                        const char *text, _u8 length)
+{
+    Test_Digest_t *digest = parser->context;
+    _u8 i;
+
+    /* FNV-1a over the event, the depth and the text. */
+    digest->hash = ((digest->hash ^ event) * 16777619) & 0xFFFFFFFF;
+    digest->hash = ((digest->hash ^ parser->depth) * 16777619) & 0xFFFFFFFF;
+    for (i = 0; i < length; i++)
+    {
+        digest->hash = ((digest->hash ^ (_u8)text[i]) * 16777619) &
+                       0xFFFFFFFF;
+    }
+    SIM_TEST_EQUAL(text[length], '\0');
+    digest->events++;
+}
+
+/* Tokenizes a document in pieces of at most segment bytes, whole if 0. */
+static _i32 Test_tokenize(const char *document, _u16 length, _u16 segment,
+                          Test_Digest_t *digest)
+{
+    JsonParser_t parser;
+    _u16 position = 0;
+    _u16 piece;
+    _i32 used;
+
+    digest->hash = 2166136261u;
+    digest->events = 0;
+    JsonParser_init(&parser, Test_digest, digest);
+    while (position < length)
+    {
+        piece = segment ? 1 + Test_random() % segment : length - position;
+        if (piece > length - position)
+        {
+            piece = length - position;
+        }
+        used = JsonParser_feed(&parser, (const _u8*)document + position,
+                               piece);
+        SIM_TEST_CHECK(used <= piece);
+        if (used < 0)
+        {
+            SIM_TEST_CHECK(!JsonParser_isDone(&parser));
+            return JSON_PARSER_ERROR;
+        }
+        position += used;
+        if (used < piece)
+        {
+            SIM_TEST_CHECK(JsonParser_isDone(&parser));
+            break;
+        }
+    }
+
+    if (JsonParser_finish(&parser) < 0)
+    {
+        return JSON_PARSER_ERROR;
+    }
+    SIM_TEST_CHECK(JsonParser_isDone(&parser));
+    return position;
+}
+
+/**
+ * Parses a document whole and in pieces, with both parsers, and checks the
+ * outcomes are the same. Returns 1 if the document is valid.
+ */
+static _u8 Test_compare(const char *document, _u16 length)
+{
+    Test_Digest_t whole, cut;
+    _u16 wholeCount, cutCount;
+    _i32 result;
+    _u16 segment = 1 + Test_random() % 64;
+
+    result = Test_tokenize(document, length, 0, &whole);
+    SIM_TEST_EQUAL(Test_tokenize(document, length, segment, &cut), result);
+    SIM_TEST_EQUAL(cut.events, whole.events);
+    SIM_TEST_EQUAL(cut.hash, whole.hash);
+
+    memset(Test_whole, 0x5A, sizeof(Test_whole));
+    memset(Test_cities, 0x5A, sizeof(Test_cities));
+    SIM_TEST_EQUAL(Test_extract(document, length, 0, Test_whole, TEST_SMALL,
+                                &wholeCount), result);
+    SIM_TEST_EQUAL(Test_extract(document, length, segment, Test_cities,
+                                TEST_SMALL, &cutCount), result);
+    SIM_TEST_EQUAL(cutCount, wholeCount);
+    SIM_TEST_CHECK(wholeCount <= TEST_SMALL);
+    SIM_TEST_CHECK(memcmp(Test_cities, Test_whole,
+                          sizeof(City_t) * (TEST_SMALL + 1)) == 0);
+    SIM_TEST_EQUAL(Test_whole[TEST_SMALL].temperature, 0x5A5A);
+
+    return result >= 0;
+}
+
+static void Test_mutations(void)
+{
+    _u16 base[2], length, at;
+    _u32 valid = 0, i;
+    _u8 changes, j;
+
+    base[0] = Test_write(0, 3);
+    memcpy(Test_base[0], Test_document, base[0]);
+    base[1] = Test_write(2, 3);
+    memcpy(Test_base[1], Test_document, base[1]);
+
+    Test_seed = 7;
+    for (i = 0; i < TEST_MUTATIONS; i++)
+    {
+        /* Alternately from either shape. */
+        length = base[i & 1];
+        memcpy(Test_document, Test_base[i & 1], length);
+
+        for (changes = 1 + Test_random() % 4, j = 0; j < changes; j++)
+        {
+            at = Test_random() % length;
+            switch (Test_random() % 3)
+            {
+            case 0:
+                Test_document[at] = Test_random() & 0xFF;
+                break;
+            case 1:
+                memmove(Test_document + at, Test_document + at + 1,
+                        length - at - 1);
+                length--;
+                break;
+            default:
+                memmove(Test_document + at + 1, Test_document + at,
+                        length - at);
+                Test_document[at] = Test_grammar();
+                length++;
+                break;
+            }
+        }
+        valid += Test_compare(Test_document, length);
+    }
+
+    /* Some mutations leave a valid document, most do not. */
+    SIM_TEST_CHECK((valid > 0) && (valid < TEST_MUTATIONS / 2));
+}
+
+static void Test_strings(void)
+{
+    _u16 length, j;
+    _u32 i;
+
+    Test_seed = 11;
+    for (i = 0; i < TEST_STRINGS; i++)
+    {
+        length = 1 + Test_random() % 200;
+        for (j = 0; j < length; j++)
+        {
+            Test_document[j] = Test_grammar();
+        }
+        Test_compare(Test_document, length);
+    }
+}
+
+static void Test_depth(void)
+{
+    static const char deep[] =
+            "{\"a\":{\"b\":{\"c\":{\"d\":{\"name\":\"DEEP\"}}}},"
+            "\"name\":\"TOP\",\"main\":{\"temp\":5}}";
+    Test_Digest_t digest;
+    _u16 count;
+
+    /* As deep as allowed, then one more. */
+    memset(Test_document, '[', JSON_MAX_DEPTH + 1);
+    memset(Test_document + JSON_MAX_DEPTH + 1, ']', JSON_MAX_DEPTH + 1);
+    SIM_TEST_EQUAL(Test_tokenize(Test_document + 1, 2 * JSON_MAX_DEPTH, 0,
+                                 &digest), 2 * JSON_MAX_DEPTH);
+    SIM_TEST_EQUAL(digest.events, 2 * JSON_MAX_DEPTH);
+    SIM_TEST_EQUAL(Test_tokenize(Test_document, 2 * JSON_MAX_DEPTH + 2, 0,
+                                 &digest), JSON_PARSER_ERROR);
+    Test_compare(Test_document, 2 * JSON_MAX_DEPTH + 2);
+
+    /* Objects deeper than the extractor keeps records of are skipped, the
+     * enclosing city still gets the members of its inner object. */
+    memset(Test_cities, 0, sizeof(Test_cities));
+    SIM_TEST_EQUAL(Test_extract(deep, sizeof(deep) - 1, 0, Test_cities,
+                                MAX_CITIES, &count), sizeof(deep) - 1);
+    SIM_TEST_EQUAL(count, 1);
+    SIM_TEST_CHECK(strcmp(Test_cities[0].name, "TOP") == 0);
+    SIM_TEST_EQUAL(Test_cities[0].temperature, 50);
+    Test_compare(deep, sizeof(deep) - 1);
+}
+
+int main(void)
+{
+    Test_shapes();
+    Test_limits();
+    Test_mutations();
+    Test_strings();
+    Test_depth();
+
+    return Sim_Test_report("json_fuzz_test");
+}
+
+#endif
@@ -0,0 +1,366 @@
+/**
+ * Checks the timeouts of the non-os sync and locking objects, on the host.
+ *
+ * Includes simplelink/source/nonos.c and gives it a simulated clock in place
+ * of board.c: getTick() returns ms masked to 32 bits, as the MSP432 does,
+ * and waitForEvent() moves the clock by its timeout, or up to the host IRQ
+ * when one is due sooner. The IRQ spawns the entry that signals the object,
+ * as the handler of the CC3100 does. Checks that:
+ *
+ * - a wait times out on the exact ms of its timeout, never sleeping past it,
+ * - a signal before the deadline ends the wait when it comes, and one on or
+ *   after the deadline is left for the next wait,
+ * - NONOS_NO_WAIT checks the object once, neither running the main loop nor
+ *   sleeping, while NONOS_WAIT_FOREVER waits for the signal however late,
+ * - the deadlines hold while the clock wraps, with Start just below 2^32.
+ *
+ * Without _SlNonOsGetTime() each pass of the wait loop counts as one ms.
+ * Built with TEST_PASSES, the test drops the hook and checks the passes
+ * instead.
+ *
+ * Build and run from wifi-part1 with:
+ *
+ *   gcc -DWIFI_SIM -Isim/include -I. -Isimplelink/include -Isimplelink/source
+ *       -Iboard -Icli_uart -Ispi_cc3100 -Iuart_cc3100 -o nonos_test
+ *       sim/nonos_test.c && ./nonos_test
+ *
+ * and again with -DTEST_PASSES.
+ */
+#ifdef WIFI_SIM
+
+#include <setjmp.h>
+#include "sim_test.h"
+#include "simplelink.h"
+
+#ifdef TEST_PASSES
+#undef _SlNonOsGetTime
+#endif
+
+#include "nonos.c"
+
+/* NONOS_RET_ERR as the caller gets it, in a _SlNonOsRetVal_t. */
+#define TEST_ERR            ((_SlNonOsRetVal_t) NONOS_RET_ERR)
+
+/* Clock value of a host IRQ that never comes. */
+#define SIM_NEVER           (~0ULL)
+
+/* One past the largest value of getTick(). */
+#define SIM_WRAP            0x100000000ULL
+
+/* Calls of waitForEvent() past which a wait is taken as never ending. */
+#define SIM_WAITS_MAX       100000
+
+static _SlDriverCb_t Sim_driver;
+_SlDriverCb_t *g_pCB = &Sim_driver;
+
+/* Simulated time in ms, the next host IRQ and the end of the wait. */
+static unsigned long long Sim_now;
+static unsigned long long Sim_irqAt = SIM_NEVER;
+static unsigned long long Sim_deadline = SIM_NEVER;
+
+/* Calls of waitForEvent() and the longest sleep asked. */
+static unsigned long Sim_waits;
+static unsigned long Sim_longest;
+
+/* Where a wait that never ends goes back to. */
+static jmp_buf Sim_runaway;
+
+/* Object the host IRQ brings, and the value it gives it. */
+static _SlNonOsSemObj_t *Test_object;
+static _SlNonOsSemObj_t Test_value;
+
+unsigned long getTick()
+{
+    return (unsigned long) (Sim_now % SIM_WRAP);
+}
+
+static void Test_signal(void *pValue)
+{
+    (void) pValue;
+
+    *Test_object = Test_value;
+    g_pCB->RxDoneCnt++;
+}
+
+/* What the handler of the host IRQ does. */
+static void Sim_irq(void)
+{
+    g_pCB->RxIrqCnt++;
+    _SlNonOsSpawn(Test_signal, NULL, 0);
+}
+
+void waitForEvent(unsigned long timeout)
+{
+    Sim_waits++;
+    if (Sim_waits > SIM_WAITS_MAX)
+    {
+        SIM_TEST_CHECK(Sim_waits <= SIM_WAITS_MAX);
+        longjmp(Sim_runaway, 1);
+    }
+    if (timeout > Sim_longest)
+    {
+        Sim_longest = timeout;
+    }
+#ifndef TEST_PASSES
+    SIM_TEST_CHECK(Sim_now + timeout <= Sim_deadline);
+#endif
+
+    if (Sim_irqAt <= Sim_now + timeout)
+    {
+        if (Sim_irqAt > Sim_now)
+        {
+            Sim_now = Sim_irqAt;
+        }
+        Sim_irqAt = SIM_NEVER;
+        Sim_irq();
+        return;
+    }
+    Sim_now += timeout;
+}
+
+/* Waits at most timeout for the sync object, the host IRQ signalling it
+ * irqAfter ms from now unless negative. Gives the ms the wait took. */
+static _SlNonOsRetVal_t Test_syncWait(_SlNonOsSemObj_t *object,
+                                      _SlNonOsTime_t timeout, long irqAfter,
+                                      unsigned long long *elapsed)
+{
+    unsigned long long start = Sim_now;
+    _SlNonOsRetVal_t retVal;
+
+    Test_object = object;
+    Test_value = __NON_OS_SYNC_OBJ_SIGNAL_VALUE;
+    if (irqAfter >= 0)
+    {
+        Sim_irqAt = Sim_now + irqAfter;
+    }
+    Sim_deadline = (timeout == NONOS_WAIT_FOREVER) ? SIM_NEVER :
+                                                     Sim_now + timeout;
+    Sim_waits = 0;
+    Sim_longest = 0;
+
+    retVal = _SlNonOsSyncObjWait(object, timeout);
+
+    *elapsed = Sim_now - start;
+    Sim_deadline = SIM_NEVER;
+    return retVal;
+}
+
+#ifndef TEST_PASSES
+
+/* Times out after exactly timeout ms, started at start. */
+static void Test_expiry(unsigned long long start, _SlNonOsTime_t timeout)
+{
+    _SlNonOsSemObj_t object = __NON_OS_SYNC_OBJ_CLEAR_VALUE;
+    unsigned long long elapsed;
+
+    Sim_now = start;
+    SIM_TEST_EQUAL(Test_syncWait(&object, timeout, -1, &elapsed),
+                   TEST_ERR);
+    SIM_TEST_EQUAL(elapsed, timeout);
+    SIM_TEST_EQUAL(object, __NON_OS_SYNC_OBJ_CLEAR_VALUE);
+    SIM_TEST_CHECK(Sim_longest <= EVENT_WAIT_MS);
+}
+
+/* Gets the signal irqAfter ms after start, within timeout. */
+static void Test_signalled(unsigned long long start, _SlNonOsTime_t timeout,
+                           long irqAfter)
+{
+    _SlNonOsSemObj_t object = __NON_OS_SYNC_OBJ_CLEAR_VALUE;
+    unsigned long long elapsed;
+
+    Sim_now = start;
+    SIM_TEST_EQUAL(Test_syncWait(&object, timeout, irqAfter, &elapsed),
+                   NONOS_RET_OK);
+    SIM_TEST_EQUAL(elapsed, irqAfter);
+    SIM_TEST_EQUAL(object, __NON_OS_SYNC_OBJ_CLEAR_VALUE);
+}
+
+static void Test_deadlines(void)
+{
+    static const _SlNonOsTime_t timeouts[] = {
+        1, 9, 10, 11, 35, 255, 256, 300, 1000, 60000
+    };
+    _SlNonOsSemObj_t object = __NON_OS_SYNC_OBJ_CLEAR_VALUE;
+    unsigned long long elapsed;
+    _u8 i;
+
+    for (i = 0; i < sizeof(timeouts) / sizeof(timeouts[0]); i++)
+    {
+        Test_expiry(5000, timeouts[i]);
+    }
+
+    /*
+     * A signal ends the wait when it comes, also in its last ms.
+     */
+    Test_signalled(5000, 300, 0);
+    Test_signalled(5000, 300, 1);
+    Test_signalled(5000, 300, 120);
+    Test_signalled(5000, 300, 299);
+
+    /*
+     * One on or after the deadline is kept for the next wait.
+     */
+    Sim_now = 5000;
+    SIM_TEST_EQUAL(Test_syncWait(&object, 300, 300, &elapsed), TEST_ERR);
+    SIM_TEST_EQUAL(elapsed, 300);
+    SIM_TEST_EQUAL(Test_syncWait(&object, NONOS_NO_WAIT, -1, &elapsed),
+                   TEST_ERR);
+    SIM_TEST_EQUAL(Test_syncWait(&object, 1, -1, &elapsed), NONOS_RET_OK);
+    SIM_TEST_EQUAL(elapsed, 0);
+
+    SIM_TEST_EQUAL(Test_syncWait(&object, 300, 400, &elapsed),
+                   TEST_ERR);
+    SIM_TEST_EQUAL(elapsed, 300);
+    SIM_TEST_EQUAL(Test_syncWait(&object, NONOS_WAIT_FOREVER, -1, &elapsed),
+                   NONOS_RET_OK);
+    SIM_TEST_EQUAL(elapsed, 100);
+    SIM_TEST_EQUAL(object, __NON_OS_SYNC_OBJ_CLEAR_VALUE);
+
+    /*
+     * Forever is not a timeout of 0xFFFFFFFF ms, which would be past the
+     * simulated deadline, and sleeps EVENT_WAIT_MS at most.
+     */
+    Test_signalled(5000, NONOS_WAIT_FOREVER, 2500);
+    SIM_TEST_EQUAL(Sim_longest, EVENT_WAIT_MS);
+}
+
+static void Test_wrap(void)
+{
+    unsigned long long start;
+
+    for (start = SIM_WRAP - 40; start < SIM_WRAP; start += 3)
+    {
+        Test_expiry(start, 35);
+        Test_expiry(start, 60000);
+        Test_signalled(start, 300, 50);
+    }
+
+    /*
+     * The clock goes back to 0 during the wait.
+     */
+    Test_expiry(SIM_WRAP - 1, 35);
+    SIM_TEST_EQUAL(getTick(), 34);
+    Test_signalled(SIM_WRAP - 1, 300, 10);
+    SIM_TEST_EQUAL(getTick(), 9);
+}
+
+#else
+
+/* Times out after exactly timeout passes of the loop. */
+static void Test_passes(void)
+{
+    static const _SlNonOsTime_t timeouts[] = { 1, 35, 255, 300 };
+    _SlNonOsSemObj_t object = __NON_OS_SYNC_OBJ_CLEAR_VALUE;
+    unsigned long long elapsed;
+    _u8 i;
+
+    for (i = 0; i < sizeof(timeouts) / sizeof(timeouts[0]); i++)
+    {
+        Sim_now = SIM_WRAP - 1;
+        SIM_TEST_EQUAL(Test_syncWait(&object, timeouts[i], -1, &elapsed),
+                       TEST_ERR);
+        SIM_TEST_EQUAL(Sim_waits, timeouts[i]);
+    }
+
+    Sim_now = 5000;
+    SIM_TEST_EQUAL(Test_syncWait(&object, 300, 120, &elapsed), NONOS_RET_OK);
+    SIM_TEST_EQUAL(elapsed, 120);
+    SIM_TEST_EQUAL(Test_syncWait(&object, NONOS_WAIT_FOREVER, 2500,
+                                 &elapsed), NONOS_RET_OK);
+    SIM_TEST_EQUAL(elapsed, 2500);
+}
+
+#endif
+
+static void Test_noWait(void)
+{
+    _SlNonOsSemObj_t object = __NON_OS_SYNC_OBJ_SIGNAL_VALUE;
+    unsigned long long elapsed;
+
+    Sim_now = 5000;
+    SIM_TEST_EQUAL(Test_syncWait(&object, NONOS_NO_WAIT, -1, &elapsed),
+                   NONOS_RET_OK);
+    SIM_TEST_EQUAL(object, __NON_OS_SYNC_OBJ_CLEAR_VALUE);
+    SIM_TEST_EQUAL(elapsed, 0);
+    SIM_TEST_EQUAL(Sim_waits, 0);
+
+    /*
+     * The entry spawned by an IRQ is not run, the next wait runs it.
+     */
+    Test_object = &object;
+    Test_value = __NON_OS_SYNC_OBJ_SIGNAL_VALUE;
+    Sim_irq();
+    SIM_TEST_EQUAL(Test_syncWait(&object, NONOS_NO_WAIT, -1, &elapsed),
+                   TEST_ERR);
+    SIM_TEST_EQUAL(object, __NON_OS_SYNC_OBJ_CLEAR_VALUE);
+    SIM_TEST_EQUAL(elapsed, 0);
+    SIM_TEST_EQUAL(Sim_waits, 0);
+
+    SIM_TEST_EQUAL(Test_syncWait(&object, 1, -1, &elapsed), NONOS_RET_OK);
+    SIM_TEST_EQUAL(elapsed, 0);
+    SIM_TEST_EQUAL(Sim_waits, 0);
+}
+
+static void Test_lock(void)
+{
+    _SlNonOsSemObj_t lock;
+    unsigned long long start;
+
+    Sim_now = 5000;
+    Sim_waits = 0;
+
+    _SlNonOsLockObjCreate(&lock);
+    SIM_TEST_EQUAL(_SlNonOsLockObjLock(&lock, NONOS_WAIT_FOREVER),
+                   NONOS_RET_OK);
+    SIM_TEST_EQUAL(lock, __NON_OS_LOCK_OBJ_LOCK_VALUE);
+
+    /*
+     * Held, a try-lock fails at once and a timed lock on its deadline.
+     */
+    SIM_TEST_EQUAL(_SlNonOsLockObjLock(&lock, NONOS_NO_WAIT), TEST_ERR);
+    SIM_TEST_EQUAL(Sim_waits, 0);
+    SIM_TEST_EQUAL(_SlNonOsLockObjLock(&lock, 40), TEST_ERR);
+#ifndef TEST_PASSES
+    SIM_TEST_EQUAL(Sim_now, 5040);
+#endif
+
+    /*
+     * Released by the host IRQ while waiting.
+     */
+    Test_object = &lock;
+    Test_value = __NON_OS_LOCK_OBJ_UNLOCK_VALUE;
+    start = Sim_now;
+    Sim_irqAt = start + 25;
+    SIM_TEST_EQUAL(_SlNonOsLockObjLock(&lock, 1000), NONOS_RET_OK);
+    SIM_TEST_EQUAL(lock, __NON_OS_LOCK_OBJ_LOCK_VALUE);
+    SIM_TEST_EQUAL(Sim_now - start, 25);
+
+    _SlNonOsLockObjUnlock(&lock);
+    SIM_TEST_EQUAL(_SlNonOsLockObjLock(&lock, NONOS_NO_WAIT), NONOS_RET_OK);
+}
+
+/* Runs test, or gives it up when one of its waits never ends. */
+static void Test_group(void (*test)(void))
+{
+    Sim_irqAt = SIM_NEVER;
+    if (setjmp(Sim_runaway) == 0)
+    {
+        test();
+    }
+}
+
+int main(void)
+{
+#ifndef TEST_PASSES
+    Test_group(Test_deadlines);
+    Test_group(Test_wrap);
+#else
+    Test_group(Test_passes);
+#endif
+    Test_group(Test_noWait);
+    Test_group(Test_lock);
+
+    return Sim_Test_report("nonos_test");
+}
+
+#endif
@@ -0,0 +1,244 @@
+/**
+ * Host stand-in for the socket calls of the SimpleLink host driver.
+ *
+ * Implements what http_fetch.c uses of socket.h, sl_Socket() to sl_Select()
+ * and the SL_FD_ helpers, over the POSIX sockets of the host, plus getTick()
+ * of board.c from the monotonic clock. Only TCP over IPv4 and the
+ * SL_SO_NONBLOCKING option are supported; errors come back as the SL_ codes
+ * http_fetch.c looks for, SL_EAGAIN and SL_EALREADY, or SL_SOC_ERROR.
+ *
+ * simplelink.h cannot be included here, its BSD names (select, timeval,
+ * FD_SET...) clash with the system headers. The structures of socket.h are
+ * mirrored instead, with _u32 being unsigned long as in simplelink.h.
+ *
+ * Only used by the host tests in sim/, linked in their gcc line.
+ */
+#ifdef WIFI_SIM
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+
+/* Values of socket.h */
+#define SIM_SO_NONBLOCKING  24
+#define SIM_EAGAIN          (-11)
+#define SIM_EALREADY        (-114)
+#define SIM_SOC_ERROR       (-1)
+#define SIM_FD_SETSIZE      8
+
+/* SlSockAddrIn_t */
+typedef struct
+{
+    unsigned short sin_family;
+    unsigned short sin_port;
+    unsigned long s_addr;
+    signed char sin_zero[8];
+} Sim_SockAddrIn_t;
+
+/* SlFdSet_t */
+typedef struct
+{
+    unsigned long fd_array[(SIM_FD_SETSIZE + 31) / 32];
+} Sim_FdSet_t;
+
+/* SlTimeval_t */
+typedef struct
+{
+    unsigned long tv_sec;
+    unsigned long tv_usec;
+} Sim_Timeval_t;
+
+short sl_Socket(short Domain, short Type, short Protocol)
+{
+    (void)Domain;
+    (void)Type;
+    (void)Protocol;
+
+    return socket(AF_INET, SOCK_STREAM, 0);
+}
+
+short sl_SetSockOpt(short sd, short level, short optname, const void *optval,
+                    unsigned short optlen)
+{
+    int flags;
+
+    (void)level;
+
+    if ((optname != SIM_SO_NONBLOCKING) || (optlen != sizeof(unsigned long)))
+    {
+        return SIM_SOC_ERROR;
+    }
+
+    flags = fcntl(sd, F_GETFL);
+    if (*(const unsigned long*)optval)
+    {
+        flags |= O_NONBLOCK;
+    }
+    else
+    {
+        flags &= ~O_NONBLOCK;
+    }
+    return (fcntl(sd, F_SETFL, flags) < 0) ? SIM_SOC_ERROR : 0;
+}
+
+/* As on the CC3100, a non-blocking connect returns SL_EALREADY until it is
+ * made, asking again then returns 0. */
+short sl_Connect(short sd, const void *addr, short addrlen)
+{
+    const Sim_SockAddrIn_t *in = addr;
+    struct sockaddr_in address;
+
+    (void)addrlen;
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = in->sin_port;
+    address.sin_addr.s_addr = (in_addr_t)in->s_addr;
+
+    if (connect(sd, (struct sockaddr*)&address, sizeof(address)) == 0)
+    {
+        return 0;
+    }
+    if ((errno == EINPROGRESS) || (errno == EALREADY))
+    {
+        return SIM_EALREADY;
+    }
+    if (errno == EISCONN)
+    {
+        return 0;
+    }
+    return SIM_SOC_ERROR;
+}
+
+short sl_Send(short sd, const void *buf, short Len, short flags)
+{
+    ssize_t sent;
+
+    (void)flags;
+
+    sent = send(sd, buf, Len, MSG_NOSIGNAL);
+    if (sent < 0)
+    {
+        return (errno == EAGAIN) ? SIM_EAGAIN : SIM_SOC_ERROR;
+    }
+    return sent;
+}
+
+short sl_Recv(short sd, void *buf, short Len, short flags)
+{
+    ssize_t received;
+
+    (void)flags;
+
+    received = recv(sd, buf, Len, 0);
+    if (received < 0)
+    {
+        return (errno == EAGAIN) ? SIM_EAGAIN : SIM_SOC_ERROR;
+    }
+    return received;
+}
+
+short sl_Close(short sd)
+{
+    return close(sd);
+}
+
+/* The host descriptors must fit the SL_FD_SETSIZE bits of SlFdSet_t, which
+ * a test opening a few sockets at a time keeps them in. */
+void SL_FD_SET(short fd, Sim_FdSet_t *fdset)
+{
+    fdset->fd_array[fd / 32] |= 1UL << (fd % 32);
+}
+
+void SL_FD_CLR(short fd, Sim_FdSet_t *fdset)
+{
+    fdset->fd_array[fd / 32] &= ~(1UL << (fd % 32));
+}
+
+short SL_FD_ISSET(short fd, Sim_FdSet_t *fdset)
+{
+    return (fdset->fd_array[fd / 32] >> (fd % 32)) & 1;
+}
+
+void SL_FD_ZERO(Sim_FdSet_t *fdset)
+{
+    memset(fdset, 0, sizeof(*fdset));
+}
+
+short sl_Select(short nfds, Sim_FdSet_t *readsds, Sim_FdSet_t *writesds,
+                Sim_FdSet_t *exceptsds, Sim_Timeval_t *timeout)
+{
+    struct timeval wait;
+    fd_set readable;
+    fd_set writable;
+    int ready;
+    short fd;
+
+    (void)exceptsds;
+
+    if (nfds > SIM_FD_SETSIZE)
+    {
+        return SIM_SOC_ERROR;
+    }
+
+    FD_ZERO(&readable);
+    FD_ZERO(&writable);
+    for (fd = 0; fd < nfds; fd++)
+    {
+        if (readsds && SL_FD_ISSET(fd, readsds))
+        {
+            FD_SET(fd, &readable);
+        }
+        if (writesds && SL_FD_ISSET(fd, writesds))
+        {
+            FD_SET(fd, &writable);
+        }
+    }
+
+    wait.tv_sec = timeout->tv_sec;
+    wait.tv_usec = timeout->tv_usec;
+    ready = select(nfds, &readable, &writable, NULL, &wait);
+    if (ready < 0)
+    {
+        return SIM_SOC_ERROR;
+    }
+
+    for (fd = 0; fd < nfds; fd++)
+    {
+        if (readsds && !FD_ISSET(fd, &readable))
+        {
+            SL_FD_CLR(fd, readsds);
+        }
+        if (writesds && !FD_ISSET(fd, &writable))
+        {
+            SL_FD_CLR(fd, writesds);
+        }
+    }
+    return ready;
+}
+
+unsigned long sl_Htonl(unsigned long val)
+{
+    return htonl((uint32_t)val);
+}
+
+unsigned short sl_Htons(unsigned short val)
+{
+    return htons(val);
+}
+
+unsigned long getTick(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+#endif
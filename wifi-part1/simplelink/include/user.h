@@ -954,6 +954,33 @@ typedef P_EVENT_HANDLER                         SL_P_EVENT_HANDLER;
 #define sl_Spawn(pEntry,pValue,flags)               
 #endif
 
+/*!
+	\brief 	Sleeps while the non-os driver waits for a sync or locking object
+
+	Called by _SlNonOsSemGet() after running the spawned entries, when the
+	object is still not there. It must return once the host IRQ comes, as its
+	handler spawns the entry that brings the object, and within Remaining ms.
+
+    \note       belongs to \ref porting_sec
+	\warning    Leave undefined to spin instead
+*/
+#ifndef SL_PLATFORM_MULTI_THREADED
+#define _SlNonOsWaitForEvent(Remaining)             waitForEvent(((Remaining) < EVENT_WAIT_MS) ? \
+                                                                 (Remaining) : EVENT_WAIT_MS)
+#endif
+
+/*!
+	\brief 	Clock of the timeouts of the non-os sync and locking objects
+
+	\return	time in ms, may wrap
+
+    \note       belongs to \ref porting_sec
+	\warning    Leave undefined to count the passes of the wait loop instead
+*/
+#ifndef SL_PLATFORM_MULTI_THREADED
+#define _SlNonOsGetTime()                           ((_u32) getTick())
+#endif
+
 /*!
 
  Close the Doxygen group.
@@ -69,18 +69,39 @@ _SlNonOsRetVal_t _SlNonOsSemSet(_SlNonOsSemObj_t* pSemObj , _SlNonOsSemObj_t Val
     return NONOS_RET_OK;
 }
 
+#ifdef _SlNonOsGetTime
+#define _SlNonOsNow(Passes)     _SlNonOsGetTime()
+#else
+#define _SlNonOsNow(Passes)     (Passes)
+#endif
+
+/* The clock wraps at 32 bits, as getTick() does on the MSP432, also where */
+/* _u32 is wider */
+#define _SlNonOsElapsed(Now, Start)     (((Now) - (Start)) & 0xFFFFFFFF)
+
 _SlNonOsRetVal_t _SlNonOsSemGet(_SlNonOsSemObj_t* pSyncObj, _SlNonOsSemObj_t WaitValue, _SlNonOsSemObj_t SetValue, _SlNonOsTime_t Timeout)
 {
-    while (Timeout>0)
+    _SlNonOsTime_t Passes = 0;
+    _SlNonOsTime_t Start = _SlNonOsNow(Passes);
+    _SlNonOsTime_t Elapsed;
+    _SlNonOsTime_t Remaining = NONOS_WAIT_FOREVER;
+
+    for (;;)
     {
         if (WaitValue == *pSyncObj)
         {
             *pSyncObj = SetValue;
-            break;
+            return NONOS_RET_OK;
         }
+        /* The deadline is compared by difference, so the clock may wrap */
         if (Timeout != NONOS_WAIT_FOREVER)
-        {		
-            Timeout--;
+        {
+            Elapsed = _SlNonOsElapsed(_SlNonOsNow(Passes), Start);
+            if (Elapsed >= Timeout)
+            {
+                return NONOS_RET_ERR;
+            }
+            Remaining = Timeout - Elapsed;
         }
         _SlNonOsMainLoopTask();
 #ifdef _SlSyncWaitLoopCallback
@@ -89,20 +110,18 @@ _SlNonOsRetVal_t _SlNonOsSemGet(_SlNonOsSemObj_t* pSyncObj, _SlNonOsSemObj_t Wai
             if (WaitValue == *pSyncObj)
             {
                 *pSyncObj = SetValue;
-                break;
+                return NONOS_RET_OK;
             }
             _SlSyncWaitLoopCallback();
         }
 #endif
-    }
-
-    if (0 == Timeout)
-    {
-        return NONOS_RET_ERR;
-    }
-    else
-    {
-        return NONOS_RET_OK;
+#ifdef _SlNonOsWaitForEvent
+        if (WaitValue != *pSyncObj)
+        {
+            _SlNonOsWaitForEvent(Remaining);
+        }
+#endif
+        Passes++;
     }
 }
 
@@ -52,10 +52,17 @@ extern "C" {
 #define _SlSyncWaitLoopCallback  UserSleepFunction
 */
 
+/* The timeouts of the sync and locking objects are in ms of the clock read by */
+/* _SlNonOsGetTime(), defined in user.h. Without it each pass of the wait loop */
+/* counts as one ms */
+/*
+#define _SlNonOsGetTime()  UserGetTimeMs()
+*/
+
 
 
-#define NONOS_WAIT_FOREVER   							0xFF
-#define NONOS_NO_WAIT        							0x01
+#define NONOS_WAIT_FOREVER   							0xFFFFFFFF
+#define NONOS_NO_WAIT        							0x00
 
 #define NONOS_RET_OK                            (0)
 #define NONOS_RET_ERR                           (0xFF)
@@ -72,9 +79,9 @@ extern "C" {
 typedef _i8 _SlNonOsRetVal_t;
 
 /*!
-	\brief type definition for a time value
+	\brief type definition for a time value, in ms
 */
-typedef _u8 _SlNonOsTime_t;
+typedef _u32 _SlNonOsTime_t;
 
 /*!
 	\brief 	type definition for a sync object container
@@ -151,9 +158,8 @@ typedef _u8 _SlNonOsSemObj_t;
 	\param	pSyncObj	-	pointer to the sync object control block
 	\param	Timeout		-	numeric value specifies the maximum number of mSec to 
 							stay suspended while waiting for the sync signal
-							Currently, the simple link driver uses only two values:
-								- NONOS_WAIT_FOREVER
-								- NONOS_NO_WAIT
+							NONOS_NO_WAIT checks the object once, NONOS_WAIT_FOREVER
+							never times out
 	
 	\return upon successful reception of the signal within the timeout window return 0
 			Otherwise, a negative value indicating the error code shall be returned
@@ -210,9 +216,8 @@ typedef _u8 _SlNonOsSemObj_t;
 	\param	pLockObj	-	pointer to the locking object control block
 	\param	Timeout		-	numeric value specifies the maximum number of mSec to 
 							stay suspended while waiting for the locking object
-							Currently, the simple link driver uses only two values:
-								- NONOS_WAIT_FOREVER
-								- NONOS_NO_WAIT
+							NONOS_NO_WAIT checks the object once, NONOS_WAIT_FOREVER
+							never times out
 	
 	
 	\return upon successful reception of the locking object the function should return 0